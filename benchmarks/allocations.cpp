@@ -0,0 +1,85 @@
+#include "allocations.hpp"
+#include <new>
+#include <cstdlib>
+
+#if ICE_BENCHMARKS_ALLOCATIONS
+
+namespace {
+
+thread_local std::size_t allocations_count = 0;
+
+void* allocate(std::size_t size) noexcept
+{
+  allocations_count++;
+  return std::malloc(size ? size : 1);
+}
+
+}  // namespace
+
+void* operator new(std::size_t size)
+{
+  if (const auto p = allocate(size)) {
+    return p;
+  }
+  std::abort();
+}
+
+void* operator new[](std::size_t size)
+{
+  if (const auto p = allocate(size)) {
+    return p;
+  }
+  std::abort();
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+  return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+  return allocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+namespace benchmarks {
+
+std::size_t allocations() noexcept
+{
+  return allocations_count;
+}
+
+}  // namespace benchmarks
+
+#else
+
+namespace benchmarks {
+
+std::size_t allocations() noexcept
+{
+  return 0;
+}
+
+}  // namespace benchmarks
+
+#endif
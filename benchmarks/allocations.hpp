@@ -0,0 +1,15 @@
+#pragma once
+#include <cstddef>
+
+// Replaces the global operator new to count heap allocations when enabled with the ICE_BENCHMARKS_ALLOCATIONS
+// CMake option. The replacement affects every benchmark in the executable, so it is disabled by default.
+#ifndef ICE_BENCHMARKS_ALLOCATIONS
+#  define ICE_BENCHMARKS_ALLOCATIONS 0
+#endif
+
+namespace benchmarks {
+
+// Returns the number of heap allocations made by the current thread or zero if allocations are not counted.
+std::size_t allocations() noexcept;
+
+}  // namespace benchmarks
@@ -0,0 +1,86 @@
+#include "symbols.hpp"
+#include <ice/async_result.hpp>
+#include <benchmark/benchmark.h>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+// Round trip from a coroutine on the benchmark thread to a worker thread that sets the result.
+// The coroutine posts the promise to a context that runs on the worker thread and awaits the result, which resumes
+// it on the context of the benchmark thread.
+
+namespace {
+
+ice::task async_result_loop(benchmark::State& state, ice::context& context, ice::context& worker) noexcept
+{
+  co_await context;
+  for (const auto _ : state) {
+    ice::async_result<int> result{ context };
+    worker.post([promise = result.promise()]() mutable {
+      promise.set(native(1));
+    });
+    const auto value = co_await result;
+    benchmark::DoNotOptimize(value.value());
+  }
+}
+
+}  // namespace
+
+static void async_result_handoff(benchmark::State& state)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  ice::context context;
+  ice::context worker;
+  std::optional<ice::context::work> work{ worker };
+  std::thread thread{ [&]() {
+    ICE_BENCHMARKS_ASSERT(!worker.run());
+  } };
+  async_result_loop(state, context, worker);
+  ICE_BENCHMARKS_ASSERT(!context.run());
+  work.reset();
+  thread.join();
+}
+BENCHMARK(async_result_handoff)->Unit(benchmark::kNanosecond)->UseRealTime();
+
+// Same round trip with a mutex and a condition variable for each direction.
+static void async_result_mutex(benchmark::State& state)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool stop = false;
+  bool request = false;
+  std::optional<ice::result<int>> response;
+  std::thread thread{ [&]() {
+    std::unique_lock lock{ mutex };
+    while (true) {
+      cv.wait(lock, [&]() {
+        return request || stop;
+      });
+      if (stop) {
+        break;
+      }
+      request = false;
+      response.emplace(native(1));
+      cv.notify_all();
+    }
+  } };
+  for (const auto _ : state) {
+    std::unique_lock lock{ mutex };
+    request = true;
+    cv.notify_all();
+    cv.wait(lock, [&]() {
+      return response.has_value();
+    });
+    benchmark::DoNotOptimize(response->value());
+    response.reset();
+  }
+  {
+    std::lock_guard lock{ mutex };
+    stop = true;
+  }
+  cv.notify_all();
+  thread.join();
+}
+BENCHMARK(async_result_mutex)->Unit(benchmark::kNanosecond)->UseRealTime();
@@ -1,4 +1,7 @@
+#include "allocations.hpp"
 #include "symbols.hpp"
+#include <ice/application.hpp>
+#include <ice/error_telemetry.hpp>
 #include <benchmark/benchmark.h>
 #include <cstdlib>
 
@@ -37,3 +40,79 @@ static void error_external(benchmark::State& state, int success)
 }
 BENCHMARK_CAPTURE(error_external, success, 1)->Unit(benchmark::kNanosecond);
 BENCHMARK_CAPTURE(error_external, failure, 0)->Unit(benchmark::kNanosecond);
+
+enum class error_output {
+  name,
+  string,
+  buffer,
+};
+
+// Formats errors from several threads. Every formatted error looks up the registered name or text of its type.
+// The buffer variant formats into a reused buffer, like a logger would, and must not allocate.
+static void error_format(benchmark::State& state, error_output output)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  if (state.thread_index() == 0) {
+    ice::application::load();
+  }
+  const ice::error e{ std::errc::invalid_argument };
+  fmt::memory_buffer buffer;
+  fmt::format_to(buffer, "{}", e);
+  const auto allocations = benchmarks::allocations();
+  for (const auto _ : state) {
+    switch (output) {
+    case error_output::name:
+      benchmark::DoNotOptimize(ice::error_info::get(e.type()));
+      break;
+    case error_output::string:
+      benchmark::DoNotOptimize(fmt::format("{}", e));
+      break;
+    case error_output::buffer:
+      buffer.clear();
+      fmt::format_to(buffer, "{}", e);
+      benchmark::DoNotOptimize(buffer.data());
+      break;
+    }
+  }
+  if (ICE_BENCHMARKS_ALLOCATIONS) {
+    state.counters["allocs"] = benchmark::Counter(static_cast<double>(benchmarks::allocations() - allocations),
+      benchmark::Counter::kAvgIterations);
+  }
+}
+BENCHMARK_CAPTURE(error_format, name, error_output::name)
+  ->ThreadRange(1, 8)->UseRealTime()->Unit(benchmark::kNanosecond);
+BENCHMARK_CAPTURE(error_format, string, error_output::string)
+  ->ThreadRange(1, 8)->UseRealTime()->Unit(benchmark::kNanosecond);
+BENCHMARK_CAPTURE(error_format, buffer, error_output::buffer)
+  ->ThreadRange(1, 8)->UseRealTime()->Unit(benchmark::kNanosecond);
+
+// Looks up the text of an ice::errc code through the registry or directly in the compile-time category.
+static void error_text(benchmark::State& state, bool category)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  const auto type = ice::make_error_type<ice::errc>();
+  auto code = static_cast<int>(ice::errc::not_available);
+  benchmark::DoNotOptimize(code);
+  for (const auto _ : state) {
+    if (category) {
+      benchmark::DoNotOptimize(ice::detail::error_category<ice::errc>.text(code));
+    } else {
+      benchmark::DoNotOptimize(ice::error_info::message(type, code));
+    }
+  }
+}
+BENCHMARK_CAPTURE(error_text, registry, false)->Unit(benchmark::kNanosecond);
+BENCHMARK_CAPTURE(error_text, category, true)->Unit(benchmark::kNanosecond);
+
+// Counts errors of a few types and codes in the table of each thread, which is the cost that ICE_ERROR_TELEMETRY
+// adds to errors that are created from error codes.
+static void error_telemetry(benchmark::State& state)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  const auto type = ice::make_error_type<std::errc>();
+  int code = 0;
+  for (const auto _ : state) {
+    ice::detail::error_count(type, 1 + (code++ & 7));
+  }
+}
+BENCHMARK(error_telemetry)->Unit(benchmark::kNanosecond)->ThreadRange(1, 8);
@@ -0,0 +1,214 @@
+#include "symbols.hpp"
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+#include <cstdint>
+
+#if __has_include(<expected>)
+#  include <expected>
+#endif
+
+// Compares error handling strategies when only some calls fail.
+// Each benchmark calls a chain of non-inlined functions with a value of the given payload size. The innermost function
+// fails for the given number of calls per million and every other function propagates the error or adds to the value.
+// Results can be written as JSON with --benchmark_out=failure.json --benchmark_out_format=json and are reported with
+// the failure rate, call depth and payload size as counters.
+
+namespace {
+
+template <std::size_t N>
+using payload = std::array<char, N>;
+
+// Pattern of successful (1) and failed (0) calls with the given number of failures per million calls.
+std::vector<int> failure_pattern(std::int64_t ppm)
+{
+  std::vector<int> pattern(std::size_t(1) << 16, 1);
+  const auto failures = static_cast<std::size_t>((static_cast<std::int64_t>(pattern.size()) * ppm + 500000) / 1000000);
+  std::fill_n(pattern.begin(), failures, 0);
+  std::shuffle(pattern.begin(), pattern.end(), std::mt19937{ 0 });
+  return pattern;
+}
+
+template <std::size_t N>
+payload<N> make_payload(int depth) noexcept
+{
+  payload<N> value;
+  value.fill(static_cast<char>(depth));
+  return value;
+}
+
+// Runs the benchmark with the arguments failure_ppm and depth and calls the function with the depth and the success
+// flag of the current iteration. The function returns true on success.
+template <std::size_t N, typename Function>
+void failure_run(benchmark::State& state, Function&& function)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  const auto pattern = failure_pattern(state.range(0));
+  const auto depth = static_cast<int>(state.range(1));
+  std::size_t index = 0;
+  std::int64_t failures = 0;
+  for (const auto _ : state) {
+    if (!function(depth, pattern[index++ & (pattern.size() - 1)])) {
+      failures++;
+    }
+  }
+  state.counters["failure_rate"] = static_cast<double>(state.range(0)) / 1000000.0;
+  state.counters["failures"] = benchmark::Counter(static_cast<double>(failures), benchmark::Counter::kAvgIterations);
+  state.counters["depth"] = depth;
+  state.counters["payload"] = N;
+}
+
+void failure_arguments(benchmark::internal::Benchmark* benchmark)
+{
+  benchmark->ArgNames({ "failure_ppm", "depth" });
+  benchmark->ArgsProduct({ { 0, 1000, 10000, 100000, 500000 }, { 1, 4, 16, 64 } });
+  benchmark->Unit(benchmark::kNanosecond);
+}
+
+}  // namespace
+
+// ============================================================================
+
+template <std::size_t N>
+ICE_BENCHMARKS_NOINLINE ice::result<payload<N>> failure_result_call(int depth, int success) noexcept
+{
+  if (depth == 1) {
+    if (!success) {
+      return std::errc::no_such_file_or_directory;
+    }
+    return make_payload<N>(depth);
+  }
+  ICE_TRY_ASSIGN(auto value, failure_result_call<N>(depth - 1, success));
+  value[0]++;
+  return value;
+}
+
+template <std::size_t N>
+static void failure_result(benchmark::State& state)
+{
+  failure_run<N>(state, [](int depth, int success) noexcept {
+    const auto res = failure_result_call<N>(depth, success);
+    if (res) {
+      benchmark::DoNotOptimize(res.value()[0]);
+    }
+    return static_cast<bool>(res);
+  });
+}
+BENCHMARK_TEMPLATE(failure_result, 8)->Apply(failure_arguments);
+BENCHMARK_TEMPLATE(failure_result, 64)->Apply(failure_arguments);
+BENCHMARK_TEMPLATE(failure_result, 512)->Apply(failure_arguments);
+
+// ============================================================================
+
+template <std::size_t N>
+ICE_BENCHMARKS_NOINLINE ice::error_code<std::errc> failure_error_code_call(int depth, int success,
+  payload<N>& value) noexcept
+{
+  if (depth == 1) {
+    if (!success) {
+      return std::errc::no_such_file_or_directory;
+    }
+    value = make_payload<N>(depth);
+    return {};
+  }
+  if (const auto ec = failure_error_code_call<N>(depth - 1, success, value)) {
+    return ec;
+  }
+  value[0]++;
+  return {};
+}
+
+template <std::size_t N>
+static void failure_error_code(benchmark::State& state)
+{
+  failure_run<N>(state, [](int depth, int success) noexcept {
+    payload<N> value;
+    const auto ec = failure_error_code_call<N>(depth, success, value);
+    if (!ec) {
+      benchmark::DoNotOptimize(value[0]);
+    }
+    return !ec;
+  });
+}
+BENCHMARK_TEMPLATE(failure_error_code, 8)->Apply(failure_arguments);
+BENCHMARK_TEMPLATE(failure_error_code, 64)->Apply(failure_arguments);
+BENCHMARK_TEMPLATE(failure_error_code, 512)->Apply(failure_arguments);
+
+// ============================================================================
+
+#if ICE_EXCEPTIONS
+
+template <std::size_t N>
+ICE_BENCHMARKS_NOINLINE payload<N> failure_exceptions_call(int depth, int success)
+{
+  if (depth == 1) {
+    if (!success) {
+      throw std::system_error(std::make_error_code(std::errc::no_such_file_or_directory));
+    }
+    return make_payload<N>(depth);
+  }
+  auto value = failure_exceptions_call<N>(depth - 1, success);
+  value[0]++;
+  return value;
+}
+
+template <std::size_t N>
+static void failure_exceptions(benchmark::State& state)
+{
+  failure_run<N>(state, [](int depth, int success) {
+    try {
+      const auto value = failure_exceptions_call<N>(depth, success);
+      benchmark::DoNotOptimize(value[0]);
+      return true;
+    }
+    catch (const std::system_error& e) {
+      benchmark::DoNotOptimize(e);
+    }
+    return false;
+  });
+}
+BENCHMARK_TEMPLATE(failure_exceptions, 8)->Apply(failure_arguments);
+BENCHMARK_TEMPLATE(failure_exceptions, 64)->Apply(failure_arguments);
+BENCHMARK_TEMPLATE(failure_exceptions, 512)->Apply(failure_arguments);
+
+#endif
+
+// ============================================================================
+
+#ifdef __cpp_lib_expected
+
+template <std::size_t N>
+ICE_BENCHMARKS_NOINLINE std::expected<payload<N>, std::errc> failure_expected_call(int depth, int success) noexcept
+{
+  if (depth == 1) {
+    if (!success) {
+      return std::unexpected(std::errc::no_such_file_or_directory);
+    }
+    return make_payload<N>(depth);
+  }
+  auto value = failure_expected_call<N>(depth - 1, success);
+  if (!value) {
+    return std::unexpected(value.error());
+  }
+  (*value)[0]++;
+  return value;
+}
+
+template <std::size_t N>
+static void failure_expected(benchmark::State& state)
+{
+  failure_run<N>(state, [](int depth, int success) noexcept {
+    const auto value = failure_expected_call<N>(depth, success);
+    if (value) {
+      benchmark::DoNotOptimize((*value)[0]);
+    }
+    return value.has_value();
+  });
+}
+BENCHMARK_TEMPLATE(failure_expected, 8)->Apply(failure_arguments);
+BENCHMARK_TEMPLATE(failure_expected, 64)->Apply(failure_arguments);
+BENCHMARK_TEMPLATE(failure_expected, 512)->Apply(failure_arguments);
+
+#endif
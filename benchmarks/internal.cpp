@@ -27,6 +27,11 @@ ice::result<int> result_int(int success) noexcept
   return symbols::result_int(success);
 }
 
+ice::result<const int*> result_pointer(int success) noexcept
+{
+  return symbols::result_pointer(success);
+}
+
 ice::result<string> result_string(int success) noexcept
 {
   return symbols::result_string(success);
@@ -0,0 +1,69 @@
+#include "symbols.hpp"
+#include <ice/ui/kernels.hpp>
+#include <benchmark/benchmark.h>
+#include <vector>
+
+namespace {
+
+using isa = ice::ui::kernels::isa;
+
+enum class kernel {
+  fill,
+  blend,
+  cover,
+  gradient,
+};
+
+}  // namespace
+
+// Runs a kernel over a span of pixels and reports the throughput as pixels per second.
+// A rate of 1G/s equals one pixel per nanosecond.
+static void ui_kernel(benchmark::State& state, kernel kernel, isa type)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  const auto kernels = ice::ui::kernels::get(type);
+  if (!kernels) {
+    state.SkipWithError("instruction set not supported");
+    return;
+  }
+  const auto size = static_cast<std::size_t>(state.range(0));
+  std::vector<std::uint32_t> pixels(size, 0x1E1E1E);
+  std::vector<std::uint8_t> coverage(size);
+  for (std::size_t i = 0; i < size; i++) {
+    coverage[i] = static_cast<std::uint8_t>(i * 7);
+  }
+  const auto step = size > 1 ? static_cast<std::uint32_t>(((256u << 16) + size - 2) / (size - 1)) : 0u;
+  for (auto _ : state) {
+    switch (kernel) {
+    case kernel::fill:
+      kernels->fill(pixels.data(), size, 0xFF2D2D2D);
+      break;
+    case kernel::blend:
+      kernels->blend(pixels.data(), size, 0x80336699);
+      break;
+    case kernel::cover:
+      kernels->cover(pixels.data(), size, 0xFF336699, coverage.data());
+      break;
+    case kernel::gradient:
+      kernels->gradient(pixels.data(), size, 0xFF202020, 0xC0A0A0A0, 0, step);
+      break;
+    }
+    benchmark::DoNotOptimize(pixels.data());
+    benchmark::ClobberMemory();
+  }
+  const auto pixels_per_iteration = static_cast<double>(size);
+  state.counters["pixels"] = benchmark::Counter(pixels_per_iteration, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+BENCHMARK_CAPTURE(ui_kernel, fill_scalar, kernel::fill, isa::scalar)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(ui_kernel, fill_sse2, kernel::fill, isa::sse2)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(ui_kernel, fill_avx2, kernel::fill, isa::avx2)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(ui_kernel, blend_scalar, kernel::blend, isa::scalar)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(ui_kernel, blend_sse2, kernel::blend, isa::sse2)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(ui_kernel, blend_avx2, kernel::blend, isa::avx2)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(ui_kernel, cover_scalar, kernel::cover, isa::scalar)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(ui_kernel, cover_sse2, kernel::cover, isa::sse2)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(ui_kernel, cover_avx2, kernel::cover, isa::avx2)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(ui_kernel, gradient_scalar, kernel::gradient, isa::scalar)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(ui_kernel, gradient_sse2, kernel::gradient, isa::sse2)->Arg(16)->Arg(256)->Arg(4096);
+BENCHMARK_CAPTURE(ui_kernel, gradient_avx2, kernel::gradient, isa::avx2)->Arg(16)->Arg(256)->Arg(4096);
@@ -0,0 +1,139 @@
+#include "symbols.hpp"
+#include <ice/format.hpp>
+#include <ice/logger.hpp>
+#include <benchmark/benchmark.h>
+#include <mutex>
+#include <string>
+#include <cstdio>
+
+// Writes a trace line to the null device from multiple threads with the logger and with a mutex, fputs and fflush,
+// which is how lines were written before the logger existed. The format benchmarks compare formatting on the calling
+// thread with binary records that are formatted by the logger thread. The trace benchmarks measure trace sites that
+// are disabled at compile time, disabled at runtime by their category, and sampled.
+
+namespace {
+
+#ifdef _WIN32
+constexpr auto logger_null = "NUL";
+#else
+constexpr auto logger_null = "/dev/null";
+#endif
+
+ice::trace_category logger_category{ "benchmark" };
+
+constexpr std::string_view logger_line{ "benchmark: logger line with a few words of text\n" };
+
+std::FILE* logger_file() noexcept
+{
+  static const auto file = std::fopen(logger_null, "wb");
+  return file;
+}
+
+}  // namespace
+
+static void logger_write(benchmark::State& state)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  if (state.thread_index() == 0) {
+    ice::logger::set(logger_file());
+  }
+  for (const auto _ : state) {
+    ice::logger::write(logger_line);
+  }
+  if (state.thread_index() == 0) {
+    ice::logger::flush();
+    ice::logger::set(stderr);
+  }
+}
+BENCHMARK(logger_write)->Unit(benchmark::kNanosecond)->ThreadRange(1, 8);
+
+static void logger_mutex(benchmark::State& state)
+{
+  static std::mutex mutex;
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  const auto file = logger_file();
+  for (const auto _ : state) {
+    std::lock_guard lock{ mutex };
+    std::fputs(logger_line.data(), file);
+    std::fflush(file);
+  }
+}
+BENCHMARK(logger_mutex)->Unit(benchmark::kNanosecond)->ThreadRange(1, 8);
+
+static void logger_format_text(benchmark::State& state)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  if (state.thread_index() == 0) {
+    ice::logger::set(logger_file());
+  }
+  const std::string text{ "text" };
+  int i = 0;
+  for (const auto _ : state) {
+    ice::trace(fmt::format("value {} of {} ({:.3f})", i++, text, 0.5), ICE_FUNCTION);
+  }
+  if (state.thread_index() == 0) {
+    ice::logger::flush();
+    ice::logger::set(stderr);
+  }
+}
+BENCHMARK(logger_format_text)->Unit(benchmark::kNanosecond)->ThreadRange(1, 8);
+
+static void logger_format_binary(benchmark::State& state)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  if (state.thread_index() == 0) {
+    ice::logger::set(logger_file());
+  }
+  const std::string text{ "text" };
+  int i = 0;
+  for (const auto _ : state) {
+    ice::logger::write(ICE_FUNCTION, "value {} of {} ({:.3f})", i++, text, 0.5);
+  }
+  if (state.thread_index() == 0) {
+    ice::logger::flush();
+    ice::logger::set(stderr);
+  }
+}
+BENCHMARK(logger_format_binary)->Unit(benchmark::kNanosecond)->ThreadRange(1, 8);
+
+// Trace site below ICE_TRACE_LEVEL, which removes debug sites in release builds. The arguments are never evaluated.
+static void trace_disabled_level(benchmark::State& state)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  const std::string text{ "text" };
+  for (const auto _ : state) {
+    ICE_TRACE_DEBUG(logger_category, "value {} of {}", std::to_string(state.iterations()), text);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(trace_disabled_level)->Unit(benchmark::kNanosecond);
+
+// Trace site in a category that is disabled at runtime. The arguments are not evaluated.
+static void trace_disabled_category(benchmark::State& state)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  logger_category.set(ice::trace_level::none);
+  const std::string text{ "text" };
+  for (const auto _ : state) {
+    ICE_TRACE_ERROR(logger_category, "value {} of {}", std::to_string(state.iterations()), text);
+    benchmark::ClobberMemory();
+  }
+  logger_category.set(ice::trace_level::info);
+}
+BENCHMARK(trace_disabled_category)->Unit(benchmark::kNanosecond);
+
+// Writes every thousandth line of an enabled site.
+static void trace_sample(benchmark::State& state)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  ice::logger::set(logger_file());
+  const std::string text{ "text" };
+  int i = 0;
+  for (const auto _ : state) {
+    ICE_TRACE_SAMPLE(logger_category, ice::trace_level::info, 1000, "value {} of {} ({})", i++, text, 0.5);
+    benchmark::ClobberMemory();
+  }
+  ice::logger::flush();
+  ice::logger::set(stderr);
+}
+BENCHMARK(trace_sample)->Unit(benchmark::kNanosecond);
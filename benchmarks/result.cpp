@@ -1,5 +1,6 @@
 #include "symbols.hpp"
 #include <ice/context.hpp>
+#include <ice/error_context.hpp>
 #include <benchmark/benchmark.h>
 #include <cstdlib>
 
@@ -85,6 +86,50 @@ BENCHMARK_CAPTURE(result_int_external, failure, 0)->Unit(benchmark::kNanosecond)
 
 // ============================================================================
 
+static void result_pointer_inline(benchmark::State& state, int success)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  native(success);
+  for (const auto _ : state) {
+    const auto res = symbols::result_pointer(native(success));
+    if (res) {
+      benchmark::DoNotOptimize(res.value()[0]);
+    }
+  }
+}
+BENCHMARK_CAPTURE(result_pointer_inline, success, 1)->Unit(benchmark::kNanosecond);
+BENCHMARK_CAPTURE(result_pointer_inline, failure, 0)->Unit(benchmark::kNanosecond);
+
+static void result_pointer_internal(benchmark::State& state, int success)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  native(success);
+  for (const auto _ : state) {
+    const auto res = symbols::internal::result_pointer(native(success));
+    if (res) {
+      benchmark::DoNotOptimize(res.value()[0]);
+    }
+  }
+}
+BENCHMARK_CAPTURE(result_pointer_internal, success, 1)->Unit(benchmark::kNanosecond);
+BENCHMARK_CAPTURE(result_pointer_internal, failure, 0)->Unit(benchmark::kNanosecond);
+
+static void result_pointer_external(benchmark::State& state, int success)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  native(success);
+  for (const auto _ : state) {
+    const auto res = symbols::external::result_pointer(native(success));
+    if (res) {
+      benchmark::DoNotOptimize(res.value()[0]);
+    }
+  }
+}
+BENCHMARK_CAPTURE(result_pointer_external, success, 1)->Unit(benchmark::kNanosecond);
+BENCHMARK_CAPTURE(result_pointer_external, failure, 0)->Unit(benchmark::kNanosecond);
+
+// ============================================================================
+
 static void result_string_inline(benchmark::State& state, int success)
 {
   state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
@@ -129,6 +174,7 @@ BENCHMARK_CAPTURE(result_string_external, failure, 0)->Unit(benchmark::kNanoseco
 
 // ============================================================================
 
+// Propagates the error of a result to the caller with co_await, which requires a coroutine frame.
 static void result_co_await(benchmark::State& state, int success)
 {
   state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
@@ -136,11 +182,99 @@ static void result_co_await(benchmark::State& state, int success)
   for (const auto _ : state) {
     const auto res = [&]() -> ice::result<void> {
       co_await symbols::result_void(native(success));
-      std::abort();
       co_return {};
     }();
     const auto ok = static_cast<bool>(res);
     benchmark::DoNotOptimize(ok);
   }
 }
+BENCHMARK_CAPTURE(result_co_await, success, 1)->Unit(benchmark::kNanosecond);
 BENCHMARK_CAPTURE(result_co_await, failure, 0)->Unit(benchmark::kNanosecond);
+
+// Propagates the error of a result to the caller with ICE_TRY, which is a branch and a return.
+static void result_try(benchmark::State& state, int success)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  native(success);
+  for (const auto _ : state) {
+    const auto res = [&]() noexcept -> ice::result<void> {
+      ICE_TRY(symbols::result_void(native(success)));
+      return {};
+    }();
+    const auto ok = static_cast<bool>(res);
+    benchmark::DoNotOptimize(ok);
+  }
+}
+BENCHMARK_CAPTURE(result_try, success, 1)->Unit(benchmark::kNanosecond);
+BENCHMARK_CAPTURE(result_try, failure, 0)->Unit(benchmark::kNanosecond);
+
+// Propagates the error of a result to the caller with and_then.
+static void result_and_then(benchmark::State& state, int success)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  native(success);
+  for (const auto _ : state) {
+    const auto res = symbols::result_void(native(success)).and_then([]() noexcept {
+      return ice::result<void>{};
+    });
+    const auto ok = static_cast<bool>(res);
+    benchmark::DoNotOptimize(ok);
+  }
+}
+BENCHMARK_CAPTURE(result_and_then, success, 1)->Unit(benchmark::kNanosecond);
+BENCHMARK_CAPTURE(result_and_then, failure, 0)->Unit(benchmark::kNanosecond);
+
+// Propagates the error of a result to the caller with ICE_TRY_CONTEXT, which records the location and a formatted
+// note in the error context of the thread on failure.
+static void result_try_context(benchmark::State& state, int success)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  native(success);
+  for (const auto _ : state) {
+    const auto res = [&]() noexcept -> ice::result<void> {
+      ICE_TRY_CONTEXT(symbols::result_void(native(success)), "success {}", success);
+      return {};
+    }();
+    const auto ok = static_cast<bool>(res);
+    if (!ok) {
+      ice::error_context::clear();
+    }
+    benchmark::DoNotOptimize(ok);
+  }
+}
+BENCHMARK_CAPTURE(result_try_context, success, 1)->Unit(benchmark::kNanosecond);
+BENCHMARK_CAPTURE(result_try_context, failure, 0)->Unit(benchmark::kNanosecond);
+
+// Propagates the error of a result with an int value through ICE_TRY_ASSIGN and transform.
+static void result_try_int(benchmark::State& state, int success)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  native(success);
+  for (const auto _ : state) {
+    const auto res = [&]() noexcept -> ice::result<int> {
+      ICE_TRY_ASSIGN(const auto value, symbols::result_int(native(success)));
+      return value + 1;
+    }();
+    if (res) {
+      benchmark::DoNotOptimize(res.value());
+    }
+  }
+}
+BENCHMARK_CAPTURE(result_try_int, success, 1)->Unit(benchmark::kNanosecond);
+BENCHMARK_CAPTURE(result_try_int, failure, 0)->Unit(benchmark::kNanosecond);
+
+static void result_transform_int(benchmark::State& state, int success)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  native(success);
+  for (const auto _ : state) {
+    const auto res = symbols::result_int(native(success)).transform([](int value) noexcept {
+      return value + 1;
+    });
+    if (res) {
+      benchmark::DoNotOptimize(res.value());
+    }
+  }
+}
+BENCHMARK_CAPTURE(result_transform_int, success, 1)->Unit(benchmark::kNanosecond);
+BENCHMARK_CAPTURE(result_transform_int, failure, 0)->Unit(benchmark::kNanosecond);
@@ -11,6 +11,12 @@
 #  define ICE_BENCHMARKS_TOOLCHAIN "LLVM"
 #endif
 
+#ifdef _MSC_VER
+#  define ICE_BENCHMARKS_NOINLINE __declspec(noinline)
+#else
+#  define ICE_BENCHMARKS_NOINLINE __attribute__((noinline))
+#endif
+
 #define ICE_BENCHMARKS_ASSERT(expression) \
   if (!(expression)) {                    \
     std::abort();                         \
@@ -42,6 +48,9 @@ constexpr std::string_view string_data{
 
 using string = std::array<char, string_data.size()>;
 
+// Pointer results are packed when the pointed to type is aligned to at least two bytes.
+inline constexpr int pointer_data{ 1 };
+
 SYMBOLS_FUNCTION(int code(int success))
 {
   return success ? 0 : 1;
@@ -73,6 +82,14 @@ SYMBOLS_FUNCTION(ice::result<int> result_int(int success))
   return std::errc::no_such_file_or_directory;
 }
 
+SYMBOLS_FUNCTION(ice::result<const int*> result_pointer(int success))
+{
+  if (success) {
+    return &pointer_data;
+  }
+  return std::errc::no_such_file_or_directory;
+}
+
 SYMBOLS_FUNCTION(ice::result<string> result_string(int success))
 {
   if (success) {
@@ -0,0 +1,690 @@
+#include "allocations.hpp"
+#include "symbols.hpp"
+#include <ice/context.hpp>
+#include <ice/os/nuklear.hpp>
+#include <ice/ui/arena.hpp>
+#include <ice/ui/context.hpp>
+#include <ice/ui/damage.hpp>
+#include <ice/ui/input.hpp>
+#include <ice/ui/player.hpp>
+#include <ice/ui/raster.hpp>
+#include <ice/ui/recorder.hpp>
+#include <ice/ui/swapchain.hpp>
+#include <ice/ui/truetype.hpp>
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdlib>
+
+namespace {
+
+// Runs an ice::context on background threads.
+class workers {
+public:
+  workers(std::size_t size) : work_(context_)
+  {
+    for (std::size_t i = 0; i < size; i++) {
+      threads_.emplace_back([this]() {
+        context_.run();
+      });
+    }
+  }
+
+  workers(workers&& other) = delete;
+  workers(const workers& other) = delete;
+  workers& operator=(workers&& other) = delete;
+  workers& operator=(const workers& other) = delete;
+
+  ~workers()
+  {
+    work_.release();
+    context_.stop();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  ice::context& context() noexcept
+  {
+    return context_;
+  }
+
+  std::size_t size() const noexcept
+  {
+    return threads_.size();
+  }
+
+  static workers& get() noexcept
+  {
+    static workers workers{ std::max(std::thread::hardware_concurrency(), 2u) - 1 };
+    return workers;
+  }
+
+private:
+  ice::context context_;
+  ice::context::work work_;
+  std::vector<std::thread> threads_;
+};
+
+// Fixed advance font that does not depend on the platform font rasterizer.
+class font final : public ice::ui::font {
+public:
+  font(float height, float advance) noexcept : advance_(advance)
+  {
+    font_.userdata = nk_handle_ptr(this);
+    font_.height = height;
+    font_.width = get_text_width;
+    ice::ui::font::set(&font_);
+  }
+
+  ~font() override
+  {
+    ice::ui::font::set(nullptr);
+  }
+
+  float width(std::string_view text, float height) const noexcept override
+  {
+    std::size_t size = 0;
+    for (const auto c : text) {
+      if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) {
+        size++;
+      }
+    }
+    return static_cast<float>(size) * advance_;
+  }
+
+private:
+  static float get_text_width(nk_handle handle, float height, const char* string, int length) noexcept
+  {
+    if (!handle.ptr || !string || length < 1) {
+      return 0.0f;
+    }
+    return static_cast<const font*>(handle.ptr)->width({ string, static_cast<std::size_t>(length) }, height);
+  }
+
+  float advance_{ 0.0f };
+  nk_user_font font_{};
+};
+
+// Headless UI context that mirrors the window render loop without a native surface.
+class context final : public ice::ui::context {
+public:
+  enum class stage : std::size_t {
+    layout,
+    commands,
+    raster,
+    present,
+  };
+
+  static constexpr std::size_t stages = 4;
+
+  // Full frames redraw the whole surface, damage frames only redraw and present changed tiles.
+  // Tiles frames redraw the whole surface in parallel on the shared workers.
+  // Thread frames are handed to a render thread that redraws and presents changed tiles like damage frames.
+  enum class mode {
+    full,
+    damage,
+    tiles,
+    thread,
+  };
+
+  // Synthetic input moves, clicks, scrolls and types, idle input never changes the UI.
+  // Replay input feeds a recording loaded with load() through ice::ui::player and starts over at the end.
+  enum class input {
+    synthetic,
+    idle,
+    replay,
+  };
+
+  using clock = std::chrono::steady_clock;
+  using timings = std::array<clock::duration, stages>;
+
+  context(int cx, int cy, mode mode) noexcept : font_(13.0f, 7.0f), mode_(mode), cx_(cx), cy_(cy)
+  {
+    ice::ui::context::set(&context_);
+    if (arena_.create(&context_, font_.get()) || raster_.resize(cx, cy) || damage_.resize(cx, cy)) {
+      std::abort();
+    }
+    surface_.resize(static_cast<std::size_t>(cx) * static_cast<std::size_t>(cy));
+    events_.reserve(4);
+    if (mode_ == mode::thread) {
+      thread_ = std::thread([this]() {
+        run();
+      });
+    }
+  }
+
+  context(context&& other) = delete;
+  context(const context& other) = delete;
+  context& operator=(context&& other) = delete;
+  context& operator=(const context& other) = delete;
+
+  ~context() override
+  {
+    if (thread_.joinable()) {
+      swapchain_.close();
+      thread_.join();
+    }
+    ice::ui::context::set(nullptr);
+    nk_free(&context_);
+  }
+
+  float cx() const noexcept override
+  {
+    return static_cast<float>(cx_);
+  }
+
+  float cy() const noexcept override
+  {
+    return static_cast<float>(cy_);
+  }
+
+  std::shared_ptr<ice::ui::font> create_font(std::string_view name, int size, int weight = 400,
+    ice::ui::font::flags flags = ice::ui::font::flags::normal) noexcept override
+  {
+    return std::make_shared<font>(static_cast<float>(size), static_cast<float>(size) * 0.5f);
+  }
+
+  // Replaces the events with the deterministic synthetic input for the given frame.
+  static void synthetic(std::size_t frame, int cx, int cy, std::vector<ice::ui::input>& events) noexcept
+  {
+    const auto t = static_cast<int>(frame % 240);
+    const auto x = 40 + (t < 120 ? t : 240 - t) * (cx - 80) / 120;
+    const auto y = 20 + (t * 7 % 120) * (cy - 40) / 120;
+    events.clear();
+    events.push_back({ .type = ice::ui::input::type::motion, .x = x, .y = y });
+    if (frame % 30 < 2) {
+      const auto down = frame % 30 == 0;
+      events.push_back({ .type = ice::ui::input::type::button, .id = NK_BUTTON_LEFT, .down = down, .x = x, .y = y });
+    }
+    if (frame % 60 == 30) {
+      events.push_back({ .type = ice::ui::input::type::scroll, .dy = frame % 120 < 60 ? -3.0f : 3.0f });
+    }
+    if (frame % 10 == 5) {
+      events.push_back({ .type = ice::ui::input::type::unicode, .code = static_cast<char32_t>('a' + frame % 26) });
+    }
+  }
+
+  // Loads a recording for replay input.
+  ice::error load(std::vector<std::uint8_t> data) noexcept
+  {
+    return player_.open(std::move(data));
+  }
+
+  // Replays deterministic input for the given frame.
+  void update(std::size_t frame, input input) noexcept
+  {
+    if (input == input::idle) {
+      nk_input_begin(&context_);
+      nk_input_end(&context_);
+      return;
+    }
+    input_ = clock::now();
+    nk_input_begin(&context_);
+    if (input == input::replay) {
+      for (ice::ui::input event; player_.next(event) && event.type != ice::ui::input::type::frame;) {
+        event.apply(&context_);
+      }
+      if (!player_.playing()) {
+        player_.rewind();
+      }
+    } else {
+      synthetic(frame, cx_, cy_, events_);
+      for (const auto& event : events_) {
+        event.apply(&context_);
+      }
+    }
+    nk_input_end(&context_);
+  }
+
+  // Renders a single frame and reports the time spent in each pipeline stage.
+  template <class Scene>
+  timings frame(Scene& scene) noexcept
+  {
+    timings result{};
+    auto time = clock::now();
+    const auto next = [&](stage s) {
+      const auto now = clock::now();
+      result[static_cast<std::size_t>(s)] = now - time;
+      time = now;
+    };
+
+    if (nk_begin(&context_, "root", nk_rect(0.0f, 0.0f, cx(), cy()), NK_WINDOW_SCROLL_AUTO_HIDE)) {
+      scene(*this);
+    }
+    next(stage::layout);
+
+    nk_end(&context_);
+    std::size_t commands = 0;
+    const nk_command* command = nullptr;
+    nk_foreach(command, &context_)
+    {
+      commands++;
+    }
+    benchmark::DoNotOptimize(commands);
+
+    // Thread frames copy the command list and return without waiting for the render thread.
+    if (mode_ == mode::thread) {
+      if (swapchain_.back().assign(&context_, cx_, cy_, std::exchange(input_, clock::time_point{}))) {
+        std::abort();
+      }
+      swapchain_.publish();
+      next(stage::commands);
+      arena_.clear(&context_);
+      return result;
+    }
+    next(stage::commands);
+
+    if (mode_ == mode::full || mode_ == mode::tiles) {
+      if (mode_ == mode::full) {
+        raster_.clear(0x1E1E1E);
+        raster_.render(&context_);
+      } else {
+        auto& workers = workers::get();
+        raster_.render(&context_, 0x1E1E1E, workers.context(), workers.size());
+      }
+      next(stage::raster);
+      std::copy_n(raster_.data(), surface_.size(), surface_.data());
+      damaged_ += surface_.size();
+    } else {
+      damage_.update(&context_);
+      for (const auto& region : damage_) {
+        raster_.clear(0x1E1E1E, region);
+        raster_.render(&context_, region);
+      }
+      next(stage::raster);
+      for (const auto& region : damage_) {
+        for (auto y = region.y0; y < region.y1; y++) {
+          const auto offset = static_cast<std::size_t>(y) * static_cast<std::size_t>(cx_) + region.x0;
+          std::copy_n(raster_.data() + offset, region.x1 - region.x0, surface_.data() + offset);
+        }
+        damaged_ += static_cast<std::size_t>(region.x1 - region.x0) * static_cast<std::size_t>(region.y1 - region.y0);
+      }
+    }
+    benchmark::DoNotOptimize(surface_.data());
+    benchmark::ClobberMemory();
+    next(stage::present);
+    record(std::exchange(input_, clock::time_point{}));
+
+    arena_.clear(&context_);
+    return result;
+  }
+
+  const ice::ui::arena& arena() const noexcept
+  {
+    return arena_;
+  }
+
+  // Returns the number of presented pixels since the last call.
+  std::size_t damaged() noexcept
+  {
+    return damaged_.exchange(0, std::memory_order_relaxed);
+  }
+
+  // Returns the number of thread frames that were replaced before the render thread picked them up.
+  std::size_t dropped() const noexcept
+  {
+    return swapchain_.dropped();
+  }
+
+private:
+  // Renders and presents published thread frames.
+  void run() noexcept
+  {
+    while (!swapchain_.closed()) {
+      const auto frame = swapchain_.acquire();
+      if (!frame) {
+        continue;
+      }
+      damage_.update(frame->get());
+      for (const auto& region : damage_) {
+        raster_.clear(0x1E1E1E, region);
+        raster_.render(frame->get(), region);
+        for (auto y = region.y0; y < region.y1; y++) {
+          const auto offset = static_cast<std::size_t>(y) * static_cast<std::size_t>(cx_) + region.x0;
+          std::copy_n(raster_.data() + offset, region.x1 - region.x0, surface_.data() + offset);
+        }
+        const auto cx = static_cast<std::size_t>(region.x1 - region.x0);
+        damaged_.fetch_add(cx * static_cast<std::size_t>(region.y1 - region.y0), std::memory_order_relaxed);
+      }
+      benchmark::DoNotOptimize(surface_.data());
+      benchmark::ClobberMemory();
+      record(frame->input());
+    }
+  }
+
+  font font_;
+  mode mode_{ mode::full };
+  ice::ui::arena arena_;
+  nk_context context_{};
+  ice::ui::raster raster_;
+  ice::ui::damage damage_;
+  std::vector<std::uint32_t> surface_;
+  std::atomic_size_t damaged_{ 0 };
+  clock::time_point input_;
+  ice::ui::swapchain swapchain_;
+  ice::ui::player player_;
+  std::vector<ice::ui::input> events_;
+  std::thread thread_;
+  int cx_{ 0 };
+  int cy_{ 0 };
+};
+
+// Replicates the demo window from main.cpp.
+class demo {
+public:
+  void operator()(ice::ui::context& context) noexcept
+  {
+    context.layout_row_static(30, 300, 1);
+    if (context.button_label("Unicode（ユニコード）")) {
+      pressed_++;
+    }
+    context.layout_row_dynamic(30, 2);
+    if (context.option_label("Easy", !hard_)) {
+      hard_ = false;
+    }
+    if (context.option_label("Hard", hard_)) {
+      hard_ = true;
+    }
+    context.layout_row_dynamic(22, 1);
+    context.property_int("Scaling:", 1, &property_, 16, 1, 0.3f);
+  }
+
+private:
+  std::size_t pressed_{ 0 };
+  bool hard_{ false };
+  int property_{ 1 };
+};
+
+// Scrollable panel with four widgets per row.
+class stress {
+public:
+  stress(std::size_t widgets) : rows_((widgets + 3) / 4)
+  {
+    for (std::size_t i = 0; i < rows_.size(); i++) {
+      rows_[i].label = "Row " + std::to_string(i);
+    }
+  }
+
+  void operator()(ice::ui::context& context) noexcept
+  {
+    const auto ctx = context.get();
+    for (auto& row : rows_) {
+      context.layout_row_dynamic(22, 4);
+      nk_label(ctx, row.label.data(), NK_TEXT_LEFT);
+      if (context.button_label("Apply")) {
+        row.pressed++;
+      }
+      if (context.option_label("Enabled", row.enabled)) {
+        row.enabled = !row.enabled;
+      }
+      context.property_int("#", 0, &row.value, 100, 1, 0.5f);
+    }
+  }
+
+private:
+  struct row {
+    std::string label;
+    std::size_t pressed{ 0 };
+    bool enabled{ false };
+    int value{ 50 };
+  };
+
+  std::vector<row> rows_;
+};
+
+// Large panel of static rows below a property that changes every frame.
+// Rows are built in retained chunks. Without retention, the hash of the chunks changes every frame.
+class panel {
+public:
+  static constexpr std::size_t chunk = 4;
+
+  panel(std::size_t rows, bool retained) : rows_(rows), retained_(retained)
+  {
+    for (std::size_t i = 0; i < rows_.size(); i++) {
+      rows_[i].label = "Item " + std::to_string(i);
+      rows_[i].value = std::to_string(i * 7) + " units";
+    }
+  }
+
+  void operator()(ice::ui::context& context) noexcept
+  {
+    const auto ctx = context.get();
+    context.layout_row_dynamic(22, 1);
+    context.property_int("Frame:", 0, &frame_, 1 << 30, 1, 0.5f);
+    frame_++;
+    for (std::size_t first = 0; first < rows_.size(); first += chunk) {
+      const auto last = std::min(first + chunk, rows_.size());
+      const auto hash = retained_ ? 0 : static_cast<std::uint64_t>(frame_);
+      if (!context.retained_begin(first, hash, static_cast<float>(last - first) * 26.0f + 8.0f)) {
+        continue;
+      }
+      for (auto i = first; i < last; i++) {
+        context.layout_row_dynamic(22, 3);
+        nk_label(ctx, rows_[i].label.data(), NK_TEXT_LEFT);
+        nk_label(ctx, rows_[i].value.data(), NK_TEXT_RIGHT);
+        if (context.button_label("Edit")) {
+          rows_[i].pressed++;
+        }
+      }
+      context.retained_end();
+    }
+  }
+
+private:
+  struct row {
+    std::string label;
+    std::string value;
+    std::size_t pressed{ 0 };
+  };
+
+  std::vector<row> rows_;
+  bool retained_{ false };
+  int frame_{ 0 };
+};
+
+}  // namespace
+
+// Returns the recording from the file in the ICE_BENCHMARKS_REPLAY environment variable or records synthetic input.
+// Record a file with the --record option of the main executable to benchmark real sessions.
+static const std::vector<std::uint8_t>& recording(int cx, int cy) noexcept
+{
+  static const auto data = [&]() {
+    if (const auto path = std::getenv("ICE_BENCHMARKS_REPLAY")) {
+      std::ifstream file(path, std::ios::binary);
+      if (!file) {
+        std::abort();
+      }
+      return std::vector<std::uint8_t>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    ice::ui::recorder recorder;
+    std::vector<ice::ui::input> events;
+    auto time = ice::ui::recorder::clock::now();
+    if (recorder.open({}, time)) {
+      std::abort();
+    }
+    for (std::size_t frame = 0; frame < 2400; frame++) {
+      context::synthetic(frame, cx, cy, events);
+      for (const auto& event : events) {
+        recorder.write(event, time);
+      }
+      recorder.write({ .type = ice::ui::input::type::frame }, time);
+      time += std::chrono::microseconds{ 16667 };
+    }
+    auto data = recorder.data();
+    recorder.close();
+    return data;
+  }();
+  return data;
+}
+
+template <class Scene>
+static void ui_frame(benchmark::State& state, Scene scene, int cx, int cy, context::mode mode, context::input input)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  context context{ cx, cy, mode };
+  if (input == context::input::replay && context.load(recording(cx, cy))) {
+    std::abort();
+  }
+
+  // Warm up nuklear buffers and window state.
+  std::size_t frame = 0;
+  for (; frame < 16; frame++) {
+    context.update(frame, input);
+    context.frame(scene);
+  }
+  context.damaged();
+  context.latency().reset();
+
+  std::vector<context::clock::duration> frames;
+  frames.reserve(1 << 16);
+  context::timings totals{};
+  std::size_t count = 0;
+  const auto arena_allocations = context.arena().stats().allocations;
+  std::size_t allocs = 0;
+  for (const auto _ : state) {
+    const auto allocations = benchmarks::allocations();
+    context.update(frame++, input);
+    const auto timings = context.frame(scene);
+    allocs += benchmarks::allocations() - allocations;
+    context::clock::duration total{};
+    for (std::size_t i = 0; i < context::stages; i++) {
+      totals[i] += timings[i];
+      total += timings[i];
+    }
+    if (frames.size() < frames.capacity()) {
+      frames.push_back(total);
+    }
+    count++;
+  }
+  if (!count) {
+    return;
+  }
+
+  const auto us = [](auto duration) {
+    return std::chrono::duration<double, std::micro>(duration).count();
+  };
+  const auto n = static_cast<double>(count);
+  state.counters["layout_us"] = us(totals[static_cast<std::size_t>(context::stage::layout)]) / n;
+  state.counters["commands_us"] = us(totals[static_cast<std::size_t>(context::stage::commands)]) / n;
+  state.counters["raster_us"] = us(totals[static_cast<std::size_t>(context::stage::raster)]) / n;
+  state.counters["present_us"] = us(totals[static_cast<std::size_t>(context::stage::present)]) / n;
+  state.counters["arena_allocs"] = static_cast<double>(context.arena().stats().allocations - arena_allocations) / n;
+  if (ICE_BENCHMARKS_ALLOCATIONS) {
+    state.counters["allocs"] = static_cast<double>(allocs) / n;
+  }
+  state.counters["arena_kb"] = static_cast<double>(context.arena().stats().peak) / 1024.0;
+  if (const auto& cache = context.cache(); cache.hits() + cache.misses()) {
+    state.counters["hit_rate"] = static_cast<double>(cache.hits()) / static_cast<double>(cache.hits() + cache.misses());
+  }
+  state.counters["damaged"] = static_cast<double>(context.damaged()) / (n * cx * cy);
+  if (const auto& latency = context.latency(); latency.count()) {
+    state.counters["latency_us"] = us(latency.mean());
+    state.counters["latency_max_us"] = us(latency.max());
+  }
+  if (mode == context::mode::thread) {
+    state.counters["dropped"] = static_cast<double>(context.dropped()) / n;
+  }
+
+  std::sort(frames.begin(), frames.end());
+  const auto percentile = [&](std::size_t p) {
+    return us(frames[std::min(frames.size() - 1, frames.size() * p / 100)]);
+  };
+  state.counters["p50_us"] = percentile(50);
+  state.counters["p99_us"] = percentile(99);
+}
+
+static void ui_demo(benchmark::State& state, context::mode mode, context::input input)
+{
+  ui_frame(state, demo{}, 1280, 720, mode, input);
+}
+BENCHMARK_CAPTURE(ui_demo, full, context::mode::full, context::input::synthetic)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(ui_demo, damage, context::mode::damage, context::input::synthetic)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(ui_demo, idle_full, context::mode::full, context::input::idle)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(ui_demo, idle_damage, context::mode::damage, context::input::idle)->Unit(benchmark::kMicrosecond);
+
+static void ui_stress(benchmark::State& state, context::mode mode, context::input input)
+{
+  ui_frame(state, stress{ static_cast<std::size_t>(state.range(0)) }, 1280, 720, mode, input);
+}
+BENCHMARK_CAPTURE(ui_stress, full, context::mode::full, context::input::synthetic)
+  ->Arg(1000)
+  ->Arg(4000)
+  ->Arg(16000)
+  ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(ui_stress, damage, context::mode::damage, context::input::synthetic)
+  ->Arg(1000)
+  ->Arg(4000)
+  ->Arg(16000)
+  ->Unit(benchmark::kMicrosecond);
+
+static void ui_scaling(benchmark::State& state, context::mode mode, int cx, int cy)
+{
+  ui_frame(state, stress{ 4000 }, cx, cy, mode, context::input::synthetic);
+  state.counters["workers"] = mode == context::mode::tiles ? static_cast<double>(workers::get().size()) : 0.0;
+}
+BENCHMARK_CAPTURE(ui_scaling, 1080p_serial, context::mode::full, 1920, 1080)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(ui_scaling, 1080p_tiles, context::mode::tiles, 1920, 1080)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(ui_scaling, 1440p_serial, context::mode::full, 2560, 1440)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(ui_scaling, 1440p_tiles, context::mode::tiles, 2560, 1440)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(ui_scaling, 4k_serial, context::mode::full, 3840, 2160)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(ui_scaling, 4k_tiles, context::mode::tiles, 3840, 2160)->Unit(benchmark::kMicrosecond);
+
+static void ui_panel(benchmark::State& state, bool retained)
+{
+  ui_frame(state, panel{ static_cast<std::size_t>(state.range(0)), retained }, 1280, 720, context::mode::damage,
+    context::input::synthetic);
+}
+BENCHMARK_CAPTURE(ui_panel, rebuilt, false)->Arg(500)->Arg(2000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(ui_panel, retained, true)->Arg(500)->Arg(2000)->Unit(benchmark::kMicrosecond);
+
+// Compares the input to pixels latency of frames rendered in the frame loop and on a render thread.
+static void ui_latency(benchmark::State& state, context::mode mode)
+{
+  ui_frame(state, stress{ static_cast<std::size_t>(state.range(0)) }, 1280, 720, mode, context::input::synthetic);
+}
+BENCHMARK_CAPTURE(ui_latency, damage, context::mode::damage)->Arg(1000)->Arg(4000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(ui_latency, thread, context::mode::thread)->Arg(1000)->Arg(4000)->Unit(benchmark::kMicrosecond);
+
+// Replays recorded input through ice::ui::player. Without ICE_BENCHMARKS_REPLAY the results match ui_demo
+// and ui_stress with synthetic input, which makes the replay overhead visible.
+static void ui_replay(benchmark::State& state, context::mode mode)
+{
+  if (const auto size = static_cast<std::size_t>(state.range(0))) {
+    ui_frame(state, stress{ size }, 1280, 720, mode, context::input::replay);
+  } else {
+    ui_frame(state, demo{}, 1280, 720, mode, context::input::replay);
+  }
+}
+BENCHMARK_CAPTURE(ui_replay, full, context::mode::full)->Arg(0)->Arg(4000)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(ui_replay, damage, context::mode::damage)->Arg(0)->Arg(4000)->Unit(benchmark::kMicrosecond);
+
+// Measures and prepares a line of text with a system font after the caches are warm.
+static void ui_text(benchmark::State& state, std::string_view text, bool prepare)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  ice::ui::truetype font;
+  if (font.create({}, 10)) {
+    state.SkipWithError("font not available");
+    return;
+  }
+  font.prepare(text);
+  for (auto _ : state) {
+    if (prepare) {
+      font.prepare(text);
+    }
+    benchmark::DoNotOptimize(font.width(text, font.height()));
+  }
+}
+
+BENCHMARK_CAPTURE(ui_text, width_ascii, std::string_view{ "The quick brown fox jumps over the lazy dog." }, false);
+BENCHMARK_CAPTURE(ui_text, width_unicode, std::string_view{ "Übergrößenträger für Straßenbahnen." }, false);
+BENCHMARK_CAPTURE(ui_text, prepare_ascii, std::string_view{ "The quick brown fox jumps over the lazy dog." }, true);
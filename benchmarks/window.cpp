@@ -0,0 +1,152 @@
+#include "symbols.hpp"
+#include <ice/ui/context.hpp>
+#include <ice/window.hpp>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#ifndef _WIN32
+#  include <ice/os/xcb/display.hpp>
+#  include <ice/os/xcb/keysym.hpp>
+#  include <array>
+#  include <memory>
+#endif
+
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+// Closes itself after the first frame was built.
+class startup final : public ice::window {
+public:
+  void on_create() noexcept override
+  {}
+
+  void on_render(ice::ui::context& context) noexcept override
+  {
+    if (frame == clock::time_point{}) {
+      frame = clock::now();
+      destroy();
+    }
+  }
+
+  void on_close() noexcept override
+  {
+    destroy();
+  }
+
+  clock::time_point frame;
+};
+
+}  // namespace
+
+// Measures the time from window creation to the first frame, including the connection to the display server.
+static void window_startup(benchmark::State& state)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  clock::duration total{};
+  std::size_t count = 0;
+  for (auto _ : state) {
+    const auto start = clock::now();
+    startup window;
+    if (window.create() || window.start() || window.show()) {
+      state.SkipWithError("display not available");
+      return;
+    }
+    if (window.run()) {
+      state.SkipWithError("event loop failed");
+      return;
+    }
+    total += window.frame - start;
+    count++;
+  }
+  if (count) {
+    state.counters["first_frame_us"] = std::chrono::duration<double, std::micro>(total).count() / count;
+  }
+}
+BENCHMARK(window_startup)->Unit(benchmark::kMillisecond)->Iterations(20);
+
+#ifndef _WIN32
+
+// Interns the atoms that windows use one round-trip at a time or with all requests sent before the first reply.
+static void window_atoms(benchmark::State& state, bool pipelined)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  std::unique_ptr<xcb_connection_t, decltype(&xcb_disconnect)> connection{ xcb_connect(nullptr, nullptr),
+    xcb_disconnect };
+  if (!connection || xcb_connection_has_error(connection.get())) {
+    state.SkipWithError("display not available");
+    return;
+  }
+  const auto c = connection.get();
+  constexpr auto& atoms = ice::os::xcb::display::atoms;
+  std::array<xcb_intern_atom_cookie_t, atoms.size()> cookies{};
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < atoms.size(); i++) {
+      cookies[i] = xcb_intern_atom(c, 0, static_cast<uint16_t>(atoms[i].size()), atoms[i].data());
+      if (!pipelined) {
+        free(xcb_intern_atom_reply(c, cookies[i], nullptr));
+      }
+    }
+    if (pipelined) {
+      for (const auto cookie : cookies) {
+        free(xcb_intern_atom_reply(c, cookie, nullptr));
+      }
+    }
+  }
+}
+BENCHMARK_CAPTURE(window_atoms, sequential, false)->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(window_atoms, pipelined, true)->Unit(benchmark::kMicrosecond);
+
+namespace {
+
+enum class keysym_lookup {
+  filter,
+  table,
+  compose,
+};
+
+}  // namespace
+
+// Converts a mix of Latin, Cyrillic, Greek, keypad, dead and function keysyms to text.
+// The filter variant is the xcb_is_*_key chain with a Latin-1 cast that was used before the table.
+static void window_keysym(benchmark::State& state, keysym_lookup lookup)
+{
+  state.SetLabel(ICE_BENCHMARKS_TOOLCHAIN);
+  constexpr std::array<xcb_keysym_t, 16> keysyms{
+    XK_a, XK_Shift_L, XK_T, XK_space, XK_Cyrillic_zhe, XK_Greek_omega, XK_dead_acute, XK_e,
+    XK_KP_7, XK_Return, XK_F5, XK_adiaeresis, XK_kana_A, XK_EuroSign, 0x01000000 + 0x30E6, XK_period,
+  };
+  ice::os::xcb::compose compose;
+  std::size_t i = 0;
+  for (auto _ : state) {
+    const auto s = keysyms[i++ % keysyms.size()];
+    char32_t code = 0;
+    switch (lookup) {
+    case keysym_lookup::filter:
+      // clang-format off
+      if (!xcb_is_cursor_key(s) &&
+        !xcb_is_function_key(s) &&
+        !xcb_is_keypad_key(s) &&
+        !xcb_is_misc_function_key(s) &&
+        !xcb_is_modifier_key(s) &&
+        !xcb_is_pf_key(s) &&
+        !xcb_is_private_keypad_key(s))
+      {
+        code = static_cast<unsigned char>(s);
+      }
+      // clang-format on
+      break;
+    case keysym_lookup::table:
+      code = ice::os::xcb::to_unicode(s);
+      break;
+    case keysym_lookup::compose:
+      code = compose(s);
+      break;
+    }
+    benchmark::DoNotOptimize(code);
+  }
+}
+BENCHMARK_CAPTURE(window_keysym, filter, keysym_lookup::filter);
+BENCHMARK_CAPTURE(window_keysym, table, keysym_lookup::table);
+BENCHMARK_CAPTURE(window_keysym, compose, keysym_lookup::compose);
+
+#endif
@@ -18,55 +18,6 @@
 #  include <sys/types.h>
 #endif
 
-namespace ice {
-
-ice::error_info make_error_info(errc) noexcept
-{
-  constexpr auto text = [](int code) -> std::string {
-    return std::generic_category().message(code);
-  };
-  return { "common", text };
-}
-
-}  // namespace ice
-
-namespace ice::system {
-
-ice::error_info make_error_info(errc) noexcept
-{
-  constexpr auto text = [](int code) -> std::string {
-#ifdef _WIN32
-    LPSTR buffer = nullptr;
-    const DWORD length = FormatMessageA(
-      FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_IGNORE_INSERTS, nullptr,
-      static_cast<DWORD>(code), MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), reinterpret_cast<LPSTR>(&buffer), 0, nullptr);
-    if (buffer && length) {
-      std::string text{ buffer };
-      LocalFree(buffer);
-      return text;
-    }
-    return ice::error_info::format(code);
-#else
-    return std::system_category().message(code);
-#endif
-  };
-  return { "system", text };
-}
-
-}  // namespace ice::system
-
-namespace std {
-
-ice::error_info make_error_info(std::errc) noexcept
-{
-  constexpr auto text = [](int code) -> std::string {
-    return std::generic_category().message(code);
-  };
-  return { "generic", text };
-}
-
-}  // namespace std
-
 namespace ice::application {
 namespace detail {
 namespace {
@@ -0,0 +1,239 @@
+#pragma once
+#include <ice/context.hpp>
+#include <ice/result.hpp>
+#include <atomic>
+#include <optional>
+#include <utility>
+#include <cstdint>
+
+namespace ice {
+
+template <ResultValueType T>
+class async_result;
+
+template <ResultValueType T>
+class promise;
+
+namespace detail {
+
+// State that is shared by an async result and its promise and deleted by the last owner.
+// The awaiter is null until the awaiting coroutine stores its handle or the promise stores the address of the state
+// after setting the value. Whichever comes second either resumes the coroutine on the context or does not suspend it.
+// The state counts as work for the context until the value is set, so that the context keeps running while results
+// are pending.
+template <ResultValueType T>
+class async_state {
+public:
+  async_state(ice::context& context) noexcept
+    : schedule_(&context)
+    , work_(context)
+  {}
+
+  async_state(async_state&& other) = delete;
+  async_state(const async_state& other) = delete;
+  async_state& operator=(async_state&& other) = delete;
+  async_state& operator=(const async_state& other) = delete;
+
+  void acquire() noexcept
+  {
+    references_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void release() noexcept
+  {
+    if (references_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  }
+
+  bool ready() const noexcept
+  {
+    return awaiter_.load(std::memory_order_acquire) == this;
+  }
+
+  // Returns false if the value was set before the handle could be stored.
+  bool suspend(ice::coroutine_handle<> handle) noexcept
+  {
+    void* awaiter = nullptr;
+    return awaiter_.compare_exchange_strong(awaiter, handle.address(), std::memory_order_acq_rel,
+      std::memory_order_acquire);
+  }
+
+  void set(ice::result<T> value) noexcept
+  {
+    ICE_ASSERT(!value_);
+    value_.emplace(std::move(value));
+    if (const auto awaiter = awaiter_.exchange(this, std::memory_order_acq_rel)) {
+      schedule_.await_suspend(ice::coroutine_handle<>::from_address(awaiter));
+    }
+    work_.release();
+  }
+
+  ice::result<T> get() noexcept
+  {
+    ICE_ASSERT(value_);
+    return std::move(*value_);
+  }
+
+  bool promised{ false };
+
+private:
+  ~async_state() = default;
+
+  std::atomic<void*> awaiter_{ nullptr };
+  std::atomic<std::uint32_t> references_{ 1 };
+  std::optional<ice::result<T>> value_;
+  ice::context::awaitable schedule_;
+  ice::context::work work_;
+};
+
+}  // namespace detail
+
+// ================================================================================================
+// async result
+// ================================================================================================
+
+// One-shot channel that passes a result from a promise on any thread to a coroutine on a context.
+// The async result and its promise share a single allocation. Setting the value stores it and, if the coroutine is
+// already suspended, pushes the coroutine on the queue of the context that was passed to the constructor. The push
+// does not lock, but waking a thread that waits in run() of the context briefly locks its mutex. A coroutine that
+// awaits a result that was already set continues without suspending. Destroying a promise without setting a value
+// sets ice::errc::broken_promise.
+//
+//   ice::task example(ice::context& context, ice::context& worker) noexcept
+//   {
+//     ice::async_result<int> result{ context };
+//     worker.post([promise = result.promise()]() mutable {
+//       promise.set(42);
+//     });
+//     const auto value = co_await result;  // resumed on a thread that runs context
+//   }
+
+template <ResultValueType T>
+class async_result {
+public:
+  explicit async_result(ice::context& context) noexcept
+    : state_(new detail::async_state<T>(context))
+  {}
+
+  async_result(async_result&& other) noexcept
+    : state_(std::exchange(other.state_, nullptr))
+  {}
+
+  async_result(const async_result& other) = delete;
+
+  async_result& operator=(async_result&& other) noexcept
+  {
+    if (this != &other) {
+      reset();
+      state_ = std::exchange(other.state_, nullptr);
+    }
+    return *this;
+  }
+
+  async_result& operator=(const async_result& other) = delete;
+
+  ~async_result()
+  {
+    reset();
+  }
+
+  // Returns the promise for this result. Must be called once.
+  ice::promise<T> promise() noexcept
+  {
+    ICE_ASSERT(state_);
+    ICE_ASSERT(!state_->promised);
+    state_->promised = true;
+    state_->acquire();
+    return ice::promise<T>{ state_ };
+  }
+
+  bool await_ready() const noexcept
+  {
+    ICE_ASSERT(state_);
+    return state_->ready();
+  }
+
+  bool await_suspend(ice::coroutine_handle<> handle) noexcept
+  {
+    return state_->suspend(handle);
+  }
+
+  ice::result<T> await_resume() noexcept
+  {
+    return state_->get();
+  }
+
+private:
+  void reset() noexcept
+  {
+    if (state_) {
+      std::exchange(state_, nullptr)->release();
+    }
+  }
+
+  detail::async_state<T>* state_{ nullptr };
+};
+
+// ================================================================================================
+// promise
+// ================================================================================================
+
+template <ResultValueType T>
+class promise {
+public:
+  promise() noexcept = default;
+
+  promise(promise&& other) noexcept
+    : state_(std::exchange(other.state_, nullptr))
+  {}
+
+  promise(const promise& other) = delete;
+
+  promise& operator=(promise&& other) noexcept
+  {
+    if (this != &other) {
+      reset();
+      state_ = std::exchange(other.state_, nullptr);
+    }
+    return *this;
+  }
+
+  promise& operator=(const promise& other) = delete;
+
+  ~promise()
+  {
+    reset();
+  }
+
+  explicit operator bool() const noexcept
+  {
+    return state_ != nullptr;
+  }
+
+  // Sets the result and resumes the awaiting coroutine on its context. Must be called once.
+  void set(ice::result<T> value) noexcept
+  {
+    ICE_ASSERT(state_);
+    state_->set(std::move(value));
+    std::exchange(state_, nullptr)->release();
+  }
+
+private:
+  friend class async_result<T>;
+
+  explicit promise(detail::async_state<T>* state) noexcept
+    : state_(state)
+  {}
+
+  void reset() noexcept
+  {
+    if (state_) {
+      set(ice::errc::broken_promise);
+    }
+  }
+
+  detail::async_state<T>* state_{ nullptr };
+};
+
+}  // namespace ice
@@ -0,0 +1,433 @@
+#include "backtrace.hpp"
+#include <ice/format.hpp>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <unwind.h>
+#endif
+
+#ifdef __linux__
+#  include <cxxabi.h>
+#  include <elf.h>
+#  include <fcntl.h>
+#  include <link.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace ice {
+namespace {
+
+thread_local const async_stack* async_stack_current{ nullptr };
+
+// Returns the address of the resume function of the coroutine, which identifies the coroutine function.
+// The coroutine frames of GCC and Clang start with this address. MSVC records the address of the frame instead.
+void* resume_address(ice::coroutine_handle<> handle) noexcept
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+  return handle.address();
+#else
+  return *static_cast<void* const*>(handle.address());
+#endif
+}
+
+// Module and function that contain an address.
+struct location {
+  std::string module;
+  std::uintptr_t offset{ 0 };
+  std::string name;
+  std::uintptr_t displacement{ 0 };
+};
+
+#ifdef __linux__
+
+// ------------------------------------------------------------------------------------------------
+// elf module
+// ------------------------------------------------------------------------------------------------
+
+// Loaded ELF object with the function symbols of its file.
+// The file is mapped and the symbols are sorted on the first lookup. Names point into the mapping, which is kept
+// for the lifetime of the process, because the modules are cached in a static table.
+class elf_module {
+public:
+  struct symbol {
+    std::uintptr_t address{ 0 };
+    std::uintptr_t size{ 0 };
+    const char* name{ nullptr };
+  };
+
+  elf_module(std::string path, std::uintptr_t bias, std::uintptr_t begin, std::uintptr_t end) noexcept
+    : path_(std::move(path))
+    , bias_(bias)
+    , begin_(begin)
+    , end_(end)
+  {}
+
+  elf_module(elf_module&& other) = delete;
+  elf_module(const elf_module& other) = delete;
+  elf_module& operator=(elf_module&& other) = delete;
+  elf_module& operator=(const elf_module& other) = delete;
+
+  ~elf_module()
+  {
+    if (data_) {
+      munmap(data_, size_);
+    }
+  }
+
+  constexpr bool contains(std::uintptr_t address) const noexcept
+  {
+    return address >= begin_ && address < end_;
+  }
+
+  constexpr bool equals(const std::string& path, std::uintptr_t bias) const noexcept
+  {
+    return bias_ == bias && path_ == path;
+  }
+
+  const std::string& path() const noexcept
+  {
+    return path_;
+  }
+
+  // Returns the offset of the address in the file, which is what addr2line expects.
+  constexpr std::uintptr_t offset(std::uintptr_t address) const noexcept
+  {
+    return address - bias_;
+  }
+
+  // Returns the function symbol that contains the address or nullptr.
+  const symbol* find(std::uintptr_t address) noexcept
+  {
+    if (!loaded_) {
+      load();
+      loaded_ = true;
+    }
+    const auto value = offset(address);
+    auto it = std::upper_bound(symbols_.begin(), symbols_.end(), value, [](std::uintptr_t value, const symbol& s) {
+      return value < s.address;
+    });
+    if (it == symbols_.begin()) {
+      return nullptr;
+    }
+    --it;
+    if (it->size && value >= it->address + it->size) {
+      return nullptr;
+    }
+    return &*it;
+  }
+
+private:
+  void load() noexcept
+  {
+    const auto fd = open(path_.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+      return;
+    }
+    struct stat st = {};
+    if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) > sizeof(ElfW(Ehdr))) {
+      size_ = static_cast<std::size_t>(st.st_size);
+      data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data_ == MAP_FAILED) {
+        data_ = nullptr;
+      }
+    }
+    close(fd);
+    if (!data_) {
+      return;
+    }
+
+    const auto base = static_cast<const unsigned char*>(data_);
+    const auto& header = *reinterpret_cast<const ElfW(Ehdr)*>(base);
+    if (std::memcmp(header.e_ident, ELFMAG, SELFMAG) != 0 || header.e_shentsize != sizeof(ElfW(Shdr))) {
+      return;
+    }
+    if (header.e_shoff >= size_ || header.e_shnum > (size_ - header.e_shoff) / sizeof(ElfW(Shdr))) {
+      return;
+    }
+    const auto sections = reinterpret_cast<const ElfW(Shdr)*>(base + header.e_shoff);
+    const auto inside = [this](const ElfW(Shdr)& section) {
+      return section.sh_offset <= size_ && section.sh_size <= size_ - section.sh_offset;
+    };
+
+    // Prefer the full symbol table and fall back to the dynamic symbols of stripped files.
+    for (const auto type : { ElfW(Word)(SHT_SYMTAB), ElfW(Word)(SHT_DYNSYM) }) {
+      for (std::size_t i = 0; i < header.e_shnum; i++) {
+        const auto& section = sections[i];
+        if (section.sh_type != type || section.sh_entsize != sizeof(ElfW(Sym)) || section.sh_link >= header.e_shnum) {
+          continue;
+        }
+        const auto& strings = sections[section.sh_link];
+        if (!inside(section) || !inside(strings) || !strings.sh_size) {
+          continue;
+        }
+        const auto names = reinterpret_cast<const char*>(base + strings.sh_offset);
+        if (names[strings.sh_size - 1] != '\0') {
+          continue;
+        }
+        const auto symbols = reinterpret_cast<const ElfW(Sym)*>(base + section.sh_offset);
+        for (std::size_t j = 0, size = section.sh_size / sizeof(ElfW(Sym)); j < size; j++) {
+          const auto& s = symbols[j];
+          if (ELF64_ST_TYPE(s.st_info) != STT_FUNC || !s.st_value || s.st_name >= strings.sh_size) {
+            continue;
+          }
+          symbols_.push_back({ s.st_value, s.st_size, names + s.st_name });
+        }
+      }
+      if (!symbols_.empty()) {
+        break;
+      }
+    }
+    std::sort(symbols_.begin(), symbols_.end(), [](const symbol& lhs, const symbol& rhs) {
+      return lhs.address < rhs.address;
+    });
+  }
+
+  std::string path_;
+  std::uintptr_t bias_{ 0 };
+  std::uintptr_t begin_{ 0 };
+  std::uintptr_t end_{ 0 };
+  void* data_{ nullptr };
+  std::size_t size_{ 0 };
+  std::vector<symbol> symbols_;
+  bool loaded_{ false };
+};
+
+// ------------------------------------------------------------------------------------------------
+// elf modules
+// ------------------------------------------------------------------------------------------------
+
+std::mutex elf_mutex;
+std::vector<std::unique_ptr<elf_module>> elf_modules;
+
+// Adds the loaded objects that are not in the table yet. Must be called while holding the mutex.
+void elf_update() noexcept
+{
+  dl_iterate_phdr(
+    [](dl_phdr_info* info, std::size_t, void*) noexcept {
+      auto begin = UINTPTR_MAX;
+      auto end = std::uintptr_t(0);
+      for (std::size_t i = 0; i < info->dlpi_phnum; i++) {
+        const auto& segment = info->dlpi_phdr[i];
+        if (segment.p_type == PT_LOAD) {
+          begin = std::min<std::uintptr_t>(begin, info->dlpi_addr + segment.p_vaddr);
+          end = std::max<std::uintptr_t>(end, info->dlpi_addr + segment.p_vaddr + segment.p_memsz);
+        }
+      }
+      // The main executable and the vdso have an empty name.
+      std::string path = info->dlpi_name && info->dlpi_name[0] ? info->dlpi_name : "";
+      if (path.empty()) {
+        if (!elf_modules.empty() || begin >= end) {
+          return 0;
+        }
+        char buffer[PATH_MAX];
+        const auto size = readlink("/proc/self/exe", buffer, sizeof(buffer));
+        path = size > 0 ? std::string(buffer, static_cast<std::size_t>(size)) : "/proc/self/exe";
+      }
+      for (const auto& module : elf_modules) {
+        if (module->equals(path, info->dlpi_addr)) {
+          return 0;
+        }
+      }
+      if (begin < end) {
+        elf_modules.push_back(std::make_unique<elf_module>(std::move(path), info->dlpi_addr, begin, end));
+      }
+      return 0;
+    },
+    nullptr);
+}
+
+std::string demangle(const char* name) noexcept
+{
+  auto status = 0;
+  std::unique_ptr<char, decltype(&std::free)> demangled{ abi::__cxa_demangle(name, nullptr, nullptr, &status),
+    std::free };
+  if (status == 0 && demangled) {
+    return demangled.get();
+  }
+  return name;
+}
+
+location locate(const void* address) noexcept
+{
+  const auto value = reinterpret_cast<std::uintptr_t>(address);
+  std::lock_guard lock{ elf_mutex };
+  const auto find = [value]() noexcept -> elf_module* {
+    for (const auto& module : elf_modules) {
+      if (module->contains(value)) {
+        return module.get();
+      }
+    }
+    return nullptr;
+  };
+  auto module = find();
+  if (!module) {
+    // Libraries can be loaded after the table was built.
+    elf_update();
+    module = find();
+  }
+  location location;
+  if (module) {
+    location.module = module->path();
+    location.offset = module->offset(value);
+    if (const auto symbol = module->find(value)) {
+      location.name = demangle(symbol->name);
+      location.displacement = location.offset - symbol->address;
+    }
+  }
+  return location;
+}
+
+#elif defined(_WIN32)
+
+location locate(const void* address) noexcept
+{
+  location location;
+  HMODULE handle = nullptr;
+  constexpr DWORD flags = GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT;
+  if (GetModuleHandleExA(flags, static_cast<LPCSTR>(address), &handle)) {
+    char path[MAX_PATH]{};
+    if (const auto size = GetModuleFileNameA(handle, path, MAX_PATH)) {
+      location.module.assign(path, size);
+    }
+    location.offset = reinterpret_cast<std::uintptr_t>(address) - reinterpret_cast<std::uintptr_t>(handle);
+  }
+  return location;
+}
+
+#else
+
+location locate(const void* address) noexcept
+{
+  return {};
+}
+
+#endif
+
+#ifndef _WIN32
+
+struct unwind_state {
+  void** data{ nullptr };
+  std::size_t size{ 0 };
+  std::size_t skip{ 0 };
+};
+
+_Unwind_Reason_Code unwind(_Unwind_Context* context, void* arg) noexcept
+{
+  auto& state = *static_cast<unwind_state*>(arg);
+  const auto ip = _Unwind_GetIP(context);
+  if (!ip) {
+    return _URC_END_OF_STACK;
+  }
+  if (state.skip) {
+    state.skip--;
+    return _URC_NO_REASON;
+  }
+  state.data[state.size++] = reinterpret_cast<void*>(ip);
+  return state.size < backtrace::capacity ? _URC_NO_REASON : _URC_END_OF_STACK;
+}
+
+#endif
+
+// Prints one frame. Return addresses point after the call, so the previous byte is used to find the function.
+void print_frame(std::FILE* stream, std::size_t index, void* address, bool call) noexcept
+{
+  const auto value = reinterpret_cast<std::uintptr_t>(address);
+  auto location = locate(reinterpret_cast<const void*>(call && value ? value - 1 : value));
+  if (call && !location.module.empty()) {
+    location.offset++;
+    location.displacement++;
+  }
+  fmt::print(stream, "  #{:<2} 0x{:016X}", index, value);
+  if (!location.name.empty()) {
+    fmt::print(stream, " {} + 0x{:X}", location.name, location.displacement);
+  }
+  if (!location.module.empty()) {
+    fmt::print(stream, " ({} + 0x{:X})", location.module, location.offset);
+  }
+  std::fputc('\n', stream);
+}
+
+}  // namespace
+
+// ================================================================================================
+// async stack
+// ================================================================================================
+
+const async_stack* async_stack::current() noexcept
+{
+  return async_stack_current;
+}
+
+void async_stack::assign(ice::coroutine_handle<> handle) noexcept
+{
+  const auto address = resume_address(handle);
+  addresses_[0] = address;
+  size_ = 1;
+  if (const auto stack = current()) {
+    // A coroutine that is suspended again continues the async stack that it was resumed with.
+    auto parent = stack->addresses();
+    if (!parent.empty() && parent.front() == address) {
+      parent = parent.subspan(1);
+    }
+    const auto size = std::min(parent.size(), capacity - 1);
+    std::copy_n(parent.begin(), size, addresses_.begin() + 1);
+    size_ += size;
+  }
+}
+
+const async_stack* async_stack::exchange(const async_stack* stack) noexcept
+{
+  return std::exchange(async_stack_current, stack);
+}
+
+// ================================================================================================
+// backtrace
+// ================================================================================================
+
+backtrace backtrace::capture(std::size_t skip) noexcept
+{
+  backtrace backtrace;
+#ifdef _WIN32
+  backtrace.size_ = RtlCaptureStackBackTrace(static_cast<DWORD>(skip + 1), capacity, backtrace.stack_.data(), nullptr);
+#else
+  unwind_state state{ backtrace.stack_.data(), 0, skip + 1 };
+  _Unwind_Backtrace(unwind, &state);
+  backtrace.size_ = state.size;
+#endif
+  if (const auto stack = async_stack::current()) {
+    backtrace.async_ = *stack;
+  }
+  return backtrace;
+}
+
+std::string backtrace::symbol(const void* address) noexcept
+{
+  return locate(address).name;
+}
+
+void backtrace::print(std::FILE* stream) const noexcept
+{
+  const auto stack = this->stack();
+  for (std::size_t i = 0; i < stack.size(); i++) {
+    print_frame(stream, i, stack[i], true);
+  }
+  if (const auto async = this->async(); !async.empty()) {
+    std::fputs("async:\n", stream);
+    for (std::size_t i = 0; i < async.size(); i++) {
+      print_frame(stream, i, async[i], false);
+    }
+  }
+}
+
+}  // namespace ice
@@ -0,0 +1,102 @@
+#pragma once
+#include <ice/coroutine.hpp>
+#include <array>
+#include <span>
+#include <string>
+#include <cstddef>
+#include <cstdio>
+
+namespace ice {
+
+// ================================================================================================
+// async stack
+// ================================================================================================
+
+// Coroutines that were suspended on one thread and resumed on another, starting with the innermost one.
+// The awaitable of a context records the suspended coroutine followed by the async stack of the suspending thread,
+// and the context makes a copy of it current while the coroutine runs. Entries are copied instead of linked, because
+// posted tasks can outlive the coroutine that posted them. Contexts only record async stacks when ICE_ASYNC_STACK is
+// enabled, which is the default in debug builds.
+
+class ICE_API async_stack {
+public:
+  static constexpr std::size_t capacity = 8;
+
+  // Makes an async stack current on the calling thread until the scope is destroyed.
+  class scope {
+  public:
+    explicit scope(const async_stack* stack) noexcept
+      : previous_(async_stack::exchange(stack))
+    {}
+
+    scope(scope&& other) = delete;
+    scope(const scope& other) = delete;
+    scope& operator=(scope&& other) = delete;
+    scope& operator=(const scope& other) = delete;
+
+    ~scope()
+    {
+      async_stack::exchange(previous_);
+    }
+
+  private:
+    const async_stack* previous_;
+  };
+
+  // Returns the async stack of the coroutine that runs on the calling thread or nullptr.
+  static const async_stack* current() noexcept;
+
+  // Records the coroutine followed by the async stack of the calling thread.
+  void assign(ice::coroutine_handle<> handle) noexcept;
+
+  std::span<void* const> addresses() const noexcept
+  {
+    return { addresses_.data(), size_ };
+  }
+
+private:
+  static const async_stack* exchange(const async_stack* stack) noexcept;
+
+  std::array<void*, capacity> addresses_{};
+  std::size_t size_{ 0 };
+};
+
+// ================================================================================================
+// backtrace
+// ================================================================================================
+
+// Return addresses of the calling thread followed by its async stack.
+// Capturing only copies addresses. Symbols are resolved when the backtrace is printed: the ELF files of the loaded
+// modules are mapped on first use and their sorted symbol tables are cached for the lifetime of the process.
+// On Windows, frames are printed as module and offset.
+
+class ICE_API backtrace {
+public:
+  static constexpr std::size_t capacity = 64;
+
+  // Captures the backtrace of the calling thread without the given number of innermost frames.
+  static backtrace capture(std::size_t skip = 0) noexcept;
+
+  // Returns the demangled name of the function that contains the address or an empty string.
+  static std::string symbol(const void* address) noexcept;
+
+  std::span<void* const> stack() const noexcept
+  {
+    return { stack_.data(), size_ };
+  }
+
+  std::span<void* const> async() const noexcept
+  {
+    return async_.addresses();
+  }
+
+  // Writes one line per frame with the address, function, module and offset in the module.
+  void print(std::FILE* stream) const noexcept;
+
+private:
+  std::array<void*, capacity> stack_{};
+  std::size_t size_{ 0 };
+  ice::async_stack async_;
+};
+
+}  // namespace ice
@@ -13,6 +13,38 @@
 #  endif
 #endif
 
+// Counts errors that are created from error codes by type and code (see ice::error_telemetry).
+#ifndef ICE_ERROR_TELEMETRY
+#  define ICE_ERROR_TELEMETRY 0
+#endif
+
+// Records the async stack of coroutines that are resumed by a context (see ice::async_stack).
+// Each suspension copies the async stack of the suspending thread, which is why it is only enabled in debug builds.
+#ifndef ICE_ASYNC_STACK
+#  define ICE_ASYNC_STACK ICE_DEBUG
+#endif
+
+// Writes trace lines as binary records that are formatted later (see ice::logger).
+#ifndef ICE_TRACE_BINARY
+#  define ICE_TRACE_BINARY 0
+#endif
+
+// Trace levels (see ice::trace_level).
+#define ICE_TRACE_LEVEL_DEBUG 0
+#define ICE_TRACE_LEVEL_INFO 1
+#define ICE_TRACE_LEVEL_WARNING 2
+#define ICE_TRACE_LEVEL_ERROR 3
+#define ICE_TRACE_LEVEL_NONE 4
+
+// Removes trace sites below this level at compile time.
+#ifndef ICE_TRACE_LEVEL
+#  if ICE_DEBUG
+#    define ICE_TRACE_LEVEL ICE_TRACE_LEVEL_DEBUG
+#  else
+#    define ICE_TRACE_LEVEL ICE_TRACE_LEVEL_INFO
+#  endif
+#endif
+
 // ================================================================================================
 // macros
 // ================================================================================================
@@ -106,6 +138,7 @@ enum class errc {
   unicode_not_enough_memory,
   unicode_overlong_sequence,
   unicode_unassigned,
+  broken_promise,
   unknown = 0xFFFFFFF,
 };
 
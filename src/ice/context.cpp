@@ -14,23 +14,23 @@ ice::error context::run() noexcept
   while (!stop && size) {
     if (node) {
       cv_.notify_one();
-      ICE_ASSERT(node->awaiter_);
-      node->awaiter_.resume();
+      resume(node);
       node = nullptr;
       size_.fetch_sub(1, std::memory_order_release);
     }
     lock.lock();
+    waiting_.fetch_add(1, std::memory_order_seq_cst);
     cv_.wait(lock, [&]() {
       node = dequeue();
       stop = stop_.load(std::memory_order_acquire);
       size = size_.load(std::memory_order_acquire);
       return node || stop || !size;
     });
+    waiting_.fetch_sub(1, std::memory_order_relaxed);
     lock.unlock();
   }
   if (node) {
-    ICE_ASSERT(node->awaiter_);
-    node->awaiter_.resume();
+    resume(node);
     size_.fetch_sub(1, std::memory_order_release);
   }
   run_.fetch_sub(1, std::memory_order_release);
@@ -40,19 +40,36 @@ ice::error context::run() noexcept
   return {};
 }
 
+// Must be called while holding the mutex.
 context::awaitable* context::dequeue() noexcept
 {
-  awaitable* next;  // NOLINT(cppcoreguidelines-init-variables)
-  awaitable* head = head_.load(std::memory_order_acquire);
-  do {
-    if (head == nullptr) {
-      return nullptr;
+  if (!queue_) {
+    // Reverse the stack to resume nodes in the order in which they were enqueued.
+    auto node = head_.exchange(nullptr, std::memory_order_seq_cst);
+    while (node) {
+      const auto next = node->next_.load(std::memory_order_relaxed);
+      node->next_.store(queue_, std::memory_order_relaxed);
+      queue_ = node;
+      node = next;
     }
-    next = head->next_.load(std::memory_order_acquire);
-  } while (!head_.compare_exchange_weak(head, next, std::memory_order_relaxed, std::memory_order_acquire));
-  awaitable* tail = head;
-  tail_.compare_exchange_strong(tail, next, std::memory_order_release, std::memory_order_relaxed);
-  return head;
+  }
+  const auto node = queue_;
+  if (node) {
+    queue_ = node->next_.load(std::memory_order_relaxed);
+  }
+  return node;
+}
+
+// Resumes the coroutine with the async stack that was recorded when it was suspended, if ICE_ASYNC_STACK is enabled.
+// The async stack is copied, because the awaitable is destroyed when the coroutine continues.
+void context::resume(awaitable* node) noexcept
+{
+  ICE_ASSERT(node->awaiter_);
+#if ICE_ASYNC_STACK
+  const auto stack = node->stack_;
+  ice::async_stack::scope scope{ &stack };
+#endif
+  node->awaiter_.resume();
 }
 
 }  // namespace ice
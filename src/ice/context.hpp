@@ -1,4 +1,5 @@
 #pragma once
+#include <ice/backtrace.hpp>
 #include <ice/task.hpp>
 #include <atomic>
 #include <condition_variable>
@@ -39,6 +40,9 @@ public:
       ICE_ASSERT(context_);
       ICE_ASSERT(!awaiter_);
       awaiter_ = handle;
+#if ICE_ASYNC_STACK
+      stack_.assign(handle);
+#endif
       context_->enqueue(this);
     }
 
@@ -49,6 +53,9 @@ public:
     context* context_;
     ice::coroutine_handle<> awaiter_{ nullptr };
     std::atomic<awaitable*> next_{ nullptr };
+#if ICE_ASYNC_STACK
+    ice::async_stack stack_;
+#endif
   };
 
   class work {
@@ -84,10 +91,13 @@ public:
       release();
     }
 
+    // Wakes up threads in run() when the last work was released, because they might wait for it.
     constexpr void release() noexcept
     {
       if (context_) {
-        context_->size_.fetch_sub(1, std::memory_order_release);
+        if (context_->size_.fetch_sub(1, std::memory_order_release) == 1) {
+          context_->notify_all();
+        }
         context_ = nullptr;
       }
     }
@@ -119,38 +129,55 @@ public:
   void stop() noexcept
   {
     stop_.store(true, std::memory_order_release);
-    cv_.notify_all();
+    notify_all();
   }
 
 private:
+  // Producers push nodes on a lock-free stack. Consumers take the whole stack while holding the mutex.
+  // Producers only lock the mutex to notify when a thread waits in run(). Waiting threads register before they check
+  // the stack and producers check for them after the push, both sequentially consistent, so either the waiting thread
+  // finds the node or the producer finds the waiting thread. Locking the mutex before the notification makes sure that
+  // it can not be lost between the predicate check and the wait in run().
   void enqueue(awaitable* node) noexcept
   {
     ICE_ASSERT(node != nullptr);
     ICE_ASSERT(node->next_.load(std::memory_order_acquire) == nullptr);
-    awaitable* tail;  // NOLINT(cppcoreguidelines-init-variables)
-    awaitable* next;  // NOLINT(cppcoreguidelines-init-variables)
     size_.fetch_add(1, std::memory_order_release);
+    auto head = head_.load(std::memory_order_relaxed);
     do {
-      tail = nullptr;
-      next = nullptr;
-      if (tail_.compare_exchange_weak(tail, node, std::memory_order_release, std::memory_order_acquire)) {
-        head_.compare_exchange_strong(next, node, std::memory_order_release, std::memory_order_relaxed);
-        return;
-      }
-    } while (!tail->next_.compare_exchange_weak(next, node, std::memory_order_release, std::memory_order_relaxed));
-    tail_.compare_exchange_strong(tail, node, std::memory_order_release, std::memory_order_relaxed);
+      node->next_.store(head, std::memory_order_relaxed);
+    } while (!head_.compare_exchange_weak(head, node, std::memory_order_seq_cst, std::memory_order_relaxed));
+    if (waiting_.load(std::memory_order_seq_cst)) {
+      notify_one();
+    }
+  }
+
+  void notify_one() noexcept
+  {
+    std::unique_lock lock{ mutex_ };
+    lock.unlock();
     cv_.notify_one();
   }
 
+  void notify_all() noexcept
+  {
+    std::unique_lock lock{ mutex_ };
+    lock.unlock();
+    cv_.notify_all();
+  }
+
   awaitable* dequeue() noexcept;
 
+  static void resume(awaitable* node) noexcept;
+
   std::mutex mutex_;
   std::condition_variable cv_;
   std::atomic_size_t run_{ 0 };
   std::atomic_size_t size_{ 0 };
+  std::atomic_size_t waiting_{ 0 };
   std::atomic_bool stop_{ false };
   std::atomic<awaitable*> head_{ nullptr };
-  std::atomic<awaitable*> tail_{ nullptr };
+  awaitable* queue_{ nullptr };
 };
 
 }  // namespace ice
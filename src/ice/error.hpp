@@ -1,8 +1,16 @@
 #pragma once
 #include <ice/error_code.hpp>
+#include <array>
 #include <type_traits>
+#include <cstdint>
 
 namespace ice {
+namespace detail {
+
+// Counts an error in the table of the calling thread (see ice::error_telemetry).
+ICE_API void error_count(ice::error_type type, int code) noexcept;
+
+}  // namespace detail
 
 // ================================================================================================
 // error
@@ -14,13 +22,17 @@ public:
   constexpr error(E ev) noexcept
     : type_(ice::make_error_type<E>())
     , code_(static_cast<int>(ev))
-  {}
+  {
+    count();
+  }
 
   template <ErrorCodeType E>
   constexpr error(ice::error_code<E> ec) noexcept
     : type_(ice::make_error_type<E>())
     , code_(ec.code())
-  {}
+  {
+    count();
+  }
 
   constexpr error(ice::error_type type, int code) noexcept
     : type_(type)
@@ -36,6 +48,7 @@ public:
     } else if (ec.category() == std::system_category()) {
       type_ = ice::make_error_type<ice::system::errc>();
     }
+    count();
   }
 
   error() noexcept = default;
@@ -60,9 +73,32 @@ public:
   }
 
   friend auto operator<=>(error, error) noexcept = default;
+  friend bool operator==(error, error) noexcept = default;
 
+  // Compares without converting the error code, which would count it.
+  template <ErrorCodeType E>
+  friend constexpr bool operator==(error lhs, E rhs) noexcept
+  {
+    return lhs.type_ == ice::make_error_type<E>() && lhs.code_ == static_cast<int>(rhs);
+  }
+
+  template <ErrorCodeType E>
+  friend constexpr bool operator==(error lhs, ice::error_code<E> rhs) noexcept
+  {
+    return lhs.type_ == ice::make_error_type<E>() && lhs.code_ == rhs.code();
+  }
 
 private:
+  // Errors are counted when they are created from an error code at run time and telemetry is enabled.
+  constexpr void count() const noexcept
+  {
+#if ICE_ERROR_TELEMETRY
+    if (!std::is_constant_evaluated() && code_) {
+      detail::error_count(type_, code_);
+    }
+#endif
+  }
+
   ice::error_type type_{ 0 };
   int code_{ 0 };
 };
@@ -107,4 +143,53 @@ inline ice::error make_error(std::error_code ec) noexcept
   return { ec };
 }
 
+namespace detail {
+
+// Errors of packed result layouts are encoded in 32 bits. Zero means success.
+// Errors of the generic, common, system and unknown categories with codes below 2^29 are encoded in the value itself, which
+// makes them identical in all modules of the process. Other errors are stored once in a process-wide table and
+// identified by their index.
+
+constexpr std::uint32_t error_index_inline = 0x80000000;
+constexpr std::uint32_t error_index_inline_code = 0x1FFFFFFF;
+
+ICE_API std::uint32_t error_store(ice::error e) noexcept;
+ICE_API ice::error error_load(std::uint32_t index) noexcept;
+
+constexpr std::array<ice::error_type, 4> error_index_types{
+  ice::make_error_type<std::errc>(),
+  ice::make_error_type<ice::errc>(),
+  ice::make_error_type<ice::system::errc>(),
+  ice::error_type::unknown,
+};
+
+constexpr std::uint32_t error_index(ice::error e) noexcept
+{
+  if (!e) {
+    return 0;
+  }
+  const auto code = static_cast<std::uint32_t>(e.code());
+  if (code <= error_index_inline_code) {
+    for (std::uint32_t i = 0; i < error_index_types.size(); i++) {
+      if (e.type() == error_index_types[i]) {
+        return error_index_inline | i << 29 | code;
+      }
+    }
+  }
+  return error_store(e);
+}
+
+constexpr ice::error error_value(std::uint32_t index) noexcept
+{
+  if (index & error_index_inline) {
+    const auto type = error_index_types[(index >> 29) & 0x3];
+    return { type, static_cast<int>(index & error_index_inline_code) };
+  }
+  return error_load(index);
+}
+
+constexpr std::uint32_t error_index_invalid_result_value = error_index(ice::errc::invalid_result_value);
+
+}  // namespace detail
+
 }  // namespace ice
@@ -1,108 +1,439 @@
 #include "error_code.hpp"
 #include <ice/format.hpp>
-#include <algorithm>
-#include <iterator>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <deque>
+#include <memory>
 #include <mutex>
-#include <set>
+#include <new>
+#include <system_error>
+#include <vector>
+
+#ifdef _WIN32
+#  include <windows.h>
+#endif
 
 namespace ice {
 namespace {
 
-struct error_name_entry {
-  ice::error_type type{};
-  const char* name = nullptr;
+// Copy-on-write registry of error names and texts.
+// Readers load the current table and look up the type with linear probing, without locks or reference counts.
+// Writers copy the table, modify the copy and publish it. Replaced tables are retired instead of freed, because
+// readers can still use them. Registration is rare and happens mostly during startup and shutdown.
+
+struct error_entry {
+  ice::error_type type{ ice::error_type::success };
+  const char* name{ nullptr };
+  std::string_view (*text)(int code){ nullptr };
+};
+
+struct error_table {
+  const error_entry* entries{ nullptr };
+  std::size_t mask{ 0 };
+
+  const error_entry* find(ice::error_type type) const noexcept
+  {
+    for (auto index = static_cast<std::size_t>(type) & mask;; index = (index + 1) & mask) {
+      const auto& entry = entries[index];
+      if (entry.type == type) {
+        return &entry;
+      }
+      if (entry.type == ice::error_type::success) {
+        return nullptr;
+      }
+    }
+  }
+};
+
+struct error_storage {
+  std::unique_ptr<error_entry[]> entries;
+  error_table table;
+};
+
+std::string generic_message(int code)
+{
+  return std::generic_category().message(code);
+}
+
+std::string system_message(int code)
+{
+#ifdef _WIN32
+  LPSTR buffer = nullptr;
+  const DWORD length = FormatMessageA(
+    FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_IGNORE_INSERTS, nullptr,
+    static_cast<DWORD>(code), MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), reinterpret_cast<LPSTR>(&buffer), 0, nullptr);
+  if (buffer && length) {
+    std::string text{ buffer };
+    LocalFree(buffer);
+    return text;
+  }
+  return ice::error_info::format(code);
+#else
+  return std::system_category().message(code);
+#endif
+}
+
+std::string_view generic_text(int code) noexcept
+{
+  return ice::error_info::cache(ice::make_error_type<std::errc>(), code, generic_message);
+}
+
+std::string_view system_text(int code) noexcept
+{
+  return ice::error_info::cache(ice::make_error_type<ice::system::errc>(), code, system_message);
+}
+
+// The categories of the library are stored in the initial table, which is built at compile time.
+// Programs that only use these categories do no registration work at startup.
+constexpr auto error_builtin_entries = []() {
+  const std::array<error_entry, 3> builtin{ {
+    { ice::make_error_type<std::errc>(), "generic", generic_text },
+    { ice::make_error_type<ice::errc>(), ice::detail::error_category<ice::errc>.name(),
+      ice::detail::error_category_text<ice::errc> },
+    { ice::make_error_type<ice::system::errc>(), "system", system_text },
+  } };
+  std::array<error_entry, 16> entries{};
+  for (const auto& entry : builtin) {
+    auto index = static_cast<std::size_t>(entry.type) & (entries.size() - 1);
+    while (entries[index].type != ice::error_type::success) {
+      index = (index + 1) & (entries.size() - 1);
+    }
+    entries[index] = entry;
+  }
+  return entries;
+}();
+
+constinit const error_table error_builtin{ error_builtin_entries.data(), error_builtin_entries.size() - 1 };
+
+constinit std::atomic<const error_table*> error_data{ &error_builtin };
+
+std::mutex& error_mutex() noexcept
+{
+  static std::mutex error_mutex;
+  return error_mutex;
+}
+
+std::vector<std::unique_ptr<const error_storage>>& error_tables() noexcept
+{
+  static std::vector<std::unique_ptr<const error_storage>> error_tables;
+  return error_tables;
+}
+
+const error_entry* error_find(ice::error_type type) noexcept
+{
+  const auto table = error_data.load(std::memory_order_acquire);
+  return table && type != ice::error_type::success ? table->find(type) : nullptr;
+}
 
-  constexpr bool operator<(error_name_entry other) const noexcept
+// Map from error types and codes to values that is read without locks.
+// Entries are never removed. New entries are written in place and published by their type. When the map is half
+// full, a copy with twice the capacity is published and the old map is retired like the registry.
+
+template <typename Value>
+class error_map {
+public:
+  struct entry {
+    ice::error_type type{ ice::error_type::success };
+    int code{ 0 };
+    Value value{};
+  };
+
+  // Returns the entry of the type and code or nullptr.
+  static const entry* find(ice::error_type type, int code) noexcept
   {
-    return type < other.type;
+    const auto table = data_.load(std::memory_order_acquire);
+    if (!table) {
+      return nullptr;
+    }
+    const auto it = table->slot(type, code);
+    return load(*it) != ice::error_type::success ? it : nullptr;
   }
 
-  constexpr bool operator==(ice::error_type other) const noexcept
+  // Inserts the entry into the map. Must be called with the writer mutex locked.
+  static void insert(ice::error_type type, int code, Value value) noexcept
   {
-    return type == other;
+    auto current = data_.load(std::memory_order_relaxed);
+    if (!current || (current->size_ + 1) * 2 > current->mask_ + 1) {
+      auto table = std::make_unique<error_map>();
+      const auto capacity = current ? (current->mask_ + 1) * 2 : 16;
+      table->entries_.reset(new (std::nothrow) entry[capacity]);
+      if (!table->entries_) {
+        return;
+      }
+      table->mask_ = capacity - 1;
+      if (current) {
+        for (std::size_t i = 0; i <= current->mask_; i++) {
+          if (const auto& it = current->entries_[i]; it.type != ice::error_type::success) {
+            *table->slot(it.type, it.code) = it;
+          }
+        }
+        table->size_ = current->size_;
+      }
+      current = table.get();
+      data_.store(current, std::memory_order_release);
+      tables().push_back(std::move(table));
+    }
+    const auto it = current->slot(type, code);
+    it->code = code;
+    it->value = value;
+    std::atomic_ref{ it->type }.store(type, std::memory_order_release);
+    current->size_++;
   }
-};
 
-struct error_text_entry {
-  ice::error_type type{};
-  std::string (*text)(int code) = nullptr;
+private:
+  static ice::error_type load(const entry& it) noexcept
+  {
+    return std::atomic_ref{ const_cast<ice::error_type&>(it.type) }.load(std::memory_order_acquire);
+  }
 
-  constexpr bool operator<(error_text_entry other) const noexcept
+  static constexpr std::size_t hash(ice::error_type type, int code) noexcept
   {
-    return type < other.type;
+    const auto key = static_cast<std::uint64_t>(type) << 32 | static_cast<std::uint32_t>(code);
+    return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> 32);
   }
 
-  constexpr bool operator==(ice::error_type other) const noexcept
+  entry* slot(ice::error_type type, int code) const noexcept
   {
-    return type == other;
+    for (auto index = hash(type, code) & mask_;; index = (index + 1) & mask_) {
+      auto& it = entries_[index];
+      if (const auto current = load(it); current == ice::error_type::success || (current == type && it.code == code)) {
+        return &it;
+      }
+    }
   }
+
+  static std::vector<std::unique_ptr<error_map>>& tables() noexcept
+  {
+    static std::vector<std::unique_ptr<error_map>> tables;
+    return tables;
+  }
+
+  static inline std::atomic<error_map*> data_{ nullptr };
+
+  std::unique_ptr<entry[]> entries_;
+  std::size_t mask_{ 0 };
+  std::size_t size_{ 0 };
 };
 
-std::set<error_name_entry>& error_name_data() noexcept
+// Errors of packed results that can not be encoded in their index.
+// The errors are stored in chunks that are allocated on demand and never moved, which makes loading an error a
+// plain array access without locks. Each chunk is twice as large as the previous one, so that the chunks of all
+// indices below detail::error_index_inline fit into a small array.
+using error_indices = error_map<std::uint32_t>;
+
+constexpr std::size_t error_chunk_size = 1024;
+constexpr std::size_t error_chunk_count = 21;
+constexpr std::size_t error_chunk_limit = error_chunk_size * ((std::size_t(1) << error_chunk_count) - 1);
+
+static_assert(error_chunk_limit <= ice::detail::error_index_inline);
+
+constinit std::array<std::atomic<ice::error*>, error_chunk_count> error_chunks{};
+
+std::uint32_t error_chunk_index{ 1 };
+
+// Returns the chunk of an index and sets offset to the position in the chunk.
+// Chunk k holds error_chunk_size << k errors and starts at error_chunk_size * (2^k - 1).
+constexpr std::size_t error_chunk(std::size_t index, std::size_t& offset) noexcept
 {
-  static std::set<error_name_entry> error_name_set;
-  return error_name_set;
-};
+  const auto chunk = static_cast<std::size_t>(std::bit_width(index / error_chunk_size + 1) - 1);
+  offset = index - error_chunk_size * ((std::size_t(1) << chunk) - 1);
+  return chunk;
+}
 
-std::set<error_text_entry>& error_text_data() noexcept
+// Texts that are created at runtime, like system messages.
+// The texts are never freed, which makes the views that are returned by the cache valid until exit.
+using error_messages = error_map<std::string_view>;
+
+std::deque<std::string>& error_message_texts() noexcept
 {
-  static std::set<error_text_entry> error_text_set;
-  return error_text_set;
-};
+  static std::deque<std::string> error_message_texts;
+  return error_message_texts;
+}
 
-std::mutex& error_mutex() noexcept
+// Publishes a copy of the current table with the entry of the type modified by the update function.
+template <typename Update>
+void error_update(ice::error_type type, Update update) noexcept
 {
-  static std::mutex error_mutex;
-  return error_mutex;
+  if (type == ice::error_type::success) {
+    return;
+  }
+  std::lock_guard lock{ error_mutex() };
+  const auto current = error_data.load(std::memory_order_relaxed);
+
+  // Collect the entries of the current table and apply the update.
+  std::vector<error_entry> entries;
+  if (current) {
+    for (std::size_t i = 0; i <= current->mask; i++) {
+      if (current->entries[i].type != ice::error_type::success && current->entries[i].type != type) {
+        entries.push_back(current->entries[i]);
+      }
+    }
+  }
+  error_entry entry{ type };
+  if (current) {
+    if (const auto it = current->find(type)) {
+      entry = *it;
+    }
+  }
+  const auto previous = entry;
+  update(entry);
+  if (entry.name == previous.name && entry.text == previous.text) {
+    return;
+  }
+  if (entry.name || entry.text) {
+    entries.push_back(entry);
+  }
+
+  // Keep the load factor at or below 50%, which keeps probe sequences short.
+  std::size_t size = 16;
+  while (size < entries.size() * 2) {
+    size *= 2;
+  }
+  auto storage = std::make_unique<error_storage>();
+  storage->entries.reset(new (std::nothrow) error_entry[size]);
+  if (!storage->entries) {
+    return;
+  }
+  for (const auto& entry : entries) {
+    auto index = static_cast<std::size_t>(entry.type) & (size - 1);
+    while (storage->entries[index].type != ice::error_type::success) {
+      index = (index + 1) & (size - 1);
+    }
+    storage->entries[index] = entry;
+  }
+  storage->table = { storage->entries.get(), size - 1 };
+  error_data.store(&storage->table, std::memory_order_release);
+  error_tables().push_back(std::move(storage));
 }
 
 }  // namespace
 
 void error_info::set(ice::error_type type, const char* name) noexcept
 {
-  std::lock_guard lock{ error_mutex() };
-  auto& data = error_name_data();
-  if (name) {
-    data.insert({ type, name });
-  } else if (const auto it = std::find(data.begin(), data.end(), type); it != data.end()) {
-    data.erase(it);
-  }
+  error_update(type, [name](error_entry& entry) {
+    entry.name = name;
+  });
 }
 
-void error_info::set(ice::error_type type, std::string (*text)(int code)) noexcept
+void error_info::set(ice::error_type type, std::string_view (*text)(int code)) noexcept
 {
-  std::lock_guard lock{ error_mutex() };
-  auto& data = error_text_data();
-  if (text) {
-    data.insert({ type, text });
-  } else if (const auto it = std::find(data.begin(), data.end(), type); it != data.end()) {
-    data.erase(it);
-  }
+  error_update(type, [text](error_entry& entry) {
+    entry.text = text;
+  });
 }
 
 const char* error_info::get(ice::error_type type) noexcept
 {
-  std::lock_guard lock{ error_mutex() };
-  const auto& data = error_name_data();
-  if (const auto it = std::find(data.begin(), data.end(), type); it != data.end()) {
-    return it->name;
+  if (const auto entry = error_find(type)) {
+    return entry->name;
   }
   return nullptr;
 }
 
+std::string_view error_info::message(ice::error_type type, int code) noexcept
+{
+  if (const auto entry = error_find(type); entry && entry->text) {
+    return entry->text(code);
+  }
+  return {};
+}
+
 std::string error_info::get(ice::error_type type, int code) noexcept
 {
-  std::lock_guard lock{ error_mutex() };
-  const auto& data = error_text_data();
-  if (const auto it = std::find(data.begin(), data.end(), type); it != data.end()) {
-    return it->text(code);
+  if (const auto text = message(type, code); !text.empty()) {
+    return std::string{ text };
   }
   return fmt::format("{:08X}", static_cast<unsigned>(code));
 }
 
+std::string_view error_info::cache(ice::error_type type, int code, std::string (*text)(int code)) noexcept
+{
+  if (const auto entry = error_messages::find(type, code)) {
+    return entry->value;
+  }
+  std::lock_guard lock{ error_mutex() };
+  if (const auto entry = error_messages::find(type, code)) {
+    return entry->value;
+  }
+  const std::string_view view = error_message_texts().emplace_back(text(code));
+  error_messages::insert(type, code, view);
+  return view;
+}
+
+namespace detail {
+
+std::uint32_t error_store(ice::error e) noexcept
+{
+  if (const auto entry = error_indices::find(e.type(), e.code())) {
+    return entry->value;
+  }
+  const char* reason = "table is full";
+  {
+    std::lock_guard lock{ error_mutex() };
+    if (const auto entry = error_indices::find(e.type(), e.code())) {
+      return entry->value;
+    }
+    const auto index = error_chunk_index;
+    if (index < error_chunk_limit) {
+      std::size_t offset = 0;
+      const auto number = error_chunk(index, offset);
+      auto chunk = error_chunks[number].load(std::memory_order_relaxed);
+      if (!chunk) {
+        chunk = new (std::nothrow) ice::error[error_chunk_size << number];
+        if (chunk) {
+          error_chunks[number].store(chunk, std::memory_order_release);
+        }
+      }
+      if (chunk) {
+        chunk[offset] = e;
+        error_indices::insert(e.type(), e.code(), index);
+        error_chunk_index++;
+        return index;
+      }
+      reason = "out of memory";
+    }
+  }
+
+  // Formatting the error can cache its message, which locks the error mutex.
+  ICE_TRACE_WARNING(ice::trace_common, "Could not store error {}: {}", e, reason);
+  return error_index(ice::errc::unknown);
+}
+
+ice::error error_load(std::uint32_t index) noexcept
+{
+  if (index < error_chunk_limit) {
+    std::size_t offset = 0;
+    if (const auto chunk = error_chunks[error_chunk(index, offset)].load(std::memory_order_acquire)) {
+      return chunk[offset];
+    }
+  }
+  return ice::errc::unknown;
+}
+
+}  // namespace detail
+
 std::string error_info::format(int code) noexcept
 {
   return fmt::format("error code {:08X}", static_cast<unsigned>(code));
 }
 
 }  // namespace ice
+
+namespace ice::system {
+
+ice::error_info make_error_info(errc) noexcept
+{
+  return { "system", system_text };
+}
+
+}  // namespace ice::system
+
+namespace std {
+
+ice::error_info make_error_info(std::errc) noexcept
+{
+  return { "generic", ice::generic_text };
+}
+
+}  // namespace std
@@ -1,5 +1,6 @@
 #pragma once
 #include <ice/config.hpp>
+#include <array>
 #include <compare>
 #include <concepts>
 #include <string>
@@ -146,23 +147,187 @@ constexpr ice::error_code<T> make_error_code(U code) noexcept
 // error info
 // ================================================================================================
 
+// Names and texts of error types.
+// Text providers return views into static storage or into texts that were stored with the cache function, which
+// makes formatting errors free of allocations. An empty view means that the code has no text.
+
 struct error_info {
   const char* name{ nullptr };
-  std::string (*text)(int code){ nullptr };
+  std::string_view (*text)(int code){ nullptr };
 
   ICE_API static void set(ice::error_type type, const char* name) noexcept;
-  ICE_API static void set(ice::error_type type, std::string (*text)(int code)) noexcept;
+  ICE_API static void set(ice::error_type type, std::string_view (*text)(int code)) noexcept;
 
   ICE_API static const char* get(ice::error_type type) noexcept;
   ICE_API static std::string get(ice::error_type type, int code) noexcept;
 
+  // Returns the text of the code or an empty view if the type has no text for the code.
+  ICE_API static std::string_view message(ice::error_type type, int code) noexcept;
+
+  // Returns the text of the code that was stored by a previous call or stores the result of the text function.
+  // The text function is called once per type and code. The returned view is valid until the program exits.
+  ICE_API static std::string_view cache(ice::error_type type, int code, std::string (*text)(int code)) noexcept;
+
   ICE_API static std::string format(int code) noexcept;
 };
 
-ICE_API ice::error_info make_error_info(ice::errc) noexcept;
+// ================================================================================================
+// error category
+// ================================================================================================
+
+// Compile-time name and texts of an error code type.
+// Codes from zero up to the first gap are looked up by index and the remaining codes with a binary search.
+// Declare a constexpr make_error_category function in the namespace of the type to use it instead of a
+// make_error_info function:
+//
+//   constexpr auto make_error_category(errc) noexcept
+//   {
+//     return ice::error_category{ "common", {
+//       { errc::success, "success" },
+//       { errc::failure, "failure" },
+//     } };
+//   }
+//
+// An optional fallback function provides texts for codes that are not in the table.
+
+struct error_text {
+  template <ErrorCodeType T>
+  constexpr error_text(T code, std::string_view text) noexcept
+    : code(static_cast<int>(code))
+    , text(text)
+  {}
+
+  int code{ 0 };
+  std::string_view text;
+};
+
+template <std::size_t N>
+class error_category {
+public:
+  consteval error_category(const char* name, const error_text (&texts)[N]) noexcept
+    : error_category(name, texts, nullptr)
+  {}
+
+  consteval error_category(
+    const char* name, const error_text (&texts)[N], std::string_view (*fallback)(int code)) noexcept
+    : name_(name)
+    , fallback_(fallback)
+  {
+    for (std::size_t i = 0; i < N; i++) {
+      auto j = i;
+      for (; j > 0 && codes_[j - 1] > texts[i].code; j--) {
+        codes_[j] = codes_[j - 1];
+        texts_[j] = texts_[j - 1];
+      }
+      codes_[j] = texts[i].code;
+      texts_[j] = texts[i].text;
+    }
+    while (zero_ < N && codes_[zero_] < 0) {
+      zero_++;
+    }
+    while (zero_ + dense_ < N && codes_[zero_ + dense_] == static_cast<int>(dense_)) {
+      dense_++;
+    }
+  }
+
+  constexpr const char* name() const noexcept
+  {
+    return name_;
+  }
+
+  // Returns the text of the code or an empty view if the code has no text.
+  constexpr std::string_view text(int code) const noexcept
+  {
+    if (code >= 0 && static_cast<std::size_t>(code) < dense_) {
+      return texts_[zero_ + static_cast<std::size_t>(code)];
+    }
+    std::size_t first = 0;
+    std::size_t last = N;
+    while (first < last) {
+      const auto middle = first + (last - first) / 2;
+      if (codes_[middle] < code) {
+        first = middle + 1;
+      } else {
+        last = middle;
+      }
+    }
+    if (first < N && codes_[first] == code) {
+      return texts_[first];
+    }
+    return fallback_ ? fallback_(code) : std::string_view{};
+  }
+
+  // Returns the number of codes that are looked up by index.
+  constexpr std::size_t dense() const noexcept
+  {
+    return dense_;
+  }
+
+private:
+  const char* name_{ nullptr };
+  std::string_view (*fallback_)(int code){ nullptr };
+  std::array<int, N> codes_{};
+  std::array<std::string_view, N> texts_{};
+  std::size_t zero_{ 0 };
+  std::size_t dense_{ 0 };
+};
+
+template <typename T>
+concept ErrorCategoryType = ErrorCodeType<T> && requires(T code)
+{
+  make_error_category(code);
+};
+
+namespace detail {
+
+template <ErrorCategoryType T>
+inline constexpr auto error_category = make_error_category(T{});
+
+template <ErrorCategoryType T>
+constexpr std::string_view error_category_text(int code) noexcept
+{
+  return error_category<T>.text(code);
+}
+
+}  // namespace detail
+
+template <ErrorCategoryType T>
+constexpr ice::error_info make_error_info(T) noexcept
+{
+  return { detail::error_category<T>.name(), detail::error_category_text<T> };
+}
+
+constexpr auto make_error_category(ice::errc) noexcept
+{
+  return ice::error_category{ "common", {
+    { ice::errc::success, "success" },
+    { ice::errc::not_available, "not available" },
+    { ice::errc::not_implemented, "not implemented" },
+    { ice::errc::not_initialized, "not initialized" },
+    { ice::errc::context_not_empty, "context not empty" },
+    { ice::errc::invalid_result_value, "invalid result value" },
+    { ice::errc::unicode_buffer_too_small, "unicode buffer too small" },
+    { ice::errc::unicode_incomplete_sequence, "unicode incomplete sequence" },
+    { ice::errc::unicode_invalid_code_point, "unicode invalid code point" },
+    { ice::errc::unicode_invalid_lead, "unicode invalid lead" },
+    { ice::errc::unicode_invalid_options, "unicode invalid options" },
+    { ice::errc::unicode_invalid_utf8, "unicode invalid utf8" },
+    { ice::errc::unicode_not_enough_memory, "unicode not enough memory" },
+    { ice::errc::unicode_overlong_sequence, "unicode overlong sequence" },
+    { ice::errc::unicode_unassigned, "unicode unassigned" },
+    { ice::errc::broken_promise, "broken promise" },
+    { ice::errc::unknown, "unknown" },
+  } };
+}
 
 }  // namespace ice
 
+namespace ice::system {
+
+ICE_API ice::error_info make_error_info(errc) noexcept;
+
+}  // namespace ice::system
+
 namespace std {
 
 ICE_API ice::error_info make_error_info(std::errc) noexcept;
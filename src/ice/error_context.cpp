@@ -0,0 +1,94 @@
+#include "error_context.hpp"
+#include <array>
+#include <cstring>
+
+namespace ice {
+namespace {
+
+// Entries of the current chain of a thread. Notes are copied to a shared buffer and entries past the capacity or
+// notes that do not fit are dropped.
+struct error_context_arena {
+  struct record {
+    std::source_location location;
+    std::uint16_t offset{ 0 };
+    std::uint16_t size{ 0 };
+  };
+
+  ice::error error;
+  bool closed{ false };
+  std::uint32_t generation{ 1 };
+  std::uint32_t size{ 0 };
+  std::size_t used{ 0 };
+  std::array<record, error_context::capacity> records;
+  std::array<char, error_context::capacity * 64> notes;
+
+  void reset(ice::error e) noexcept
+  {
+    error = e;
+    closed = false;
+    generation++;
+    size = 0;
+    used = 0;
+  }
+
+  void append(const std::source_location& location, std::string_view note) noexcept
+  {
+    if (size == records.size()) {
+      return;
+    }
+    auto& record = records[size++];
+    record.location = location;
+    record.offset = static_cast<std::uint16_t>(used);
+    record.size = static_cast<std::uint16_t>(std::min(note.size(), notes.size() - used));
+    std::memcpy(notes.data() + used, note.data(), record.size);
+    used += record.size;
+  }
+};
+
+thread_local error_context_arena arena;
+
+}  // namespace
+
+ice::error error_context::make(ice::error e, std::source_location location, std::string_view note) noexcept
+{
+  arena.reset(e);
+  arena.append(location, note);
+  return e;
+}
+
+ice::error error_context::attach(ice::error e, std::source_location location, std::string_view note) noexcept
+{
+  if (arena.closed || arena.error != e || !arena.size) {
+    arena.reset(e);
+  }
+  arena.append(location, note);
+  return e;
+}
+
+error_context error_context::get(ice::error e) noexcept
+{
+  if (!e || arena.error != e) {
+    return {};
+  }
+  arena.closed = true;
+  return { arena.generation, arena.size };
+}
+
+void error_context::clear() noexcept
+{
+  arena.reset({});
+}
+
+std::size_t error_context::size() const noexcept
+{
+  return generation_ == arena.generation ? size_ : 0;
+}
+
+error_context::entry error_context::operator[](std::size_t index) const noexcept
+{
+  ICE_ASSERT(index < size());
+  const auto& record = arena.records[index];
+  return { record.location, { arena.notes.data() + record.offset, record.size } };
+}
+
+}  // namespace ice
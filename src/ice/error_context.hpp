@@ -0,0 +1,147 @@
+#pragma once
+#include <ice/format.hpp>
+#include <algorithm>
+#include <source_location>
+#include <string_view>
+#include <utility>
+#include <cstddef>
+#include <cstdint>
+
+namespace ice {
+
+// ================================================================================================
+// error context
+// ================================================================================================
+
+// Source locations and short notes that were attached to the last error of the calling thread while it was
+// propagated, starting with the location where it was created.
+// Entries are stored in a fixed thread-local arena and ice::error stays a type and a code, so nothing is recorded or
+// allocated until an error exists. An error starts a new chain when it was created with ICE_ERROR_CONTEXT or when it
+// is not the error of the current chain. Because errors are only compared by type and code, a chain is closed when it
+// is read with get, and a later error with the same type and code starts a new chain instead of extending it. The
+// success path of ICE_TRY_CONTEXT does not touch the chain. Chains are not passed between threads and entries past
+// the capacity of the arena are dropped.
+//
+// A context is a small handle to the chain of the calling thread. It becomes empty when a new chain is started or
+// the chain is cleared, and must not be used on other threads.
+
+class ICE_API error_context {
+public:
+  static constexpr std::size_t capacity = 32;
+  static constexpr std::size_t note_size = 120;
+
+  struct entry {
+    std::source_location location;
+    std::string_view note;
+  };
+
+  // Starts a new chain for the error.
+  static ice::error make(ice::error e, std::source_location location, std::string_view note = {}) noexcept;
+
+  template <typename S, typename Arg, typename... Args>
+  static ice::error make(ice::error e, std::source_location location, const S& format, Arg&& arg,
+    Args&&... args) noexcept
+  {
+    note_buffer note;
+    return make(e, location, note.format(format, std::forward<Arg>(arg), std::forward<Args>(args)...));
+  }
+
+  // Adds an entry to the chain of the error or starts a new chain if the error is not the error of the chain.
+  static ice::error attach(ice::error e, std::source_location location, std::string_view note = {}) noexcept;
+
+  template <typename S, typename Arg, typename... Args>
+  static ice::error attach(ice::error e, std::source_location location, const S& format, Arg&& arg,
+    Args&&... args) noexcept
+  {
+    note_buffer note;
+    return attach(e, location, note.format(format, std::forward<Arg>(arg), std::forward<Args>(args)...));
+  }
+
+  // Returns the chain of the error or an empty context if the error is not the error of the current chain and closes
+  // the chain, so that the next attached error starts a new one. The chain can belong to an earlier error with the
+  // same type and code if that error was never read and this one was never attached.
+  static error_context get(ice::error e) noexcept;
+
+  // Discards the current chain. Call it after handling an error without reading its chain.
+  static void clear() noexcept;
+
+  constexpr error_context() noexcept = default;
+
+  std::size_t size() const noexcept;
+
+  bool empty() const noexcept
+  {
+    return size() == 0;
+  }
+
+  // Returns an entry by index, starting with the location where the error was created.
+  entry operator[](std::size_t index) const noexcept;
+
+private:
+  struct note_buffer {
+    template <typename S, typename... Args>
+    std::string_view format(const S& format, Args&&... args) noexcept
+    {
+      const auto result = fmt::format_to_n(data, note_size, format, std::forward<Args>(args)...);
+      return { data, std::min(result.size, note_size) };
+    }
+
+    char data[note_size];
+  };
+
+  constexpr error_context(std::uint32_t generation, std::uint32_t size) noexcept
+    : generation_(generation)
+    , size_(size)
+  {}
+
+  std::uint32_t generation_{ 0 };
+  std::uint32_t size_{ 0 };
+};
+
+namespace detail {
+
+// A context refers to the arena of the calling thread and is formatted by it.
+template <>
+struct logger_thread_argument<ice::error_context> : std::true_type {};
+
+}  // namespace detail
+
+}  // namespace ice
+
+// Returns the error from the current function and attaches the location and a note if the expression failed.
+// The note is a format string followed by its arguments.
+#define ICE_TRY_CONTEXT(expression, ...)                                                            \
+  if (const auto ice_try_error = ice::detail::result_error(expression);                             \
+      ICE_UNLIKELY(static_cast<bool>(ice_try_error))) {                                             \
+    return ice::error_context::attach(ice_try_error, std::source_location::current(), __VA_ARGS__); \
+  }                                                                                                 \
+  static_cast<void>(0)
+
+// Creates an error with a new chain that starts with the location and a note.
+#define ICE_ERROR_CONTEXT(value, ...) \
+  ice::error_context::make(ice::error(value), std::source_location::current(), __VA_ARGS__)
+
+template <>
+struct fmt::formatter<ice::error_context> {
+  constexpr auto parse(format_parse_context& context)
+  {
+    return context.begin();
+  }
+
+  // Writes one line per entry with the file, line, function and note.
+  template <typename FormatContext>
+  auto format(const ice::error_context& errors, FormatContext& context)
+  {
+    auto out = context.out();
+    for (std::size_t i = 0, size = errors.size(); i < size; i++) {
+      const auto entry = errors[i];
+      out = fmt::format_to(out, "  {}:{} {}", entry.location.file_name(), entry.location.line(),
+        entry.location.function_name());
+      if (!entry.note.empty()) {
+        out = fmt::format_to(out, ": {}", entry.note);
+      }
+      *out++ = '\n';
+    }
+    return out;
+  }
+};
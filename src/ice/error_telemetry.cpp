@@ -0,0 +1,199 @@
+#include "error_telemetry.hpp"
+#include <ice/format.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace ice {
+namespace {
+
+using clock = std::chrono::steady_clock;
+
+// Counters of a thread. Only the owning thread inserts keys and increments counts.
+// Keys are published with release stores after the count was set, so that snapshots never see a key without its
+// first count.
+struct error_counters {
+  struct slot {
+    std::atomic<std::uint64_t> key{ 0 };
+    std::atomic<std::uint64_t> count{ 0 };
+  };
+
+  static constexpr std::size_t size = 256;
+
+  static constexpr std::size_t hash(std::uint64_t key) noexcept
+  {
+    return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> 56);
+  }
+
+  void add(std::uint64_t key) noexcept
+  {
+    for (std::size_t i = 0, index = hash(key); i < size; i++, index = (index + 1) % size) {
+      auto& slot = slots[index];
+      const auto current = slot.key.load(std::memory_order_relaxed);
+      if (current == key) {
+        slot.count.store(slot.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+      }
+      if (!current) {
+        slot.count.store(1, std::memory_order_relaxed);
+        slot.key.store(key, std::memory_order_release);
+        return;
+      }
+    }
+    dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  std::array<slot, size> slots;
+  std::atomic<std::uint64_t> dropped{ 0 };
+};
+
+const auto error_telemetry_start = clock::now();
+
+std::mutex error_telemetry_mutex;
+std::vector<const error_counters*> error_telemetry_threads;
+std::map<std::uint64_t, std::uint64_t> error_telemetry_retired;
+std::uint64_t error_telemetry_dropped{ 0 };
+
+// Adds the counters to the map. Must be called while holding the mutex.
+std::uint64_t merge(const error_counters& counters, std::map<std::uint64_t, std::uint64_t>& counts) noexcept
+{
+  for (const auto& slot : counters.slots) {
+    if (const auto key = slot.key.load(std::memory_order_acquire)) {
+      counts[key] += slot.count.load(std::memory_order_relaxed);
+    }
+  }
+  return counters.dropped.load(std::memory_order_relaxed);
+}
+
+// Registers the counters of a thread on the first error and merges them into the retired counts when it exits.
+class error_thread {
+public:
+  error_thread() noexcept = default;
+  error_thread(error_thread&& other) = delete;
+  error_thread(const error_thread& other) = delete;
+  error_thread& operator=(error_thread&& other) = delete;
+  error_thread& operator=(const error_thread& other) = delete;
+
+  ~error_thread()
+  {
+    if (counters_) {
+      std::lock_guard lock{ error_telemetry_mutex };
+      error_telemetry_dropped += merge(*counters_, error_telemetry_retired);
+      std::erase(error_telemetry_threads, counters_.get());
+    }
+  }
+
+  error_counters& counters() noexcept
+  {
+    if (ICE_UNLIKELY(!counters_)) {
+      counters_ = std::make_unique<error_counters>();
+      std::lock_guard lock{ error_telemetry_mutex };
+      error_telemetry_threads.push_back(counters_.get());
+    }
+    return *counters_;
+  }
+
+private:
+  std::unique_ptr<error_counters> counters_;
+};
+
+thread_local error_thread error_telemetry_thread;
+
+// Writes a JSON string with quotes and escape sequences.
+void json_string(fmt::memory_buffer& buffer, std::string_view text) noexcept
+{
+  buffer.push_back('"');
+  for (const auto c : text) {
+    if (c == '"' || c == '\\') {
+      buffer.push_back('\\');
+      buffer.push_back(c);
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      fmt::format_to(buffer, "\\u{:04x}", static_cast<unsigned>(c));
+    } else {
+      buffer.push_back(c);
+    }
+  }
+  buffer.push_back('"');
+}
+
+double seconds(clock::duration duration) noexcept
+{
+  return std::chrono::duration<double>(duration).count();
+}
+
+double rate(std::uint64_t count, clock::duration duration) noexcept
+{
+  const auto s = seconds(duration);
+  return s > 0.0 ? static_cast<double>(count) / s : 0.0;
+}
+
+}  // namespace
+
+namespace detail {
+
+void error_count(ice::error_type type, int code) noexcept
+{
+  const auto key = static_cast<std::uint64_t>(type) << 32 | static_cast<std::uint32_t>(code);
+  error_telemetry_thread.counters().add(key);
+}
+
+}  // namespace detail
+
+error_telemetry::snapshot error_telemetry::get() noexcept
+{
+  snapshot snapshot;
+  std::map<std::uint64_t, std::uint64_t> counts;
+  {
+    std::lock_guard lock{ error_telemetry_mutex };
+    counts = error_telemetry_retired;
+    snapshot.dropped = error_telemetry_dropped;
+    for (const auto counters : error_telemetry_threads) {
+      snapshot.dropped += merge(*counters, counts);
+    }
+  }
+  snapshot.duration = clock::now() - error_telemetry_start;
+  snapshot.entries.reserve(counts.size());
+  for (const auto& [key, count] : counts) {
+    const auto type = static_cast<ice::error_type>(key >> 32);
+    const auto code = static_cast<int>(static_cast<std::uint32_t>(key));
+    snapshot.entries.push_back({ type, code, count });
+  }
+  return snapshot;
+}
+
+std::string error_telemetry::text(const snapshot& snapshot) noexcept
+{
+  fmt::memory_buffer buffer;
+  fmt::format_to(buffer, "errors in {:.3f} s\n", seconds(snapshot.duration));
+  for (const auto& entry : snapshot.entries) {
+    const auto e = ice::make_error(entry.type, entry.code);
+    fmt::format_to(buffer, "  {} {} {}: {} ({:.3f}/s)\n", entry.type, entry.code, e, entry.count,
+      rate(entry.count, snapshot.duration));
+  }
+  if (snapshot.dropped) {
+    fmt::format_to(buffer, "  dropped: {}\n", snapshot.dropped);
+  }
+  return fmt::to_string(buffer);
+}
+
+std::string error_telemetry::json(const snapshot& snapshot) noexcept
+{
+  fmt::memory_buffer buffer;
+  fmt::format_to(buffer, "{{\"seconds\":{:.3f},\"dropped\":{},\"errors\":[", seconds(snapshot.duration),
+    snapshot.dropped);
+  for (std::size_t i = 0; i < snapshot.entries.size(); i++) {
+    const auto& entry = snapshot.entries[i];
+    fmt::format_to(buffer, "{}{{\"type\":", i ? "," : "");
+    json_string(buffer, fmt::format("{}", entry.type));
+    fmt::format_to(buffer, ",\"code\":{},\"message\":", entry.code);
+    json_string(buffer, fmt::format("{}", ice::make_error(entry.type, entry.code)));
+    fmt::format_to(buffer, ",\"count\":{},\"rate\":{:.3f}}}", entry.count, rate(entry.count, snapshot.duration));
+  }
+  fmt::format_to(buffer, "]}}");
+  return fmt::to_string(buffer);
+}
+
+}  // namespace ice
@@ -0,0 +1,48 @@
+#pragma once
+#include <ice/error.hpp>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace ice {
+
+// ================================================================================================
+// error telemetry
+// ================================================================================================
+
+// Number of errors by type and code that were created from error codes since the process started.
+// Errors are only counted when the library and its users are compiled with ICE_ERROR_TELEMETRY enabled. Otherwise
+// the error constructors are unchanged and snapshots are empty. Errors that are copied, propagated, compared or
+// created in constant expressions are not counted.
+//
+// Each thread counts in its own open addressing table with relaxed loads and stores instead of atomic
+// read-modify-write operations. A snapshot merges the tables of the running threads with the counts of the threads
+// that exited. Errors that do not fit in the table of a thread are counted as dropped.
+
+class ICE_API error_telemetry {
+public:
+  struct entry {
+    ice::error_type type{ ice::error_type::success };
+    int code{ 0 };
+    std::uint64_t count{ 0 };
+  };
+
+  struct snapshot {
+    // Entries sorted by type and code.
+    std::vector<entry> entries;
+    std::uint64_t dropped{ 0 };
+    std::chrono::steady_clock::duration duration{};
+  };
+
+  // Merges the counters of all threads.
+  static snapshot get() noexcept;
+
+  // Writes one line per entry with the type, code, message, count and rate per second.
+  static std::string text(const snapshot& snapshot) noexcept;
+
+  // Writes an object with the duration in seconds, the number of dropped errors and an array of entries.
+  static std::string json(const snapshot& snapshot) noexcept;
+};
+
+}  // namespace ice
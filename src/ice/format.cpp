@@ -1,20 +1,12 @@
 #include "format.hpp"
-#include <mutex>
 
 #ifdef _WIN32
 #  include <windows.h>
 #endif
 
 namespace ice {
-namespace {
 
-std::mutex& trace_mutex() noexcept
-{
-  static std::mutex mutex;
-  return mutex;
-}
-
-}  // namespace
+trace_category trace_common{ "common" };
 
 std::string tr(std::string_view text) noexcept
 {
@@ -23,18 +15,17 @@ std::string tr(std::string_view text) noexcept
 
 void trace(std::string text, const char* function) noexcept
 {
-  const auto s = [&]() {
-    if (text.empty()) {
-      return std::string{ function } + '\n';
-    }
-    return fmt::format("{}: {}\n", function, text);
-  }();
-  std::lock_guard lock{ trace_mutex() };
-  std::fputs(s.data(), stderr);
-  std::fflush(stderr);
+  fmt::memory_buffer buffer;
+  if (text.empty()) {
+    fmt::format_to(buffer, "{}\n", function);
+  } else {
+    fmt::format_to(buffer, "{}: {}\n", function, text);
+  }
+  ice::logger::write({ buffer.data(), buffer.size() });
 #ifdef _WIN32
   if (IsDebuggerPresent()) {
-    OutputDebugString(s.data());
+    buffer.push_back('\0');
+    OutputDebugString(buffer.data());
   }
 #endif
 }
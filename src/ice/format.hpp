@@ -1,19 +1,164 @@
 #pragma once
+#include <ice/logger.hpp>
 #include <ice/result.hpp>
 #include <fmt/format.h>
+#include <atomic>
+#include <chrono>
 #include <filesystem>
 #include <string>
 #include <string_view>
+#include <cstdint>
 
 namespace ice {
 
 ICE_API std::string tr(std::string_view text) noexcept;
 ICE_API void trace(std::string text, const char* function) noexcept;
 
+// ================================================================================================
+// trace_category
+// ================================================================================================
+
+enum class trace_level {
+  debug = ICE_TRACE_LEVEL_DEBUG,
+  info = ICE_TRACE_LEVEL_INFO,
+  warning = ICE_TRACE_LEVEL_WARNING,
+  error = ICE_TRACE_LEVEL_ERROR,
+  none = ICE_TRACE_LEVEL_NONE,
+};
+
+// Enables trace sites at or above a level at runtime.
+// Trace sites load the level with a relaxed atomic load before their arguments are evaluated. Categories should be
+// defined at namespace scope, so that they are initialized before any trace site runs.
+
+class trace_category {
+public:
+  constexpr trace_category(const char* name, trace_level level = trace_level::info) noexcept :
+    name_(name), level_(static_cast<int>(level))
+  {}
+
+  trace_category(trace_category&& other) = delete;
+  trace_category(const trace_category& other) = delete;
+  trace_category& operator=(trace_category&& other) = delete;
+  trace_category& operator=(const trace_category& other) = delete;
+
+  ~trace_category() = default;
+
+  constexpr const char* name() const noexcept
+  {
+    return name_;
+  }
+
+  trace_level level() const noexcept
+  {
+    return static_cast<trace_level>(level_.load(std::memory_order_relaxed));
+  }
+
+  // Sets the lowest enabled level. Use trace_level::none to disable the category.
+  void set(trace_level level) noexcept
+  {
+    level_.store(static_cast<int>(level), std::memory_order_relaxed);
+  }
+
+  bool enabled(trace_level level) const noexcept
+  {
+    return static_cast<int>(level) >= level_.load(std::memory_order_relaxed);
+  }
+
+private:
+  const char* name_;
+  std::atomic<int> level_;
+};
+
+// Category of ICE_TRACE_FORMAT and ICE_TRACE_FUNCTION.
+ICE_API extern trace_category trace_common;
+
+// ================================================================================================
+// trace_limit
+// ================================================================================================
+
+// Lets a trace site pass at most once per interval from all threads.
+
+class trace_limit {
+public:
+  constexpr trace_limit() noexcept = default;
+
+  trace_limit(trace_limit&& other) = delete;
+  trace_limit(const trace_limit& other) = delete;
+  trace_limit& operator=(trace_limit&& other) = delete;
+  trace_limit& operator=(const trace_limit& other) = delete;
+
+  ~trace_limit() = default;
+
+  template <typename Rep, typename Period>
+  bool operator()(std::chrono::duration<Rep, Period> interval) noexcept
+  {
+    const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch());
+    auto next = next_.load(std::memory_order_relaxed);
+    if (now.count() < next) {
+      return false;
+    }
+    const auto step = std::chrono::duration_cast<std::chrono::nanoseconds>(interval);
+    return next_.compare_exchange_strong(next, (now + step).count(), std::memory_order_relaxed);
+  }
+
+private:
+  std::atomic<std::int64_t> next_{ 0 };
+};
+
 }  // namespace ice
 
-#define ICE_TRACE_FORMAT(...) ice::trace(fmt::format(__VA_ARGS__), ICE_FUNCTION)
-#define ICE_TRACE_FUNCTION ice::trace({}, ICE_FUNCTION)
+// Writes a trace line without checking the level.
+#if ICE_TRACE_BINARY
+#  define ICE_TRACE_WRITE(...) ice::logger::write(ICE_FUNCTION, __VA_ARGS__)
+#else
+#  define ICE_TRACE_WRITE(...) ice::trace(fmt::format(__VA_ARGS__), ICE_FUNCTION)
+#endif
+
+// Writes a trace line when the level is not below ICE_TRACE_LEVEL and is enabled in the category.
+// Sites below ICE_TRACE_LEVEL compile to nothing and the arguments are only evaluated when the line is written.
+#define ICE_TRACE(category, level, ...)                         \
+  do {                                                          \
+    if constexpr (static_cast<int>(level) >= ICE_TRACE_LEVEL) { \
+      if (ICE_UNLIKELY((category).enabled(level))) {            \
+        ICE_TRACE_WRITE(__VA_ARGS__);                           \
+      }                                                         \
+    }                                                           \
+  } while (false)
+
+// Writes every n-th enabled trace line of a site on each thread, starting with the first one.
+#define ICE_TRACE_SAMPLE(category, level, n, ...)               \
+  do {                                                          \
+    if constexpr (static_cast<int>(level) >= ICE_TRACE_LEVEL) { \
+      if (ICE_UNLIKELY((category).enabled(level))) {            \
+        static thread_local unsigned ice_trace_sample = 0;      \
+        if (ice_trace_sample++ % (n) == 0) {                    \
+          ICE_TRACE_WRITE(__VA_ARGS__);                         \
+        }                                                       \
+      }                                                         \
+    }                                                           \
+  } while (false)
+
+// Writes at most one enabled trace line of a site per interval, which is a std::chrono::duration.
+#define ICE_TRACE_LIMIT(category, level, interval, ...)         \
+  do {                                                          \
+    if constexpr (static_cast<int>(level) >= ICE_TRACE_LEVEL) { \
+      if (ICE_UNLIKELY((category).enabled(level))) {            \
+        static ice::trace_limit ice_trace_limit;                \
+        if (ice_trace_limit(interval)) {                        \
+          ICE_TRACE_WRITE(__VA_ARGS__);                         \
+        }                                                       \
+      }                                                         \
+    }                                                           \
+  } while (false)
+
+#define ICE_TRACE_DEBUG(category, ...) ICE_TRACE(category, ice::trace_level::debug, __VA_ARGS__)
+#define ICE_TRACE_INFO(category, ...) ICE_TRACE(category, ice::trace_level::info, __VA_ARGS__)
+#define ICE_TRACE_WARNING(category, ...) ICE_TRACE(category, ice::trace_level::warning, __VA_ARGS__)
+#define ICE_TRACE_ERROR(category, ...) ICE_TRACE(category, ice::trace_level::error, __VA_ARGS__)
+
+#define ICE_TRACE_FORMAT(...) ICE_TRACE_INFO(ice::trace_common, __VA_ARGS__)
+#define ICE_TRACE_FUNCTION ICE_TRACE_INFO(ice::trace_common, "")
 
 template <>
 struct fmt::formatter<ice::error_type> : fmt::formatter<string_view> {
@@ -34,8 +179,18 @@ struct fmt::formatter<ice::error_code<T>> : fmt::formatter<string_view> {
   template <typename FormatContext>
   auto format(const ice::error_code<T>& ec, FormatContext& context) noexcept
   {
-    const auto text = ice::error_info::get(ec.type(), ec.code());
-    return fmt::formatter<string_view>::format({ text.data(), text.size() }, context);
+    std::string_view text;
+    if constexpr (ice::ErrorCategoryType<T>) {
+      text = ice::detail::error_category<T>.text(ec.code());
+    } else {
+      text = ice::error_info::message(ec.type(), ec.code());
+    }
+    if (!text.empty()) {
+      return fmt::formatter<string_view>::format({ text.data(), text.size() }, context);
+    }
+    fmt::basic_memory_buffer<char, 16> code;
+    fmt::format_to(code, "{:08X}", static_cast<unsigned>(ec.code()));
+    return fmt::formatter<string_view>::format({ code.data(), code.size() }, context);
   }
 };
 
@@ -47,7 +202,11 @@ struct fmt::formatter<ice::error> : fmt::formatter<string_view> {
   template <typename FormatContext>
   auto format(const ice::error& e, FormatContext& context) noexcept
   {
-    const auto text = ice::error_info::get(e.type(), e.code());
+    if (const auto text = ice::error_info::message(e.type(), e.code()); !text.empty()) {
+      return fmt::formatter<string_view>::format({ text.data(), text.size() }, context);
+    }
+    fmt::basic_memory_buffer<char, 16> text;
+    fmt::format_to(text, "{:08X}", static_cast<unsigned>(e.code()));
     return fmt::formatter<string_view>::format({ text.data(), text.size() }, context);
   }
 };
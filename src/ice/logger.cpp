@@ -0,0 +1,441 @@
+#include "logger.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <cstring>
+
+#ifndef _WIN32
+#  include <sys/uio.h>
+#  include <cerrno>
+#endif
+
+namespace ice {
+namespace {
+
+#ifdef _WIN32
+struct iovec {
+  void* iov_base;
+  std::size_t iov_len;
+};
+#endif
+
+// The logger is started by the first line and stopped when the process exits.
+enum class logger_state {
+  stopped,
+  running,
+  exited,
+};
+
+std::atomic<logger_state> logger_state_value{ logger_state::stopped };
+std::atomic<logger::overflow> logger_overflow{ logger::overflow::block };
+std::atomic<std::FILE*> logger_file{ nullptr };
+std::atomic<std::uint64_t> logger_dropped{ 0 };
+
+std::FILE* logger_output() noexcept
+{
+  const auto file = logger_file.load(std::memory_order_acquire);
+  return file ? file : stderr;
+}
+
+// Writes all data and retries partial writes.
+void logger_write(std::FILE* file, iovec* iov, int count) noexcept
+{
+#ifdef _WIN32
+  for (int i = 0; i < count; i++) {
+    std::fwrite(iov[i].iov_base, 1, iov[i].iov_len, file);
+  }
+  std::fflush(file);
+#else
+  std::fflush(file);
+  const auto fd = fileno(file);
+  while (count > 0) {
+    const auto size = ::writev(fd, iov, count);
+    if (size < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return;
+    }
+    auto written = static_cast<std::size_t>(size);
+    while (count > 0 && written >= iov->iov_len) {
+      written -= iov->iov_len;
+      iov++;
+      count--;
+    }
+    if (count > 0) {
+      iov->iov_base = static_cast<char*>(iov->iov_base) + written;
+      iov->iov_len -= written;
+    }
+  }
+#endif
+}
+
+// Header of a record in a ring buffer. Records start at multiples of 8 bytes and do not wrap around the end of the
+// buffer. When a record does not fit before the end, the rest of the buffer is filled with a padding record.
+struct logger_record {
+  enum class kind : std::uint32_t {
+    padding,
+    text,
+    binary,
+  };
+
+  static constexpr std::size_t align(std::size_t size) noexcept
+  {
+    return (size + 7) & ~std::size_t(7);
+  }
+
+  std::uint32_t size;
+  enum kind kind;
+};
+
+static_assert(sizeof(logger_record) == logger::buffer_size - logger::line_size);
+
+struct logger_binary {
+  logger::format_function function_format;
+  const char* function;
+  const char* format;
+  std::int64_t time;
+};
+
+// Ring buffer of a thread. Only the owning thread writes records and advances the head, and only threads that hold
+// the mutex of the drainer advance the tail.
+struct logger_buffer {
+  // Returns the memory for a record of the given size and sets next to the head after the record, or returns null
+  // if the record was dropped. Waits for the background thread if the buffer is full and the policy is to block.
+  char* reserve(std::size_t size, std::uint64_t& next) noexcept;
+
+  // Waits until the buffer has room up to the given end or returns false if the record was dropped.
+  bool wait(std::uint64_t end) noexcept;
+
+  alignas(64) std::atomic<std::uint64_t> head{ 0 };
+  alignas(64) std::atomic<std::uint64_t> tail{ 0 };
+  std::atomic<bool> closed{ false };
+  alignas(8) std::array<char, logger::buffer_size> data;
+};
+
+const auto logger_start = std::chrono::steady_clock::now();
+
+// Owns the buffers and the background thread.
+class logger_drainer {
+public:
+  logger_drainer() noexcept = default;
+  logger_drainer(logger_drainer&& other) = delete;
+  logger_drainer(const logger_drainer& other) = delete;
+  logger_drainer& operator=(logger_drainer&& other) = delete;
+  logger_drainer& operator=(const logger_drainer& other) = delete;
+
+  ~logger_drainer()
+  {
+    stop_.store(true, std::memory_order_release);
+    notify();
+    if (thread_.joinable()) {
+      thread_.join();
+    }
+    logger_state_value.store(logger_state::exited, std::memory_order_release);
+    drain();
+  }
+
+  // Returns a new buffer for the calling thread or null if the process exits.
+  logger_buffer* attach() noexcept
+  {
+    auto buffer = std::make_unique<logger_buffer>();
+    std::lock_guard lock{ mutex_ };
+    if (logger_state_value.load(std::memory_order_acquire) == logger_state::exited) {
+      return nullptr;
+    }
+    if (!thread_.joinable()) {
+      thread_ = std::thread([this]() {
+        run();
+      });
+      logger_state_value.store(logger_state::running, std::memory_order_release);
+    }
+    buffers_.push_back(std::move(buffer));
+    return buffers_.back().get();
+  }
+
+  // Wakes up the background thread unless it was already woken up.
+  // The fence orders the store of the head before the load of the flag and pairs with the fence in run(), so that
+  // either this thread sees the cleared flag or the background thread sees the head.
+  void notify() noexcept
+  {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!pending_.load(std::memory_order_relaxed) && !pending_.exchange(true, std::memory_order_acq_rel)) {
+      pending_.notify_one();
+    }
+  }
+
+  // Formats the binary records of all buffers and writes the lines with one writev call per batch of lines.
+  void drain() noexcept
+  {
+    std::lock_guard lock{ mutex_ };
+    text_.clear();
+    lines_.clear();
+    done_.clear();
+    for (const auto& buffer : buffers_) {
+      const auto head = buffer->head.load(std::memory_order_acquire);
+      auto tail = buffer->tail.load(std::memory_order_relaxed);
+      if (head == tail) {
+        continue;
+      }
+      while (tail != head) {
+        const auto data = buffer->data.data() + tail % logger::buffer_size;
+        logger_record record;
+        std::memcpy(&record, data, sizeof(record));
+        if (record.kind == logger_record::kind::text) {
+          lines_.push_back({ data + sizeof(record), 0, record.size - sizeof(record) });
+        } else if (record.kind == logger_record::kind::binary) {
+          format(data + sizeof(record));
+        }
+        tail += record.kind == logger_record::kind::padding ? record.size : logger_record::align(record.size);
+      }
+      done_.push_back({ buffer.get(), head });
+    }
+    write();
+    for (const auto& [buffer, head] : done_) {
+      buffer->tail.store(head, std::memory_order_release);
+      buffer->tail.notify_all();
+    }
+    std::erase_if(buffers_, [](const std::unique_ptr<logger_buffer>& buffer) {
+      return buffer->closed.load(std::memory_order_acquire) &&
+        buffer->head.load(std::memory_order_acquire) == buffer->tail.load(std::memory_order_relaxed);
+    });
+  }
+
+private:
+  // Line in a ring buffer or at an offset in the formatted text if data is null.
+  struct line {
+    const char* data;
+    std::size_t offset;
+    std::size_t size;
+  };
+
+  void run() noexcept
+  {
+    while (!stop_.load(std::memory_order_acquire)) {
+      pending_.wait(false, std::memory_order_acquire);
+      pending_.exchange(false, std::memory_order_seq_cst);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      drain();
+    }
+  }
+
+  void format(const char* data) noexcept
+  {
+    logger_binary binary;
+    std::memcpy(&binary, data, sizeof(binary));
+    const auto offset = text_.size();
+    const auto microseconds = binary.time / 1000;
+    fmt::format_to(text_, "[{}.{:06}] {}", microseconds / 1000000, microseconds % 1000000, binary.function);
+    if (*binary.format) {
+      fmt::format_to(text_, ": ");
+      binary.function_format(text_, binary.format, data + sizeof(binary));
+    }
+    text_.push_back('\n');
+    if (!lines_.empty() && !lines_.back().data && lines_.back().offset + lines_.back().size == offset) {
+      lines_.back().size += text_.size() - offset;
+    } else {
+      lines_.push_back({ nullptr, offset, text_.size() - offset });
+    }
+  }
+
+  void write() noexcept
+  {
+    constexpr std::size_t batch = 64;
+    const auto file = logger_output();
+    for (std::size_t i = 0; i < lines_.size(); i += batch) {
+      std::array<iovec, batch> iov;
+      int count = 0;
+      for (std::size_t j = i; j < std::min(i + batch, lines_.size()); j++) {
+        const auto& line = lines_[j];
+        const auto data = line.data ? line.data : text_.data() + line.offset;
+        iov[count++] = { const_cast<char*>(data), line.size };
+      }
+      logger_write(file, iov.data(), count);
+    }
+  }
+
+  std::mutex mutex_;
+  std::thread thread_;
+  std::atomic_bool stop_{ false };
+  std::atomic_bool pending_{ false };
+  std::vector<std::unique_ptr<logger_buffer>> buffers_;
+  fmt::memory_buffer text_;
+  std::vector<line> lines_;
+  std::vector<std::pair<logger_buffer*, std::uint64_t>> done_;
+};
+
+logger_drainer& drainer() noexcept
+{
+  static logger_drainer drainer;
+  return drainer;
+}
+
+// Closes the buffer of a thread when it exits. The buffer is freed after its lines were written.
+class logger_thread {
+public:
+  logger_thread() noexcept = default;
+  logger_thread(logger_thread&& other) = delete;
+  logger_thread(const logger_thread& other) = delete;
+  logger_thread& operator=(logger_thread&& other) = delete;
+  logger_thread& operator=(const logger_thread& other) = delete;
+
+  ~logger_thread()
+  {
+    if (buffer_ && logger_state_value.load(std::memory_order_acquire) == logger_state::running) {
+      buffer_->closed.store(true, std::memory_order_release);
+      drainer().notify();
+    }
+  }
+
+  logger_buffer* buffer() noexcept
+  {
+    if (ICE_UNLIKELY(!buffer_)) {
+      buffer_ = drainer().attach();
+    }
+    return buffer_;
+  }
+
+  // Head after the last reserved record.
+  std::uint64_t next{ 0 };
+
+private:
+  logger_buffer* buffer_{ nullptr };
+};
+
+thread_local logger_thread logger_thread_local;
+
+bool logger_buffer::wait(std::uint64_t end) noexcept
+{
+  while (true) {
+    const auto last = tail.load(std::memory_order_acquire);
+    if (end - last <= logger::buffer_size) {
+      return true;
+    }
+    if (logger_overflow.load(std::memory_order_relaxed) == logger::overflow::drop ||
+        logger_state_value.load(std::memory_order_acquire) != logger_state::running) {
+      logger_dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    drainer().notify();
+    tail.wait(last, std::memory_order_acquire);
+  }
+}
+
+char* logger_buffer::reserve(std::size_t size, std::uint64_t& next) noexcept
+{
+  const auto total = logger_record::align(size);
+  auto position = head.load(std::memory_order_relaxed);
+  const auto end = logger::buffer_size - position % logger::buffer_size;
+  auto padding = end < total ? end : 0;
+  if (padding + total > logger::buffer_size) {
+    // The record needs most of the buffer and cannot be reserved together with the padding, so the padding is
+    // published first and the record is reserved after the background thread skipped it.
+    if (!wait(position + padding)) {
+      return nullptr;
+    }
+    const logger_record record{ static_cast<std::uint32_t>(padding), logger_record::kind::padding };
+    std::memcpy(data.data() + position % logger::buffer_size, &record, sizeof(record));
+    position += padding;
+    padding = 0;
+    head.store(position, std::memory_order_release);
+  }
+  if (!wait(position + padding + total)) {
+    return nullptr;
+  }
+  if (padding) {
+    const logger_record record{ static_cast<std::uint32_t>(padding), logger_record::kind::padding };
+    std::memcpy(data.data() + position % logger::buffer_size, &record, sizeof(record));
+    position += padding;
+  }
+  next = position + total;
+  return data.data() + position % logger::buffer_size;
+}
+
+}  // namespace
+
+void logger::set(overflow policy) noexcept
+{
+  logger_overflow.store(policy, std::memory_order_release);
+}
+
+void logger::set(std::FILE* file) noexcept
+{
+  logger_file.store(file, std::memory_order_release);
+}
+
+void logger::write(std::string_view line) noexcept
+{
+  const auto buffer = logger_state_value.load(std::memory_order_acquire) != logger_state::exited ?
+    logger_thread_local.buffer() :
+    nullptr;
+  if (!buffer) {
+    iovec iov{ const_cast<char*>(line.data()), line.size() };
+    logger_write(logger_output(), &iov, 1);
+    return;
+  }
+  const auto size = std::min(line.size(), line_size);
+  std::uint64_t next = 0;
+  const auto data = buffer->reserve(sizeof(logger_record) + size, next);
+  if (!data) {
+    return;
+  }
+  const logger_record record{ static_cast<std::uint32_t>(sizeof(logger_record) + size), logger_record::kind::text };
+  std::memcpy(data, &record, sizeof(record));
+  std::memcpy(data + sizeof(record), line.data(), size);
+  if (size < line.size()) {
+    data[sizeof(record) + size - 1] = '\n';
+  }
+  buffer->head.store(next, std::memory_order_release);
+  drainer().notify();
+}
+
+void logger::flush() noexcept
+{
+  if (logger_state_value.load(std::memory_order_acquire) == logger_state::running) {
+    drainer().drain();
+  }
+}
+
+std::uint64_t logger::dropped() noexcept
+{
+  return logger_dropped.load(std::memory_order_relaxed);
+}
+
+char* logger::reserve(format_function function_format, const char* function, const char* format,
+  std::size_t size) noexcept
+{
+  const auto buffer = logger_state_value.load(std::memory_order_acquire) != logger_state::exited ?
+    logger_thread_local.buffer() :
+    nullptr;
+  const auto record_size = sizeof(logger_record) + sizeof(logger_binary) + size;
+  if (!buffer || logger_record::align(record_size) > buffer_size) {
+    logger_dropped.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  const auto data = buffer->reserve(record_size, logger_thread_local.next);
+  if (!data) {
+    return nullptr;
+  }
+  const auto time = std::chrono::steady_clock::now() - logger_start;
+  const logger_record record{ static_cast<std::uint32_t>(record_size), logger_record::kind::binary };
+  const logger_binary binary{ function_format, function, format,
+    std::chrono::duration_cast<std::chrono::nanoseconds>(time).count() };
+  std::memcpy(data, &record, sizeof(record));
+  std::memcpy(data + sizeof(record), &binary, sizeof(binary));
+  return data + sizeof(record) + sizeof(binary);
+}
+
+void logger::commit() noexcept
+{
+  const auto buffer = logger_thread_local.buffer();
+  buffer->head.store(logger_thread_local.next, std::memory_order_release);
+  drainer().notify();
+}
+
+}  // namespace ice
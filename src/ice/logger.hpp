@@ -0,0 +1,179 @@
+#pragma once
+#include <ice/config.hpp>
+#include <fmt/format.h>
+#include <array>
+#include <bit>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace ice {
+namespace detail {
+
+template <typename T>
+concept LoggerString = std::is_convertible_v<const T&, std::string_view>;
+
+// Trivially copyable types that refer to state of the calling thread, which the background thread can not read.
+template <typename T>
+struct logger_thread_argument : std::false_type {};
+
+// clang-format off
+
+template <typename T>
+concept LoggerArgument = LoggerString<T> || (
+  std::is_trivially_copyable_v<T> && !std::is_array_v<T> && !logger_thread_argument<T>::value);
+
+// clang-format on
+
+// Copies an argument into a binary record and reads it back on the background thread.
+template <typename T>
+struct logger_argument {
+  using type = T;
+
+  static constexpr std::size_t size(const T&) noexcept
+  {
+    return sizeof(T);
+  }
+
+  static char* write(char* data, const T& value) noexcept
+  {
+    std::memcpy(data, &value, sizeof(T));
+    return data + sizeof(T);
+  }
+
+  static T read(const char*& data) noexcept
+  {
+    std::array<char, sizeof(T)> value;
+    std::memcpy(value.data(), data, sizeof(T));
+    data += sizeof(T);
+    return std::bit_cast<T>(value);
+  }
+};
+
+// Strings are copied with their size and read as string views into the record.
+template <LoggerString T>
+struct logger_argument<T> {
+  using type = std::string_view;
+
+  static std::size_t size(const T& value) noexcept
+  {
+    return sizeof(std::uint32_t) + std::string_view(value).size();
+  }
+
+  static char* write(char* data, const T& value) noexcept
+  {
+    const std::string_view text{ value };
+    const auto size = static_cast<std::uint32_t>(text.size());
+    std::memcpy(data, &size, sizeof(size));
+    std::memcpy(data + sizeof(size), text.data(), text.size());
+    return data + sizeof(size) + text.size();
+  }
+
+  static std::string_view read(const char*& data) noexcept
+  {
+    std::uint32_t size = 0;
+    std::memcpy(&size, data, sizeof(size));
+    const std::string_view text{ data + sizeof(size), size };
+    data += sizeof(size) + size;
+    return text;
+  }
+};
+
+}  // namespace detail
+
+// ================================================================================================
+// logger
+// ================================================================================================
+
+// Writes lines to a file on a background thread.
+// Each thread appends records to its own ring buffer and publishes them with a release store, so writers do not
+// share a lock or wait for I/O. A background thread takes the records of all buffers and writes them with a single
+// writev call, which keeps lines from different threads whole. Buffers of threads that exited are written and freed
+// by the background thread.
+//
+// Text records are complete lines. Binary records hold the function, the format string, the time and a copy of the
+// arguments, and are formatted by the background thread as "[seconds] function: text", where seconds are counted
+// from the start of the process. Strings are copied and other arguments must be trivially copyable and must not refer
+// to thread-local state (see ice::detail::logger_thread_argument), otherwise the line is formatted by the calling
+// thread. Arguments that point to other memory, except for strings, must stay valid until the logger is flushed.
+//
+// When the buffer of a thread is full, new records are dropped and counted or the thread waits until the background
+// thread made room, depending on the overflow policy. Lines that are longer than line_size are truncated. Lines that
+// are written while the process exits are written synchronously and binary records are dropped.
+
+class ICE_API logger {
+public:
+  static constexpr std::size_t buffer_size = 64 * 1024;
+
+  // Maximum size of a line, which shares the buffer with the record header.
+  static constexpr std::size_t line_size = buffer_size - 8;
+
+  enum class overflow {
+    drop,
+    block,
+  };
+
+  // Formats the arguments of a binary record.
+  using format_function = void (*)(fmt::memory_buffer& buffer, const char* format, const char* data) noexcept;
+
+  // Sets the overflow policy. The default is overflow::block.
+  static void set(overflow policy) noexcept;
+
+  // Sets the output file. The default is stderr.
+  static void set(std::FILE* file) noexcept;
+
+  // Appends a line, which should end with a newline character.
+  static void write(std::string_view line) noexcept;
+
+  // Appends a binary record. The function and format strings must have static storage duration.
+  template <std::size_t N, typename... Args>
+  static void write(const char* function, const char (&format)[N], const Args&... args) noexcept
+  {
+    if constexpr ((detail::LoggerArgument<Args> && ...)) {
+      const auto size = (std::size_t(0) + ... + detail::logger_argument<Args>::size(args));
+      const auto function_format = &logger::format<typename detail::logger_argument<Args>::type...>;
+      if (auto data = reserve(function_format, function, format, size)) {
+        ((data = detail::logger_argument<Args>::write(data, args)), ...);
+        commit();
+      }
+    } else {
+      fmt::memory_buffer buffer;
+      fmt::format_to(buffer, "{}: ", function);
+      fmt::format_to(buffer, format, args...);
+      buffer.push_back('\n');
+      write(std::string_view{ buffer.data(), buffer.size() });
+    }
+  }
+
+  // Writes all buffers on the calling thread, for example before the process is aborted.
+  static void flush() noexcept;
+
+  // Returns the number of records that were dropped.
+  static std::uint64_t dropped() noexcept;
+
+private:
+  template <typename... Args>
+  static void format(fmt::memory_buffer& buffer, const char* format, const char* data) noexcept
+  {
+    [[maybe_unused]] auto arguments = data;
+    const std::tuple<Args...> values{ detail::logger_argument<Args>::read(arguments)... };
+    std::apply(
+      [&](const auto&... values) {
+        fmt::format_to(buffer, format, values...);
+      },
+      values);
+  }
+
+  // Returns the memory for the arguments of a binary record or null if the record was dropped.
+  static char* reserve(format_function function_format, const char* function, const char* format,
+    std::size_t size) noexcept;
+
+  // Publishes the reserved record.
+  static void commit() noexcept;
+};
+
+}  // namespace ice
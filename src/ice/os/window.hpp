@@ -11,8 +11,11 @@ public:
   virtual ice::error destroy() noexcept = 0;
   virtual ice::error set(ice::window::mode mode) noexcept = 0;
   virtual ice::error set(ice::window::style style) noexcept = 0;
+  virtual ice::error set(ice::window::render render) noexcept = 0;
   virtual ice::error text(std::string_view text) noexcept = 0;
   virtual ice::error icon(std::string_view icon) noexcept = 0;
+  virtual ice::error record(const std::filesystem::path& path) noexcept = 0;
+  virtual ice::error replay(const std::filesystem::path& path, bool realtime) noexcept = 0;
   virtual ice::error start(std::string_view name, int size, int weight, ice::ui::font::flags flags) noexcept = 0;
   virtual ice::error show() noexcept = 0;
   virtual ice::error hide() noexcept = 0;
@@ -1,6 +1,7 @@
 #pragma once
 #include <ice/format.hpp>
 #include <ice/os/nuklear.hpp>
+#include <ice/ui/arena.hpp>
 #include <ice/ui/context.hpp>
 #include <ice/utility.hpp>
 #include <windows.h>
@@ -68,7 +69,10 @@ public:
     }
     SelectObject(memory_, bitmap_);
 
-    nk_init_default(&context_, nullptr);
+    if (auto e = arena_.create(&context_, nullptr)) {
+      ICE_TRACE_FUNCTION;
+      return e;
+    }
     context_.clip.copy = copy;
     context_.clip.paste = paste;
     ice::ui::context::set(&context_);
@@ -237,7 +241,7 @@ public:
 
   void clear() noexcept
   {
-    nk_clear(&context_);
+    arena_.clear(&context_);
   }
 
   void input_begin() noexcept
@@ -265,6 +269,11 @@ public:
     return &context_;
   }
 
+  const ice::ui::arena& arena() const noexcept
+  {
+    return arena_;
+  }
+
   RECT* rect() noexcept
   {
     return &rect_;
@@ -280,6 +289,17 @@ public:
     return window_;
   }
 
+  // Copies the area that the system asks to repaint from the memory bitmap to the window.
+  // Damage tracking decides what is drawn into the memory bitmap, but not what is presented: areas that were
+  // uncovered or restored must be copied even when nothing changed.
+  void present() noexcept
+  {
+    RECT rc{};
+    if (GetUpdateRect(hwnd_, &rc, FALSE)) {
+      BitBlt(window_, rc.left, rc.top, rc.right - rc.left, rc.bottom - rc.top, memory_, rc.left, rc.top, SRCCOPY);
+    }
+  }
+
 private:
   HWND hwnd_{};
   RECT rect_{};
@@ -290,6 +310,7 @@ private:
 
   HBITMAP bitmap_{};
 
+  ice::ui::arena arena_;
   nk_context context_{};
 
   static void copy(nk_handle user, const char* string, int length) noexcept
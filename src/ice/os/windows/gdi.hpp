@@ -2,6 +2,7 @@
 #include "context.hpp"
 #include <ice/format.hpp>
 #include <ice/os/nuklear.hpp>
+#include <ice/ui/damage.hpp>
 #include <ice/ui/font.hpp>
 #include <windows.h>
 #include <array>
@@ -147,12 +148,37 @@ public:
   {
     HDC dc = memory();
     const RECT* rc = rect();
+    nk_context* ctx = get();
+
+    // Skip unchanged frames and limit drawing to damaged tiles.
+    // The memory bitmap and the composited window surface still contain the previous frame.
+    ice::ui::raster::rect bounds{ 0, 0, rc->right, rc->bottom };
+    const auto state = SaveDC(dc);
+    if (!damage_.resize(rc->right, rc->bottom)) {
+      if (!damage_.update(ctx)) {
+        RestoreDC(dc, state);
+        present();
+        return;
+      }
+      bounds = damage_.bounds();
+      if (const auto region = CreateRectRgn(0, 0, 0, 0)) {
+        for (const auto& r : damage_) {
+          if (const auto tile = CreateRectRgn(r.x0, r.y0, r.x1, r.y1)) {
+            CombineRgn(region, region, tile, RGN_OR);
+            DeleteObject(tile);
+          }
+        }
+        SelectClipRgn(dc, region);
+        SetMetaRgn(dc);
+        DeleteObject(region);
+      }
+    }
+
     SetBkColor(dc, 0x1E1E1E);
     SelectObject(dc, GetStockObject(DC_PEN));
     SelectObject(dc, GetStockObject(DC_BRUSH));
     ExtTextOutA(dc, 0, 0, ETO_OPAQUE, rc, nullptr, 0, nullptr);
     const nk_command* cmd = nullptr;
-    nk_context* ctx = get();
     nk_foreach(cmd, ctx)
     {
       switch (cmd->type) {
@@ -207,7 +233,11 @@ public:
         break;
       }
     }
-    BitBlt(window(), 0, 0, rc->right, rc->bottom, dc, 0, 0, SRCCOPY);
+    RestoreDC(dc, state);
+    const auto cx = bounds.x1 - bounds.x0;
+    const auto cy = bounds.y1 - bounds.y0;
+    BitBlt(window(), bounds.x0, bounds.y0, cx, cy, dc, bounds.x0, bounds.y0, SRCCOPY);
+    present();
   }
 
 private:
@@ -463,6 +493,7 @@ private:
   }
 
   font font_;
+  ice::ui::damage damage_;
 };
 
 }  // namespace ice::os::windows
@@ -3,6 +3,7 @@
 #include <ice/format.hpp>
 #include <ice/library.hpp>
 #include <ice/os/nuklear.hpp>
+#include <ice/ui/damage.hpp>
 #include <ice/ui/font.hpp>
 #include <windows.h>
 #include <objidl.h>
@@ -51,7 +52,7 @@ public:
 
   static ice::error_info make_error_info(errc) noexcept
   {
-    constexpr auto text = [](int code) -> std::string {
+    constexpr auto text = [](int code) -> std::string_view {
       switch (static_cast<Gdiplus::Status>(code)) {
       case Gdiplus::Status::Ok:
         return "ok";
@@ -100,7 +101,7 @@ public:
         return "profile not found";
 #endif
       }
-      return ice::error_info::format(code);
+      return {};
     };
     return { "gdiplus", text };
   }
@@ -524,15 +525,48 @@ public:
 
   void render() noexcept override
   {
+    // Skip unchanged frames and redraw only damaged tiles.
+    const RECT* rc = rect();
+    nk_context* ctx = get();
+    const ice::ui::raster::rect frame{ 0, 0, rc->right, rc->bottom };
+    const ice::ui::raster::rect* begin = &frame;
+    const ice::ui::raster::rect* end = &frame + 1;
+    if (!damage_.resize(rc->right, rc->bottom)) {
+      if (!damage_.update(ctx)) {
+        present();
+        return;
+      }
+      begin = damage_.begin();
+      end = damage_.end();
+    }
+
     Gdiplus::GpGraphics* graphics = nullptr;
     if (library_->create_graphics(memory(), &graphics)) {
+      present();
       return;
     }
-    library_->clear(graphics, Gdiplus::Color::MakeARGB(255, 30, 30, 30));
     library_->set_text_rendering_hint(graphics, Gdiplus::TextRenderingHintClearTypeGridFit);
     library_->set_smoothing_mode(graphics, Gdiplus::SmoothingModeHighQuality);
+    for (auto it = begin; it != end; ++it) {
+      region_ = *it;
+      library_->set_clip_rect(graphics, region_.x0, region_.y0, region_.x1 - region_.x0, region_.y1 - region_.y0,
+        Gdiplus::CombineModeReplace);
+      library_->clear(graphics, Gdiplus::Color::MakeARGB(255, 30, 30, 30));
+      render(graphics, ctx);
+    }
+    library_->delete_graphics(graphics);
+    for (auto it = begin; it != end; ++it) {
+      const auto cx = it->x1 - it->x0;
+      const auto cy = it->y1 - it->y0;
+      BitBlt(window(), it->x0, it->y0, cx, cy, memory(), it->x0, it->y0, SRCCOPY);
+    }
+    present();
+  }
+
+private:
+  void render(Gdiplus::GpGraphics* graphics, nk_context* ctx) noexcept
+  {
     const nk_command* cmd = nullptr;
-    nk_context* ctx = get();
     nk_foreach(cmd, ctx)
     {
       switch (cmd->type) {
@@ -587,17 +621,15 @@ public:
         break;
       }
     }
-    const RECT* rc = rect();
-    library_->delete_graphics(graphics);
-    BitBlt(window(), 0, 0, rc->right, rc->bottom, memory(), 0, 0, SRCCOPY);
   }
 
-private:
   void render(Gdiplus::GpGraphics* graphics, const nk_command_scissor& c) const noexcept
   {
-    const auto w = static_cast<INT>(c.w);
-    const auto h = static_cast<INT>(c.h);
-    library_->set_clip_rect(graphics, c.x, c.y, w, h, Gdiplus::CombineModeReplace);
+    const auto x0 = std::max<INT>(c.x, region_.x0);
+    const auto y0 = std::max<INT>(c.y, region_.y0);
+    const auto x1 = std::min<INT>(c.x + c.w, region_.x1);
+    const auto y1 = std::min<INT>(c.y + c.h, region_.y1);
+    library_->set_clip_rect(graphics, x0, y0, std::max(x1 - x0, 0), std::max(y1 - y0, 0), Gdiplus::CombineModeReplace);
   }
 
   void render(Gdiplus::GpGraphics* graphics, const nk_command_line& c) noexcept
@@ -765,6 +797,8 @@ private:
   Gdiplus::GpStringFormat* format_{};
   std::shared_ptr<gdiplus_library> library_;
   font font_;
+  ice::ui::damage damage_;
+  ice::ui::raster::rect region_;
 };
 
 }  // namespace ice::os::windows
@@ -163,6 +163,17 @@ public:
     return ice::errc::not_implemented;
   }
 
+  ice::error set(ice::window::render render) noexcept override
+  {
+    if (!hwnd_) {
+      return ice::errc::not_initialized;
+    }
+    if (render != ice::window::render::direct) {
+      return ice::errc::not_implemented;
+    }
+    return {};
+  }
+
   ice::error text(std::string_view text) noexcept override
   {
     if (!hwnd_) {
@@ -179,6 +190,22 @@ public:
     return ice::errc::not_implemented;
   }
 
+  ice::error record(const std::filesystem::path& path) noexcept override
+  {
+    if (!hwnd_) {
+      return ice::errc::not_initialized;
+    }
+    return ice::errc::not_implemented;
+  }
+
+  ice::error replay(const std::filesystem::path& path, bool realtime) noexcept override
+  {
+    if (!hwnd_) {
+      return ice::errc::not_initialized;
+    }
+    return ice::errc::not_implemented;
+  }
+
   ice::error start(std::string_view name, int size, int weight, ice::ui::font::flags flags) noexcept override
   {
     if (!hwnd_) {
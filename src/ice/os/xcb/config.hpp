@@ -10,28 +10,19 @@ namespace ice::os::xcb {
 
 enum class errc : int;
 
-inline ice::error_info make_error_info(errc) noexcept
+constexpr auto make_error_category(errc) noexcept
 {
-  constexpr auto text = [](int code) -> std::string {
-    switch (code) {
-    case XCB_CONN_ERROR:
-      return "stream error";
-    case XCB_CONN_CLOSED_EXT_NOTSUPPORTED:
-      return "extension not supported";
-    case XCB_CONN_CLOSED_MEM_INSUFFICIENT:
-      return ice::error_info::get(ice::make_error_type<std::errc>(), ENOMEM);
-    case XCB_CONN_CLOSED_REQ_LEN_EXCEED:
-      return "request length exceeded";
-    case XCB_CONN_CLOSED_PARSE_ERR:
-      return "display string parse error";
-    case XCB_CONN_CLOSED_INVALID_SCREEN:
-      return "invalid screen";
-    case XCB_CONN_CLOSED_FDPASSING_FAILED:
-      return "file descriptor passing operation failed";
-    }
-    return ice::error_info::get(ice::make_error_type<std::errc>(), code);
-  };
-  return { "xcb", text };
+  return ice::error_category{ "xcb", {
+    { static_cast<errc>(XCB_CONN_ERROR), "stream error" },
+    { static_cast<errc>(XCB_CONN_CLOSED_EXT_NOTSUPPORTED), "extension not supported" },
+    { static_cast<errc>(XCB_CONN_CLOSED_MEM_INSUFFICIENT), "not enough memory" },
+    { static_cast<errc>(XCB_CONN_CLOSED_REQ_LEN_EXCEED), "request length exceeded" },
+    { static_cast<errc>(XCB_CONN_CLOSED_PARSE_ERR), "display string parse error" },
+    { static_cast<errc>(XCB_CONN_CLOSED_INVALID_SCREEN), "invalid screen" },
+    { static_cast<errc>(XCB_CONN_CLOSED_FDPASSING_FAILED), "file descriptor passing operation failed" },
+  }, [](int code) {
+    return ice::error_info::message(ice::make_error_type<std::errc>(), code);
+  } };
 }
 
 }  // namespace ice::os::xcb
@@ -1,25 +1,47 @@
 #pragma once
 #include "config.hpp"
+#include "keysym.hpp"
+#include <ice/context.hpp>
 #include <ice/format.hpp>
 #include <ice/os/nuklear.hpp>
+#include <ice/ui/arena.hpp>
 #include <ice/ui/context.hpp>
+#include <ice/ui/damage.hpp>
+#include <ice/ui/player.hpp>
+#include <ice/ui/raster.hpp>
+#include <ice/ui/recorder.hpp>
+#include <ice/ui/swapchain.hpp>
+#include <ice/ui/truetype.hpp>
+#include <ice/window.hpp>
+#include <algorithm>
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <vector>
 
 namespace ice::os::xcb {
 
 class context final : public ice::ui::context {
 public:
+  using clock = std::chrono::steady_clock;
+
   ~context() override
   {
+    stop();
     ice::ui::context::set(nullptr);
     if (context_.memory.memory.ptr) {
       nk_free(&context_);
     }
+    if (gc_) {
+      xcb_free_gc(connection_, gc_);
+    }
     if (key_symbols_) {
       xcb_key_symbols_free(key_symbols_);
     }
   }
 
-  ice::error create(xcb_connection_t* c, std::string_view name, int size, int weight, ice::ui::font::flags flags) noexcept
+  ice::error create(xcb_connection_t* c, xcb_window_t window, uint8_t depth, std::string_view name, int size,
+    int weight, ice::ui::font::flags flags) noexcept
   {
     if (key_symbols_) {
       ICE_TRACE_FORMAT("xcb_key_symbols_t: 0x{:016X}", reinterpret_cast<uintptr_t>(key_symbols_));
@@ -37,46 +59,47 @@ public:
       return ice::errc::not_available;
     }
 
-    // if (hwnd_) {
-    //   ICE_TRACE_FORMAT("HWND: 0x{:016X}", reinterpret_cast<uintptr_t>(hwnd_));
-    //   return ice::errc::not_available;
-    // }
-
-    // hwnd_ = hwnd;
-    // if (!GetClientRect(hwnd_, &rect_)) {
-    //   auto e = ice::make_error<ice::system::errc>(GetLastError());
-    //   ICE_TRACE_FORMAT("GetClientRect: {}", e);
-    //   return e;
-    // }
-
-    // window_ = GetDC(hwnd_);
-    // if (!window_) {
-    //   ICE_TRACE_FORMAT("GetDC: NULL");
-    //   return ice::errc::not_available;
-    // }
-
-    // memory_ = CreateCompatibleDC(window_);
-    // if (!memory_) {
-    //   ICE_TRACE_FORMAT("CreateCompatibleDC: NULL");
-    //   return ice::errc::not_available;
-    // }
-
-    // memory_state_ = SaveDC(memory_);
-    // if (!memory_state_) {
-    //   ICE_TRACE_FORMAT("SaveDC: 0");
-    //   return ice::errc::not_available;
-    // }
-
-    // bitmap_ = CreateCompatibleBitmap(window_, rect_.right, rect_.bottom);
-    // if (!bitmap_) {
-    //   ICE_TRACE_FORMAT("CreateCompatibleBitmap: 0");
-    //   return ice::errc::not_available;
-    // }
-    // SelectObject(memory_, bitmap_);
-
-    // nk_init_default(&context_, nullptr);
-    // context_.clip.copy = copy;
-    // context_.clip.paste = paste;
+    connection_ = c;
+    window_ = window;
+    depth_ = depth;
+
+    // The geometry reply is requested after the graphics context, which makes the error check free.
+    const auto gc = xcb_generate_id(c);
+    const auto gc_cookie = xcb_create_gc_checked(c, gc, window, 0, nullptr);
+    const auto geometry_cookie = xcb_get_geometry(c, window);
+    const auto geometry = xcb_get_geometry_reply(c, geometry_cookie, nullptr);
+    if (const auto error = xcb_request_check(c, gc_cookie)) {
+      auto e = ice::make_error<ice::os::xcb::errc>(error->error_code);
+      ICE_TRACE_FORMAT("xcb_create_gc: {}", e);
+      free(error);
+      free(geometry);
+      return e;
+    }
+    gc_ = gc;
+    if (!geometry) {
+      ICE_TRACE_FORMAT("xcb_get_geometry_reply: nullptr");
+      return ice::errc::not_available;
+    }
+    const auto cx = geometry->width;
+    const auto cy = geometry->height;
+    free(geometry);
+
+    if (auto e = resize(cx, cy)) {
+      ICE_TRACE_FUNCTION;
+      return e;
+    }
+
+    // The window still works without a font, but windows are not drawn (see begin).
+    if (auto e = font_.create(name, size, weight, flags)) {
+      ICE_TRACE_WARNING(ice::trace_common, "Could not create TrueType font: {}", e);
+    }
+
+    if (auto e = arena_.create(&context_, font_.get())) {
+      ICE_TRACE_FUNCTION;
+      return e;
+    }
+    context_.clip.copy = copy;
+    context_.clip.paste = paste;
     ice::ui::context::set(&context_);
     return {};
   }
@@ -84,96 +107,164 @@ public:
   std::shared_ptr<ice::ui::font> create_font(std::string_view name, int size, int weight = 400,
     ice::ui::font::flags flags = ice::ui::font::flags::normal) noexcept override
   {
-    // auto font = std::make_shared<ice::os::xcb::context::font>();
-    // if (auto e = font->create(window(), std::string{ name }, size, weight, flags)) {
-    //   ICE_TRACE_FORMAT("Could not create GDI font: {}", e);
-    // }
-    // return font;
+    auto font = std::make_shared<ice::ui::truetype>();
+    if (auto e = font->create(name, size, weight, flags)) {
+      ICE_TRACE_FORMAT("Could not create TrueType font: {}", e);
+    }
+    return font;
+  }
+
+  // Starts or stops the render thread. Frames are rasterized and presented in the render call without it.
+  // The render thread rasterizes tiles together with one worker thread per remaining hardware thread.
+  ice::error set(ice::window::render render) noexcept
+  {
+    if (render == ice::window::render::direct) {
+      stop();
+      return {};
+    }
+    if (thread_.joinable()) {
+      return {};
+    }
+    damage_.invalidate();
+    swapchain_.open();
+    work_.emplace(workers_);
+    const auto concurrency = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+    for (unsigned i = 0; i < concurrency; i++) {
+      worker_threads_.emplace_back([this]() {
+        if (auto e = workers_.run()) {
+          ICE_TRACE_FORMAT("Could not run raster workers: {}", e);
+        }
+      });
+    }
+    thread_ = std::thread([this]() {
+      run();
+    });
     return {};
   }
 
+  // Rasterizes and presents the tiles that changed since the last frame.
+  // With the render thread, the command list is copied and handed to the render thread instead.
   void render() noexcept
   {
-    // TODO
+    recorder_.write({ .type = ice::ui::input::type::frame });
+    const auto input = std::exchange(time_, clock::time_point{});
+    if (thread_.joinable()) {
+      if (auto e = swapchain_.back().assign(&context_, cx_, cy_, input)) {
+        ICE_TRACE_FORMAT("Could not copy frame: {}", e);
+        return;
+      }
+      swapchain_.publish();
+      return;
+    }
+    draw(&context_, input);
   }
 
-  void resize(uint16_t cx, uint16_t cy) noexcept
+  // Presents the last frame without rasterizing it again.
+  void expose(uint16_t x, uint16_t y, uint16_t cx, uint16_t cy) noexcept
   {
-    // TODO
+    if (thread_.joinable()) {
+      expose_.store(true, std::memory_order_release);
+      swapchain_.wake();
+      return;
+    }
+    present({ x, y, x + cx, y + cy });
+    xcb_flush(connection_);
+  }
+
+  // Sets the size of the next frame. The render thread resizes the raster when it renders the frame.
+  ice::error resize(uint16_t cx, uint16_t cy) noexcept
+  {
+    if (cx == cx_ && cy == cy_) {
+      return {};
+    }
+    recorder_.write({ .type = ice::ui::input::type::resize, .x = cx, .y = cy });
+    if (!thread_.joinable()) {
+      if (auto e = reshape(cx, cy)) {
+        return e;
+      }
+    }
+    cx_ = cx;
+    cy_ = cy;
+    return {};
   }
 
   void handle(xcb_generic_event_t* event) noexcept
   {
-    switch (const auto type = XCB_EVENT_RESPONSE_TYPE(event)) {
+    const auto type = XCB_EVENT_RESPONSE_TYPE(event);
+    switch (type) {
+    case XCB_KEY_PRESS:
+    case XCB_KEY_RELEASE:
+    case XCB_BUTTON_PRESS:
+    case XCB_BUTTON_RELEASE:
+    case XCB_MOTION_NOTIFY:
+      // User input is ignored while a recording is replayed.
+      if (player_.playing()) {
+        return;
+      }
+      break;
+    }
+    switch (type) {
     case XCB_KEY_PRESS:
     case XCB_KEY_RELEASE: {
       const auto e = reinterpret_cast<xcb_key_press_event_t*>(event);
       const auto s = xcb_key_symbols_get_keysym(key_symbols_, e->detail, e->state);
       const auto down = type == XCB_KEY_PRESS;
+      // Keys without text cancel compose sequences, which is why every key press is passed to compose_.
+      const auto code = down ? compose_(s) : 0;
       switch (s) {
       case XK_Shift_L:
       case XK_Shift_R:
-        nk_input_key(&context_, NK_KEY_SHIFT, down);
+        key(NK_KEY_SHIFT, down);
         break;
       case XK_Control_L:
       case XK_Control_R:
-        nk_input_key(&context_, NK_KEY_CTRL, down);
+        key(NK_KEY_CTRL, down);
         break;
       case XK_Delete:
-        nk_input_key(&context_, NK_KEY_DEL, down);
+        key(NK_KEY_DEL, down);
         break;
       case XK_Return:
-        nk_input_key(&context_, NK_KEY_ENTER, down);
+        key(NK_KEY_ENTER, down);
         break;
       case XK_Tab:
-        nk_input_key(&context_, NK_KEY_TAB, down);
+        key(NK_KEY_TAB, down);
         break;
       case XK_BackSpace:
-        nk_input_key(&context_, NK_KEY_BACKSPACE, down);
+        key(NK_KEY_BACKSPACE, down);
         break;
       case XK_Up:
-        nk_input_key(&context_, NK_KEY_UP, down);
+        key(NK_KEY_UP, down);
         break;
       case XK_Down:
-        nk_input_key(&context_, NK_KEY_DOWN, down);
+        key(NK_KEY_DOWN, down);
         break;
       case XK_Left:
-        nk_input_key(&context_, NK_KEY_LEFT, down);
+        key(NK_KEY_LEFT, down);
         break;
       case XK_Right:
-        nk_input_key(&context_, NK_KEY_RIGHT, down);
+        key(NK_KEY_RIGHT, down);
         break;
       case XK_Escape:
-        nk_input_key(&context_, NK_KEY_TEXT_RESET_MODE, down);
+        key(NK_KEY_TEXT_RESET_MODE, down);
         break;
       case XK_Home: {
-        nk_input_key(&context_, NK_KEY_TEXT_START, down);
-        nk_input_key(&context_, NK_KEY_SCROLL_START, down);
+        key(NK_KEY_TEXT_START, down);
+        key(NK_KEY_SCROLL_START, down);
       } break;
       case XK_End: {
-        nk_input_key(&context_, NK_KEY_TEXT_END, down);
-        nk_input_key(&context_, NK_KEY_SCROLL_END, down);
+        key(NK_KEY_TEXT_END, down);
+        key(NK_KEY_SCROLL_END, down);
       } break;
       case XK_Page_Down:
-        nk_input_key(&context_, NK_KEY_SCROLL_DOWN, down);
+        key(NK_KEY_SCROLL_DOWN, down);
         break;
       case XK_Page_Up:
-        nk_input_key(&context_, NK_KEY_SCROLL_UP, down);
+        key(NK_KEY_SCROLL_UP, down);
         break;
       default:
-        // clang-format off
-        if (down &&
-          !xcb_is_cursor_key(s) &&
-          !xcb_is_function_key(s) &&
-          !xcb_is_keypad_key(s) &&
-          !xcb_is_misc_function_key(s) &&
-          !xcb_is_modifier_key(s) &&
-          !xcb_is_pf_key(s) &&
-          !xcb_is_private_keypad_key(s))
-        {
-          nk_input_char(&context_, static_cast<char>(s));
+        if (code) {
+          unicode(code);
         }
-        // clang-format on
         break;
       }
     } break;
@@ -183,25 +274,25 @@ public:
       const auto down = type == XCB_BUTTON_PRESS;
       switch (e->detail) {
       case XCB_BUTTON_INDEX_1:
-        nk_input_button(&context_, NK_BUTTON_LEFT, e->event_x, e->event_y, down);
+        button(NK_BUTTON_LEFT, e->event_x, e->event_y, down);
         break;
       case XCB_BUTTON_INDEX_2:
-        nk_input_button(&context_, NK_BUTTON_MIDDLE, e->event_x, e->event_y, down);
+        button(NK_BUTTON_MIDDLE, e->event_x, e->event_y, down);
         break;
       case XCB_BUTTON_INDEX_3:
-        nk_input_button(&context_, NK_BUTTON_RIGHT, e->event_x, e->event_y, down);
+        button(NK_BUTTON_RIGHT, e->event_x, e->event_y, down);
         break;
       case XCB_BUTTON_INDEX_4:
-        nk_input_scroll(&context_, nk_vec2(0, 1.0f));
+        scroll(0.0f, 1.0f);
         break;
       case XCB_BUTTON_INDEX_5:
-        nk_input_scroll(&context_, nk_vec2(0, -1.0f));
+        scroll(0.0f, -1.0f);
         break;
       }
     } break;
     case XCB_MOTION_NOTIFY: {
       const auto e = reinterpret_cast<xcb_motion_notify_event_t*>(event);
-      nk_input_motion(&context_, e->event_x, e->event_y);
+      motion(e->event_x, e->event_y);
     } break;
     case XCB_KEYMAP_NOTIFY: {
       const auto e = reinterpret_cast<xcb_mapping_notify_event_t*>(event);
@@ -210,19 +301,77 @@ public:
     }
   }
 
+  // Records the translated input into a file.
+  ice::error record_input(const std::filesystem::path& path) noexcept
+  {
+    if (auto e = recorder_.open(path)) {
+      ICE_TRACE_FORMAT("Could not record input: {}", e);
+      return e;
+    }
+    return {};
+  }
+
+  // Replays recorded input instead of user input. The recorded times are kept in real time mode.
+  ice::error replay_input(const std::filesystem::path& path, bool realtime) noexcept
+  {
+    if (auto e = player_.open(path)) {
+      ICE_TRACE_FORMAT("Could not replay input: {}", e);
+      return e;
+    }
+    realtime_ = realtime;
+    replay_ = clock::now();
+    return {};
+  }
+
+  // Applies the recorded input of the next frame and returns false when the recording ended.
+  bool replay() noexcept
+  {
+    ice::ui::input event;
+    while (player_.next(event)) {
+      if (realtime_) {
+        std::this_thread::sleep_until(replay_ + event.time);
+      }
+      switch (event.type) {
+      case ice::ui::input::type::frame:
+        return true;
+      case ice::ui::input::type::resize: {
+        const uint32_t values[] = { static_cast<uint32_t>(event.x), static_cast<uint32_t>(event.y) };
+        xcb_configure_window(connection_, window_, XCB_CONFIG_WINDOW_WIDTH | XCB_CONFIG_WINDOW_HEIGHT, values);
+        xcb_flush(connection_);
+      } break;
+      default:
+        input(event);
+        break;
+      }
+    }
+    player_.close();
+    return false;
+  }
+
+  bool replaying() const noexcept
+  {
+    return player_.playing();
+  }
+
   bool begin(const char* title, struct nk_rect bounds, nk_flags flags) noexcept
   {
+    // Nuklear requires a font to lay out windows.
+    if (!context_.style.font) {
+      return false;
+    }
     return nk_begin(&context_, title, bounds, flags);
   }
 
   void end() noexcept
   {
-    nk_end(&context_);
+    if (context_.current) {
+      nk_end(&context_);
+    }
   }
 
   void clear() noexcept
   {
-    nk_clear(&context_);
+    arena_.clear(&context_);
   }
 
   void input_begin() noexcept
@@ -250,11 +399,184 @@ public:
     return &context_;
   }
 
+  const ice::ui::arena& arena() const noexcept
+  {
+    return arena_;
+  }
+
 private:
+  // Records and applies translated input.
+  void input(const ice::ui::input& event) noexcept
+  {
+    if (time_ == clock::time_point{}) {
+      time_ = clock::now();
+    }
+    recorder_.write(event);
+    event.apply(&context_);
+  }
+
+  void key(nk_keys key, bool down) noexcept
+  {
+    input({ .type = ice::ui::input::type::key, .id = static_cast<uint8_t>(key), .down = down });
+  }
+
+  void button(nk_buttons button, int x, int y, bool down) noexcept
+  {
+    input({ .type = ice::ui::input::type::button, .id = static_cast<uint8_t>(button), .down = down, .x = x, .y = y });
+  }
+
+  void motion(int x, int y) noexcept
+  {
+    input({ .type = ice::ui::input::type::motion, .x = x, .y = y });
+  }
+
+  void scroll(float dx, float dy) noexcept
+  {
+    input({ .type = ice::ui::input::type::scroll, .dx = dx, .dy = dy });
+  }
+
+  void unicode(char32_t code) noexcept
+  {
+    input({ .type = ice::ui::input::type::unicode, .code = code });
+  }
+
+  // Renders published frames until the swapchain is closed.
+  void run() noexcept
+  {
+    while (!swapchain_.closed()) {
+      const auto frame = swapchain_.acquire();
+      if (expose_.exchange(false, std::memory_order_acq_rel)) {
+        present({ 0, 0, raster_.cx(), raster_.cy() });
+        xcb_flush(connection_);
+      }
+      if (!frame || !frame->get()) {
+        continue;
+      }
+      if (frame->cx() != raster_.cx() || frame->cy() != raster_.cy()) {
+        if (reshape(frame->cx(), frame->cy())) {
+          continue;
+        }
+      }
+      draw(frame->get(), frame->input());
+    }
+  }
+
+  // Stops the render thread and prepares the raster for frames that are rendered in the event loop.
+  void stop() noexcept
+  {
+    if (!thread_.joinable()) {
+      return;
+    }
+    swapchain_.close();
+    thread_.join();
+    work_.reset();
+    for (auto& thread : worker_threads_) {
+      thread.join();
+    }
+    worker_threads_.clear();
+    if (raster_.cx() != cx_ || raster_.cy() != cy_) {
+      if (auto e = reshape(cx_, cy_)) {
+        ICE_TRACE_FORMAT("Could not resize raster: {}", e);
+      }
+    }
+    damage_.invalidate();
+  }
+
+  // Rasterizes and presents the tiles of a command list that changed since the last frame.
+  void draw(nk_context* commands, clock::time_point input) noexcept
+  {
+    if (!damage_.update(commands)) {
+      return;
+    }
+    for (const auto& region : damage_) {
+      raster_.render(commands, region, 0x1E1E1E, workers_, worker_threads_.size());
+      present(region);
+    }
+    xcb_flush(connection_);
+    record(input);
+  }
+
+  // Resizes the raster, the damage tiles and the image.
+  ice::error reshape(int cx, int cy) noexcept
+  {
+    if (auto e = raster_.resize(cx, cy)) {
+      ICE_TRACE_FORMAT("Could not resize raster: {}", e);
+      return e;
+    }
+    raster_.clear(0x1E1E1E);
+    if (auto e = damage_.resize(cx, cy)) {
+      ICE_TRACE_FORMAT("Could not resize damage: {}", e);
+      return e;
+    }
+    const auto size = static_cast<std::size_t>(cx) * static_cast<std::size_t>(cy);
+    image_.reset(new (std::nothrow) uint32_t[size]);
+    if (!image_) {
+      return std::errc::not_enough_memory;
+    }
+    return {};
+  }
+
+  // Copies a region of the raster into a contiguous image and sends it in requests that fit the request length.
+  void present(const ice::ui::raster::rect& region) noexcept
+  {
+    const auto x0 = std::max(region.x0, 0);
+    const auto y0 = std::max(region.y0, 0);
+    const auto x1 = std::min(region.x1, raster_.cx());
+    const auto y1 = std::min(region.y1, raster_.cy());
+    if (x0 >= x1 || y0 >= y1 || !image_) {
+      return;
+    }
+    const auto w = x1 - x0;
+    const auto stride = static_cast<std::size_t>(raster_.cx());
+    const auto limit = static_cast<std::size_t>(xcb_get_maximum_request_length(connection_)) * 4;
+    const auto rows = std::max<int>(static_cast<int>((limit - sizeof(xcb_put_image_request_t)) / (w * 4)), 1);
+    for (auto y = y0; y < y1; y += rows) {
+      const auto h = std::min(rows, y1 - y);
+      auto src = raster_.data() + static_cast<std::size_t>(y) * stride + x0;
+      auto dst = image_.get();
+      for (auto row = 0; row < h; row++, src += stride, dst += w) {
+        std::copy_n(src, w, dst);
+      }
+      const auto size = static_cast<uint32_t>(w * h * 4);
+      const auto data = reinterpret_cast<const uint8_t*>(image_.get());
+      xcb_put_image(connection_, XCB_IMAGE_FORMAT_Z_PIXMAP, window_, gc_, static_cast<uint16_t>(w),
+        static_cast<uint16_t>(h), static_cast<int16_t>(x0), static_cast<int16_t>(y), 0, depth_, size, data);
+    }
+  }
+
+  xcb_connection_t* connection_{};
+  xcb_window_t window_{};
+  xcb_gcontext_t gc_{};
+  uint8_t depth_{};
   xcb_key_symbols_t* key_symbols_{};
+  ice::os::xcb::compose compose_;
+  ice::ui::truetype font_;
+  ice::ui::arena arena_;
   nk_context context_{};
-  float cx_{};
-  float cy_{};
+  ice::ui::raster raster_;
+  ice::ui::damage damage_;
+  std::unique_ptr<uint32_t[]> image_;
+  uint16_t cx_{};
+  uint16_t cy_{};
+
+  // Render thread state.
+  ice::ui::swapchain swapchain_;
+  std::thread thread_;
+  std::atomic_bool expose_{ false };
+
+  // Raster workers of the render thread.
+  ice::context workers_;
+  std::optional<ice::context::work> work_;
+  std::vector<std::thread> worker_threads_;
+
+  // Time of the first input event of the next frame.
+  clock::time_point time_;
+
+  // Input recording and replay state.
+  ice::ui::recorder recorder_;
+  ice::ui::player player_;
+  clock::time_point replay_;
+  bool realtime_{ true };
 
   static void copy(nk_handle user, const char* string, int length) noexcept
   {}
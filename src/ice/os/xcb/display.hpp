@@ -0,0 +1,387 @@
+#pragma once
+#include "config.hpp"
+#include <ice/application.hpp>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+namespace ice::os::xcb {
+
+// ================================================================================================
+// display
+// ================================================================================================
+
+// Connection to the X server that is shared by all windows of the process.
+// A single event pump reads events from the connection and dispatches them by window id through a flat hash map.
+// Windows must be created, destroyed and run on the thread that runs the event pump.
+// Atoms are interned once per connection. All requests are sent before the first reply is read, which makes the
+// startup cost a single round-trip instead of one per atom.
+
+class display {
+public:
+  static inline std::mutex mutex;
+
+  // Receives the events of a window.
+  class client {
+  public:
+    virtual ~client() = default;
+
+    // Handles an event of the window or an event without a window, like XCB_MAPPING_NOTIFY.
+    virtual void handle(xcb_generic_event_t* event) noexcept = 0;
+
+    // Called after all pending events were handled.
+    // Returns true when the client must be called again without waiting for the next event.
+    virtual bool idle() noexcept = 0;
+  };
+
+  enum class atom : std::size_t {
+    wm_protocols,
+    wm_delete_window,
+    net_wm_name,
+    net_wm_pid,
+    net_wm_state,
+    net_wm_state_fullscreen,
+    net_wm_state_maximized_horz,
+    net_wm_state_maximized_vert,
+    net_wm_window_type,
+    net_wm_window_type_normal,
+    utf8_string,
+  };
+
+  static constexpr std::array<std::string_view, 11> atoms{
+    "WM_PROTOCOLS",
+    "WM_DELETE_WINDOW",
+    "_NET_WM_NAME",
+    "_NET_WM_PID",
+    "_NET_WM_STATE",
+    "_NET_WM_STATE_FULLSCREEN",
+    "_NET_WM_STATE_MAXIMIZED_HORZ",
+    "_NET_WM_STATE_MAXIMIZED_VERT",
+    "_NET_WM_WINDOW_TYPE",
+    "_NET_WM_WINDOW_TYPE_NORMAL",
+    "UTF8_STRING",
+  };
+
+  display() noexcept = default;
+  display(display&& other) = delete;
+  display(const display& other) = delete;
+  display& operator=(display&& other) = delete;
+  display& operator=(const display& other) = delete;
+
+  ~display()
+  {
+    if (connection_) {
+      xcb_disconnect(connection_);
+    }
+  }
+
+  ice::error create() noexcept
+  {
+    if (connection_) {
+      return {};
+    }
+    std::lock_guard lock{ mutex };
+    if (connection_) {
+      return {};
+    }
+
+    int screen_number = 0;
+    const auto connection = xcb_connect(nullptr, &screen_number);
+    if (!connection) {
+      ICE_TRACE_FORMAT("xcb_connect: nullptr");
+      return ice::errc::not_available;
+    }
+    if (const auto code = xcb_connection_has_error(connection)) {
+      auto e = ice::make_error<ice::os::xcb::errc>(code);
+      ICE_TRACE_FORMAT("xcb_connect: {}", e);
+      xcb_disconnect(connection);
+      return e;
+    }
+
+    const auto setup = xcb_get_setup(connection);
+    for (auto it = xcb_setup_roots_iterator(setup); it.rem; --screen_number, xcb_screen_next(&it)) {
+      if (screen_number == 0) {
+        screen_ = it.data;
+        break;
+      }
+    }
+    if (!screen_) {
+      ICE_TRACE_FORMAT("Could not find current screen.");
+      screen_ = xcb_setup_roots_iterator(setup).data;
+    }
+
+    std::array<xcb_intern_atom_cookie_t, atoms.size()> cookies{};
+    for (std::size_t i = 0; i < atoms.size(); i++) {
+      const auto size = static_cast<uint16_t>(atoms[i].size());
+      cookies[i] = xcb_intern_atom(connection, 0, size, atoms[i].data());
+    }
+    for (std::size_t i = 0; i < atoms.size(); i++) {
+      if (const auto reply = xcb_intern_atom_reply(connection, cookies[i], nullptr)) {
+        atoms_[i] = reply->atom;
+        free(reply);
+      } else {
+        ICE_TRACE_FORMAT("xcb_intern_atom_reply: {}", atoms[i]);
+      }
+    }
+    connection_ = connection;
+    return {};
+  }
+
+  constexpr xcb_connection_t* connection() const noexcept
+  {
+    return connection_;
+  }
+
+  constexpr xcb_screen_t* screen() const noexcept
+  {
+    return screen_;
+  }
+
+  // Returns the cached atom or XCB_ATOM_NONE if it could not be interned.
+  constexpr xcb_atom_t get(atom atom) const noexcept
+  {
+    return atoms_[static_cast<std::size_t>(atom)];
+  }
+
+  // Returns the number of windows that receive events.
+  constexpr std::size_t size() const noexcept
+  {
+    return size_;
+  }
+
+  // Dispatches the events of the window to the client until the window is removed.
+  void insert(xcb_window_t id, std::shared_ptr<client> client) noexcept
+  {
+    if ((size_ + 1) * 2 > slots_.size()) {
+      rehash(slots_.empty() ? 16 : slots_.size() * 2);
+    }
+    auto& slot = find(id);
+    if (!slot.id) {
+      slot.id = id;
+      size_++;
+    }
+    slot.handler = std::move(client);
+  }
+
+  // Stops dispatching events to the client of the window.
+  void remove(xcb_window_t id) noexcept
+  {
+    if (!id || slots_.empty()) {
+      return;
+    }
+    const auto mask = slots_.size() - 1;
+    auto index = hash(id) & mask;
+    while (slots_[index].id != id) {
+      if (!slots_[index].id) {
+        return;
+      }
+      index = (index + 1) & mask;
+    }
+    // The client is released after the table is consistent, because it can be destroyed with the last reference.
+    // The following entries of the probe sequence are shifted back instead of leaving a tombstone.
+    const auto handler = std::move(slots_[index].handler);
+    for (auto next = (index + 1) & mask; slots_[next].id; next = (next + 1) & mask) {
+      const auto home = hash(slots_[next].id) & mask;
+      if (((next - home) & mask) >= ((next - index) & mask)) {
+        slots_[index] = std::move(slots_[next]);
+        index = next;
+      }
+    }
+    slots_[index] = {};
+    size_--;
+  }
+
+  // Returns the client of the window or nullptr if the window was not inserted.
+  std::shared_ptr<client> get(xcb_window_t id) const noexcept
+  {
+    if (!id || slots_.empty()) {
+      return {};
+    }
+    const auto mask = slots_.size() - 1;
+    for (auto index = hash(id) & mask; slots_[index].id; index = (index + 1) & mask) {
+      if (slots_[index].id == id) {
+        return slots_[index].handler;
+      }
+    }
+    return {};
+  }
+
+  // Reads and dispatches events until all windows were removed.
+  ice::error run() noexcept
+  {
+    if (running_) {
+      return ice::errc::not_available;
+    }
+    running_ = true;
+    xcb_generic_event_t* event = nullptr;
+    while (size_) {
+      // Clients that are busy, for example when replaying input, are called again without waiting for events.
+      if (!idle()) {
+        if (!(event = xcb_wait_for_event(connection_))) {
+          break;
+        }
+        dispatch(event);
+        free(event);
+      }
+      while (size_ && (event = xcb_poll_for_event(connection_))) {
+        dispatch(event);
+        free(event);
+      }
+      if (xcb_connection_has_error(connection_)) {
+        break;
+      }
+    }
+    running_ = false;
+    if (const auto code = xcb_connection_has_error(connection_)) {
+      auto e = ice::make_error<ice::os::xcb::errc>(code);
+      ICE_TRACE_FORMAT("xcb_wait_for_event: {}", e);
+      return e;
+    }
+    return {};
+  }
+
+  static std::shared_ptr<display> get_shared_object() noexcept
+  {
+    static std::weak_ptr<display> wp;
+    auto sp = wp.lock();
+    if (!sp) {
+      std::lock_guard lock{ mutex };
+      sp = wp.lock();
+      if (!sp) {
+        sp = std::make_shared<display>();
+        wp = sp;
+      }
+    }
+    return sp;
+  }
+
+private:
+  struct slot {
+    xcb_window_t id{};
+    std::shared_ptr<display::client> handler;
+  };
+
+  static constexpr std::size_t hash(xcb_window_t id) noexcept
+  {
+    // Window ids share the resource id base of the connection and differ in the low bits.
+    return static_cast<std::size_t>((static_cast<std::uint64_t>(id) * 0x9E3779B97F4A7C15ULL) >> 32);
+  }
+
+  slot& find(xcb_window_t id) noexcept
+  {
+    const auto mask = slots_.size() - 1;
+    auto index = hash(id) & mask;
+    while (slots_[index].id && slots_[index].id != id) {
+      index = (index + 1) & mask;
+    }
+    return slots_[index];
+  }
+
+  void rehash(std::size_t size) noexcept
+  {
+    auto slots = std::exchange(slots_, std::vector<slot>(size));
+    for (auto& slot : slots) {
+      if (slot.id) {
+        find(slot.id) = std::move(slot);
+      }
+    }
+  }
+
+  // Returns the window that an event was sent to or 0 for events that are sent to all windows.
+  static xcb_window_t target(const xcb_generic_event_t* event) noexcept
+  {
+    switch (XCB_EVENT_RESPONSE_TYPE(event)) {
+    case XCB_KEY_PRESS:
+    case XCB_KEY_RELEASE:
+      return reinterpret_cast<const xcb_key_press_event_t*>(event)->event;
+    case XCB_BUTTON_PRESS:
+    case XCB_BUTTON_RELEASE:
+      return reinterpret_cast<const xcb_button_press_event_t*>(event)->event;
+    case XCB_MOTION_NOTIFY:
+      return reinterpret_cast<const xcb_motion_notify_event_t*>(event)->event;
+    case XCB_ENTER_NOTIFY:
+    case XCB_LEAVE_NOTIFY:
+      return reinterpret_cast<const xcb_enter_notify_event_t*>(event)->event;
+    case XCB_FOCUS_IN:
+    case XCB_FOCUS_OUT:
+      return reinterpret_cast<const xcb_focus_in_event_t*>(event)->event;
+    case XCB_EXPOSE:
+      return reinterpret_cast<const xcb_expose_event_t*>(event)->window;
+    case XCB_DESTROY_NOTIFY:
+      return reinterpret_cast<const xcb_destroy_notify_event_t*>(event)->event;
+    case XCB_UNMAP_NOTIFY:
+      return reinterpret_cast<const xcb_unmap_notify_event_t*>(event)->event;
+    case XCB_MAP_NOTIFY:
+      return reinterpret_cast<const xcb_map_notify_event_t*>(event)->event;
+    case XCB_REPARENT_NOTIFY:
+      return reinterpret_cast<const xcb_reparent_notify_event_t*>(event)->event;
+    case XCB_CONFIGURE_NOTIFY:
+      return reinterpret_cast<const xcb_configure_notify_event_t*>(event)->event;
+    case XCB_PROPERTY_NOTIFY:
+      return reinterpret_cast<const xcb_property_notify_event_t*>(event)->window;
+    case XCB_CLIENT_MESSAGE:
+      return reinterpret_cast<const xcb_client_message_event_t*>(event)->window;
+    }
+    return 0;
+  }
+
+  void dispatch(xcb_generic_event_t* event) noexcept
+  {
+    if (!XCB_EVENT_RESPONSE_TYPE(event)) {
+      const auto e = reinterpret_cast<const xcb_generic_error_t*>(event);
+      ICE_TRACE_FORMAT("xcb error {} in request {}.{}", e->error_code, e->major_code, e->minor_code);
+      return;
+    }
+    if (const auto id = target(event)) {
+      // The reference keeps the client alive when it removes itself while handling the event.
+      if (const auto client = get(id)) {
+        client->handle(event);
+      }
+      return;
+    }
+    for_each([event](client& client) {
+      client.handle(event);
+      return false;
+    });
+  }
+
+  // Calls idle on all clients and returns true if one of them is busy.
+  bool idle() noexcept
+  {
+    return for_each([](client& client) {
+      return client.idle();
+    });
+  }
+
+  // Calls the handler on a snapshot of the clients, because handlers can insert and remove windows.
+  template <class Handler>
+  bool for_each(Handler handler) noexcept
+  {
+    clients_.clear();
+    for (const auto& slot : slots_) {
+      if (slot.id) {
+        clients_.push_back(slot.handler);
+      }
+    }
+    auto clients = std::move(clients_);
+    auto result = false;
+    for (const auto& client : clients) {
+      result = handler(*client) || result;
+    }
+    clients.clear();
+    clients_ = std::move(clients);
+    return result;
+  }
+
+  xcb_connection_t* connection_{};
+  xcb_screen_t* screen_{};
+  std::array<xcb_atom_t, atoms.size()> atoms_{};
+  std::vector<slot> slots_;
+  std::vector<std::shared_ptr<client>> clients_;
+  std::size_t size_{ 0 };
+  bool running_{ false };
+};
+
+}  // namespace ice::os::xcb
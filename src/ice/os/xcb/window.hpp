@@ -1,24 +1,25 @@
 #pragma once
 #include "context.hpp"
+#include "display.hpp"
 #include <ice/application.hpp>
 #include <ice/os/window.hpp>
 #include <mutex>
+#include <unistd.h>
 
 namespace ice::os::xcb {
 
-class window final : public ice::os::window, public std::enable_shared_from_this<window> {
+class window final :
+  public ice::os::window,
+  public ice::os::xcb::display::client,
+  public std::enable_shared_from_this<window> {
 public:
   ~window() override
   {
     window_.store(nullptr, std::memory_order_release);
-    if (wm_delete_window_) {
-      free(wm_delete_window_);
-    }
-    if (connection_) {
-      if (id_) {
-        xcb_destroy_window(connection_, id_);
-      }
-      xcb_disconnect(connection_);
+    context_.reset();
+    if (connection_ && id_) {
+      xcb_destroy_window(connection_, id_);
+      xcb_flush(connection_);
     }
   }
 
@@ -36,30 +37,13 @@ public:
       return {};
     }
 
-    int screen_number = 0;
-    connection_ = xcb_connect(nullptr, &screen_number);
-    if (!connection_) {
-      ICE_TRACE_FORMAT("xcb_connect: nullptr");
-      return ice::errc::not_available;
-    }
-    if (const auto code = xcb_connection_has_error(connection_)) {
-      auto e = ice::make_error<ice::os::xcb::errc>(code);
-      ICE_TRACE_FORMAT("xcb_connect: {}", e);
+    display_ = ice::os::xcb::display::get_shared_object();
+    if (auto e = display_->create()) {
+      ICE_TRACE_FUNCTION;
       return e;
     }
-
-    xcb_screen_t* screen = nullptr;
-    const auto setup = xcb_get_setup(connection_);
-    for (auto it = xcb_setup_roots_iterator(setup); it.rem; --screen_number, xcb_screen_next(&it)) {
-      if (screen_number == 0) {
-        screen = it.data;
-        break;
-      }
-    }
-    if (!screen) {
-      ICE_TRACE_FORMAT("Could not find current screen.");
-      screen = xcb_setup_roots_iterator(setup).data;
-    }
+    connection_ = display_->connection();
+    const auto screen = display_->screen();
 
     const auto id = xcb_generate_id(connection_);
 
@@ -93,21 +77,25 @@ public:
     const uint32_t       mv[] = { 0x1E1E1E, event_mask };
     // clang-format on
 
+    // Send the window properties with the window and check for errors once.
+    using atom = ice::os::xcb::display::atom;
     const auto cookie = xcb_create_window_checked(connection_, d, id, p, x, y, w, h, bw, wc, v, m, mv);
+    const auto wm_delete_window = display_->get(atom::wm_delete_window);
+    property(id, atom::wm_protocols, XCB_ATOM_ATOM, 32, 1, &wm_delete_window);
+    const auto pid = static_cast<uint32_t>(getpid());
+    property(id, atom::net_wm_pid, XCB_ATOM_CARDINAL, 32, 1, &pid);
+    const auto type = display_->get(atom::net_wm_window_type_normal);
+    property(id, atom::net_wm_window_type, XCB_ATOM_ATOM, 32, 1, &type);
     if (const auto error = xcb_request_check(connection_, cookie)) {
-      return ice::make_error<ice::os::xcb::errc>(error->error_code);
+      auto e = ice::make_error<ice::os::xcb::errc>(error->error_code);
+      ICE_TRACE_FORMAT("xcb_create_window: {}", e);
+      free(error);
+      return e;
     }
     id_ = id;
+    depth_ = d;
 
-    const auto wm_protocols_cookie = xcb_intern_atom(connection_, 1, 12, "WM_PROTOCOLS");
-    const auto wm_protocols = xcb_intern_atom_reply(connection_, wm_protocols_cookie, 0);
-    const auto wm_delete_window_cookie = xcb_intern_atom(connection_, 0, 16, "WM_DELETE_WINDOW");
-    wm_delete_window_ = xcb_intern_atom_reply(connection_, wm_delete_window_cookie, 0);
-    xcb_change_property(connection_, XCB_PROP_MODE_REPLACE, id, wm_protocols->atom, 4, 32, 1, &wm_delete_window_->atom);
-    xcb_flush(connection_);
-    free(wm_protocols);
-
-    self_ = shared_from_this();
+    display_->insert(id, shared_from_this());
     if (auto window = window_.load(std::memory_order_acquire)) {
       window->on_create();
     }
@@ -122,8 +110,15 @@ public:
     if (auto window = window_.load(std::memory_order_acquire)) {
       window->on_destroy();
     }
+    if (context_) {
+      context_->set(ice::window::render::direct);
+    }
     const auto id = std::exchange(id_, 0);
     const auto cookie = xcb_destroy_window_checked(connection_, id);
+
+    // The display can hold the last reference to this window.
+    const auto self = shared_from_this();
+    display_->remove(id);
     if (const auto error = xcb_request_check(connection_, cookie)) {
       return ice::make_error<errc>(error->error_code);
     }
@@ -146,12 +141,51 @@ public:
     return ice::errc::not_implemented;
   }
 
+  ice::error set(ice::window::render render) noexcept override
+  {
+    if (!id_) {
+      return ice::errc::not_initialized;
+    }
+    render_ = render;
+    if (context_) {
+      return context_->set(render);
+    }
+    return {};
+  }
+
+  ice::error record(const std::filesystem::path& path) noexcept override
+  {
+    if (!context_) {
+      return ice::errc::not_initialized;
+    }
+    return context_->record_input(path);
+  }
+
+  ice::error replay(const std::filesystem::path& path, bool realtime) noexcept override
+  {
+    if (!context_) {
+      return ice::errc::not_initialized;
+    }
+    if (auto e = context_->replay_input(path, realtime)) {
+      return e;
+    }
+    replay_frames_ = 0;
+    replay_start_ = std::chrono::steady_clock::now();
+    return {};
+  }
+
   ice::error text(std::string_view text) noexcept override
   {
     if (!id_) {
       return ice::errc::not_initialized;
     }
-    return ice::errc::not_implemented;
+    using atom = ice::os::xcb::display::atom;
+    const auto size = static_cast<uint32_t>(text.size());
+    const auto utf8_string = display_->get(atom::utf8_string);
+    xcb_change_property(connection_, XCB_PROP_MODE_REPLACE, id_, XCB_ATOM_WM_NAME, utf8_string, 8, size, text.data());
+    property(id_, atom::net_wm_name, utf8_string, 8, size, text.data());
+    xcb_flush(connection_);
+    return {};
   }
 
   ice::error icon(std::string_view icon) noexcept override
@@ -168,10 +202,14 @@ public:
       return ice::errc::not_initialized;
     }
     auto xcb = std::make_unique<ice::os::xcb::context>();
-    if (auto e = xcb->create(connection_, name, size, weight, flags)) {
+    if (auto e = xcb->create(connection_, id_, depth_, name, size, weight, flags)) {
       ICE_TRACE_FORMAT("Could not create XCB context: {}", e);
       return e;
     }
+    if (auto e = xcb->set(render_)) {
+      ICE_TRACE_FORMAT("Could not set XCB context render mode: {}", e);
+      return e;
+    }
     context_ = std::move(xcb);
     return {};
   }
@@ -226,37 +264,25 @@ public:
     return ice::errc::not_implemented;
   }
 
+  // Runs the event pump of the shared display until all windows were destroyed.
   ice::error run() noexcept override
   {
     if (!id_) {
       return ice::errc::not_initialized;
     }
-    xcb_generic_event_t* event = nullptr;
-    while (id_ && (event = xcb_wait_for_event(connection_))) {
-      handle(event);
-      free(event);
-      while (id_ && (event = xcb_poll_for_event(connection_))) {
-        handle(event);
-        free(event);
-      }
-    }
-    ice::error e;
-    if (!event) {
-      if (const auto code = xcb_connection_has_error(connection_)) {
-        e = ice::make_error<ice::os::xcb::errc>(code);
-        ICE_TRACE_FORMAT("xcb_wait_for_event: {}", e);
-      }
-    }
-    self_.reset();
-    return e;
+    return display_->run();
   }
 
-  void handle(xcb_generic_event_t* event) noexcept
+  void handle(xcb_generic_event_t* event) noexcept override
   {
+    if (!id_) {
+      return;
+    }
     switch (XCB_EVENT_RESPONSE_TYPE(event)) {
     case XCB_CLIENT_MESSAGE: {
       const auto e = reinterpret_cast<const xcb_client_message_event_t*>(event);
-      if (e->window == id_ && e->data.data32[0] == wm_delete_window_->atom) {
+      const auto wm_delete_window = display_->get(ice::os::xcb::display::atom::wm_delete_window);
+      if (e->window == id_ && e->data.data32[0] == wm_delete_window) {
         if (auto window = window_.load(std::memory_order_acquire)) {
           window->on_close();
         } else {
@@ -264,35 +290,111 @@ public:
         }
       }
     } break;
-    case XCB_EXPOSE:
-    case XCB_REPARENT_NOTIFY:
-    case XCB_MAP_NOTIFY: {
+    case XCB_EXPOSE: {
+      const auto e = reinterpret_cast<const xcb_expose_event_t*>(event);
       if (context_) {
-        context_->render();
+        context_->expose(e->x, e->y, e->width, e->height);
       }
     } break;
+    case XCB_REPARENT_NOTIFY:
+    case XCB_MAP_NOTIFY:
+      update_ = true;
+      break;
     case XCB_CONFIGURE_NOTIFY: {
       const auto e = reinterpret_cast<xcb_configure_notify_event_t*>(event);
       if (context_) {
-        context_->resize(e->width, e->height);
+        if (const auto error = context_->resize(e->width, e->height)) {
+          ICE_TRACE_FORMAT("Could not resize XCB context: {}", error);
+        }
       }
+      update_ = true;
     } break;
     default:
       if (context_) {
         context_->handle(event);
       }
+      update_ = true;
       break;
     }
   }
 
+  // Renders the next frame after all pending events were handled.
+  // Replayed frames are rendered without waiting for window events.
+  bool idle() noexcept override
+  {
+    if (!id_) {
+      return false;
+    }
+    if (context_ && context_->replaying()) {
+      replay();
+      return id_ && context_->replaying();
+    }
+    if (update_) {
+      render();
+    }
+    return false;
+  }
+
+  // Renders the next recorded frame or reports the end of the recording.
+  void replay() noexcept
+  {
+    if (context_->replay()) {
+      replay_frames_++;
+      render();
+      return;
+    }
+    const auto duration = std::chrono::steady_clock::now() - replay_start_;
+    if (auto window = window_.load(std::memory_order_acquire)) {
+      window->on_replay(replay_frames_, duration);
+    }
+  }
+
+  // Builds the next frame after all pending events were handled.
+  // Frames without changes to the command list are not presented.
+  void render() noexcept
+  {
+    update_ = false;
+    if (!context_) {
+      return;
+    }
+    context_->input_end();
+    const auto cx = context_->cx();
+    const auto cy = context_->cy();
+    if (context_->begin("root", nk_rect(0.0f, 0.0f, cx, cy), NK_WINDOW_SCROLL_AUTO_HIDE)) {
+      if (auto window = window_.load(std::memory_order_acquire)) {
+        window->on_render(*context_);
+      }
+    }
+    context_->end();
+    // Windows that were destroyed in on_render are not presented.
+    if (id_) {
+      context_->render();
+    }
+    context_->clear();
+    context_->input_begin();
+  }
+
 private:
-  std::shared_ptr<window> self_;
+  // Replaces a window property. Properties with atoms that could not be interned are skipped.
+  void property(xcb_window_t id, ice::os::xcb::display::atom name, xcb_atom_t type, uint8_t format, uint32_t size,
+    const void* data) noexcept
+  {
+    if (const auto atom = display_->get(name)) {
+      xcb_change_property(connection_, XCB_PROP_MODE_REPLACE, id, atom, type, format, size, data);
+    }
+  }
+
+  std::shared_ptr<ice::os::xcb::display> display_;
   std::atomic<ice::window*> window_;
   std::unique_ptr<ice::os::xcb::context> context_;
 
   xcb_window_t id_{};
+  uint8_t depth_{};
+  bool update_{ false };
+  ice::window::render render_{ ice::window::render::direct };
+  std::size_t replay_frames_{ 0 };
+  std::chrono::steady_clock::time_point replay_start_;
   xcb_connection_t* connection_{};
-  xcb_intern_atom_reply_t* wm_delete_window_{};
 };
 
 }  // namespace ice::os::xcb
@@ -1,7 +1,10 @@
 #pragma once
 #include <ice/coroutine.hpp>
 #include <ice/error.hpp>
+#include <functional>
 #include <type_traits>
+#include <cstddef>
+#include <cstdint>
 #include <utility>
 
 namespace ice {
@@ -20,10 +23,29 @@ concept ResultValueType =
 
 // clang-format on
 
+template <ResultValueType T>
+class result;
+
+template <typename T>
+struct is_result : std::false_type {};
+
+template <typename T>
+struct is_result<result<T>> : std::true_type {};
+
+template <typename T>
+constexpr bool is_result_v = is_result<T>::value;
+
+template <typename T>
+concept Result = is_result_v<std::remove_cvref_t<T>>;
+
 // ================================================================================================
 // result
 // ================================================================================================
 
+// Holds a value or an error.
+// Errors are propagated with co_await in coroutines that return a result, or without a coroutine frame with ICE_TRY,
+// ICE_TRY_ASSIGN and the and_then, transform and or_else members, which compile to a branch and a return.
+
 template <ResultValueType T>
 class result {
 public:
@@ -93,6 +115,7 @@ public:
   {}
 
   template <ResultValueType Value, typename... Args>
+  requires(!std::is_same_v<std::remove_cvref_t<Value>, result>)
   constexpr result(Value&& rv, Args&&... args) noexcept
   {
     new (static_cast<void*>(&value_)) value_type(std::forward<Value>(rv), std::forward<Args>(args)...);
@@ -255,7 +278,87 @@ public:
 
   constexpr void await_resume() const noexcept
   {
-    ICE_ASSERT(error_);
+    ICE_ASSERT(!error_);
+  }
+
+  // Calls the function with the value and returns the result of the function or the error.
+  template <typename Function>
+  constexpr auto and_then(Function&& function) const& noexcept
+  {
+    using type = std::remove_cvref_t<std::invoke_result_t<Function, const value_type&>>;
+    static_assert(Result<type>, "The function must return an ice::result.");
+    if (ICE_LIKELY(!error_)) {
+      return type(std::invoke(std::forward<Function>(function), value()));
+    }
+    return type(error());
+  }
+
+  template <typename Function>
+  constexpr auto and_then(Function&& function) && noexcept
+  {
+    using type = std::remove_cvref_t<std::invoke_result_t<Function, value_type&&>>;
+    static_assert(Result<type>, "The function must return an ice::result.");
+    if (ICE_LIKELY(!error_)) {
+      return type(std::invoke(std::forward<Function>(function), std::move(*this).value()));
+    }
+    return type(error());
+  }
+
+  // Calls the function with the value and returns the return value of the function as a result or the error.
+  template <typename Function>
+  constexpr auto transform(Function&& function) const& noexcept
+  {
+    using type = std::remove_cvref_t<std::invoke_result_t<Function, const value_type&>>;
+    if constexpr (std::is_void_v<type>) {
+      if (ICE_LIKELY(!error_)) {
+        std::invoke(std::forward<Function>(function), value());
+        return ice::result<void>();
+      }
+      return ice::result<void>(error());
+    } else {
+      if (ICE_LIKELY(!error_)) {
+        return ice::result<type>(std::invoke(std::forward<Function>(function), value()));
+      }
+      return ice::result<type>(error());
+    }
+  }
+
+  template <typename Function>
+  constexpr auto transform(Function&& function) && noexcept
+  {
+    using type = std::remove_cvref_t<std::invoke_result_t<Function, value_type&&>>;
+    if constexpr (std::is_void_v<type>) {
+      if (ICE_LIKELY(!error_)) {
+        std::invoke(std::forward<Function>(function), std::move(*this).value());
+        return ice::result<void>();
+      }
+      return ice::result<void>(error());
+    } else {
+      if (ICE_LIKELY(!error_)) {
+        return ice::result<type>(std::invoke(std::forward<Function>(function), std::move(*this).value()));
+      }
+      return ice::result<type>(error());
+    }
+  }
+
+  // Returns the value or calls the function with the error and returns the return value of the function as a result.
+  // The function can recover with a value or return the same or a different error.
+  template <typename Function>
+  constexpr result or_else(Function&& function) const& noexcept
+  {
+    if (ICE_LIKELY(!error_)) {
+      return *this;
+    }
+    return result(std::invoke(std::forward<Function>(function), error()));
+  }
+
+  template <typename Function>
+  constexpr result or_else(Function&& function) && noexcept
+  {
+    if (ICE_LIKELY(!error_)) {
+      return std::move(*this);
+    }
+    return result(std::invoke(std::forward<Function>(function), error()));
   }
 
 private:
@@ -277,6 +380,402 @@ private:
   };
 };
 
+// ------------------------------------------------------------------------------------------------
+// result (packed specialization)
+// ------------------------------------------------------------------------------------------------
+
+// Results of small trivially copyable values and pointers are the size of a single 64-bit word and are trivially
+// copyable themselves, so that they are returned in a register.
+// The error is encoded in a 32-bit index (see ice::detail::error_index). Small values are stored next to the index.
+// Pointers to types with an alignment of at least two mark errors with the lowest bit, which is never set in a valid
+// pointer to such a type, and store the index in the higher bits. Unlike the highest bit, the lowest bit is not used
+// for pointer tags (AArch64 TBI and MTE, x86-64 LAM).
+
+namespace detail {
+
+// clang-format off
+
+template <typename T>
+concept ResultSmallType =
+  std::is_default_constructible_v<T> &&
+  std::is_trivially_move_constructible_v<T> &&
+  std::is_trivially_copy_constructible_v<T> &&
+  std::is_trivially_move_assignable_v<T> &&
+  std::is_trivially_copy_assignable_v<T> &&
+  std::is_trivially_destructible_v<T> &&
+  sizeof(T) <= 4 && alignof(T) <= 4;
+
+// clang-format on
+
+template <typename T>
+concept ResultAlignedType = requires {
+  requires std::is_object_v<T>;
+  requires alignof(T) >= 2;
+};
+
+template <typename T>
+concept ResultPointerType = std::is_pointer_v<T> && sizeof(T) == 8 && ResultAlignedType<std::remove_pointer_t<T>>;
+
+template <typename T>
+concept ResultPackedType = ResultSmallType<T> || ResultPointerType<T>;
+
+template <typename T>
+struct result_layout {
+  T value{};
+  std::uint32_t index{ 0 };
+
+  constexpr result_layout() noexcept = default;
+
+  constexpr result_layout(T value) noexcept
+    : value(value)
+  {}
+
+  constexpr result_layout(std::uint32_t index, std::nullptr_t) noexcept
+    : index(index)
+  {}
+
+  constexpr std::uint32_t error() const noexcept
+  {
+    return index;
+  }
+};
+
+template <ResultPointerType T>
+struct result_layout<T> {
+  static constexpr std::uintptr_t mask = 1;
+
+  T value{ nullptr };
+
+  constexpr result_layout() noexcept = default;
+
+  constexpr result_layout(T value) noexcept
+    : value(value)
+  {}
+
+  result_layout(std::uint32_t index, std::nullptr_t) noexcept
+    : value(reinterpret_cast<T>(std::uintptr_t(index) << 1 | mask))
+  {}
+
+  std::uint32_t error() const noexcept
+  {
+    const auto bits = reinterpret_cast<std::uintptr_t>(value);
+    return bits & mask ? static_cast<std::uint32_t>(bits >> 1) : 0;
+  }
+};
+
+}  // namespace detail
+
+template <ResultValueType T>
+requires(detail::ResultPackedType<std::remove_cvref_t<T>>)
+class result<T> {
+public:
+  using value_type = std::remove_cvref_t<T>;
+
+  class return_object;
+
+  struct promise_type : ice::promise_base {
+    constexpr return_object get_return_object() noexcept
+    {
+      return return_object{ this };
+    }
+
+    static constexpr auto initial_suspend() noexcept
+    {
+      return ice::suspend_never{};
+    }
+
+    static constexpr auto final_suspend() noexcept
+    {
+      return ice::suspend_never{};
+    }
+
+    template <typename Arg, typename... Args>
+    constexpr void return_value(Arg&& arg, Args&&... args) noexcept
+    {
+      if constexpr (Error<Arg> || ErrorCode<Arg> || ErrorCodeType<Arg>) {
+        result_ptr->return_error({ std::forward<Arg>(arg), std::forward<Args>(args)... });
+      } else {
+        result_ptr->return_value(std::forward<Arg>(arg), std::forward<Args>(args)...);
+      }
+    }
+
+    constexpr void return_value(value_type rv) noexcept
+    {
+      result_ptr->return_value(rv);
+    }
+
+    constexpr void return_error(ice::error e) noexcept
+    {
+      result_ptr->return_error(e);
+    }
+
+    result* result_ptr = nullptr;
+  };
+
+  // Holds the result while the coroutine runs and is converted to the result when the coroutine returns to the
+  // caller. The promise refers to it by address, which is stable, because it can not be copied or moved.
+  class return_object {
+  public:
+    explicit constexpr return_object(promise_type* promise) noexcept
+    {
+      result_.layout_ = detail::result_layout<value_type>(detail::error_index_invalid_result_value, nullptr);
+      promise->result_ptr = &result_;
+    }
+
+    return_object(return_object&& other) = delete;
+    return_object(const return_object& other) = delete;
+    return_object& operator=(return_object&& other) = delete;
+    return_object& operator=(const return_object& other) = delete;
+
+    ~return_object() = default;
+
+    constexpr operator result() const noexcept
+    {
+      return result_;
+    }
+
+  private:
+    result result_;
+  };
+
+  template <ErrorCodeType E>
+  constexpr result(E ev) noexcept
+    : layout_(index(make_error<E>(ev)), nullptr)
+  {}
+
+  template <ErrorCodeType E>
+  constexpr result(ice::error_code<E> ec) noexcept
+    : layout_(index(make_error(ec)), nullptr)
+  {}
+
+  constexpr result(ice::error e) noexcept
+    : layout_(index(e), nullptr)
+  {}
+
+  result(std::error_code ec) noexcept
+    : layout_(index(make_error(ec)), nullptr)
+  {}
+
+  template <ResultValueType Value, typename... Args>
+  requires(!std::is_same_v<std::remove_cvref_t<Value>, result> &&
+           !std::is_same_v<std::remove_cvref_t<Value>, return_object>)
+  constexpr result(Value&& rv, Args&&... args) noexcept
+    : layout_(value_type(std::forward<Value>(rv), std::forward<Args>(args)...))
+  {}
+
+  constexpr result() noexcept = default;
+  constexpr result(result&& other) noexcept = default;
+  constexpr result(const result& other) noexcept = default;
+  constexpr result& operator=(result&& other) noexcept = default;
+  constexpr result& operator=(const result& other) noexcept = default;
+
+  ~result() = default;
+
+  constexpr explicit operator bool() const noexcept
+  {
+    return !layout_.error();
+  }
+
+  constexpr value_type* operator->() noexcept
+  {
+    ICE_ASSERT(!layout_.error());
+    return &layout_.value;
+  }
+
+  constexpr const value_type* operator->() const noexcept
+  {
+    ICE_ASSERT(!layout_.error());
+    return &layout_.value;
+  }
+
+  constexpr value_type& operator*() & noexcept
+  {
+    ICE_ASSERT(!layout_.error());
+    return layout_.value;
+  }
+
+  constexpr value_type&& operator*() && noexcept
+  {
+    ICE_ASSERT(!layout_.error());
+    return std::move(layout_.value);
+  }
+
+  constexpr const value_type& operator*() const& noexcept
+  {
+    ICE_ASSERT(!layout_.error());
+    return layout_.value;
+  }
+
+  constexpr const value_type&& operator*() const&& noexcept
+  {
+    ICE_ASSERT(!layout_.error());
+    return std::move(layout_.value);
+  }
+
+  constexpr value_type& value() & noexcept
+  {
+    ICE_ASSERT(!layout_.error());
+    return layout_.value;
+  }
+
+  constexpr value_type&& value() && noexcept
+  {
+    ICE_ASSERT(!layout_.error());
+    return std::move(layout_.value);
+  }
+
+  constexpr const value_type& value() const& noexcept
+  {
+    ICE_ASSERT(!layout_.error());
+    return layout_.value;
+  }
+
+  constexpr const value_type&& value() const&& noexcept
+  {
+    ICE_ASSERT(!layout_.error());
+    return std::move(layout_.value);
+  }
+
+  constexpr ice::error error() const noexcept
+  {
+    if (const auto index = layout_.error(); ICE_UNLIKELY(index)) {
+      return detail::error_value(index);
+    }
+    return {};
+  }
+
+  constexpr ice::error_type type() const noexcept
+  {
+    return error().type();
+  }
+
+  constexpr int code() const noexcept
+  {
+    return error().code();
+  }
+
+  constexpr bool await_ready() const noexcept
+  {
+    return !layout_.error();
+  }
+
+  template <typename Promise>
+  constexpr bool await_suspend(ice::coroutine_handle<Promise> handle) noexcept
+  {
+    ICE_ASSERT(layout_.error());
+    handle.promise().return_error(error());
+    return true;
+  }
+
+  constexpr void await_resume() const noexcept
+  {
+    ICE_ASSERT(!layout_.error());
+  }
+
+  // Calls the function with the value and returns the result of the function or the error.
+  template <typename Function>
+  constexpr auto and_then(Function&& function) const& noexcept
+  {
+    using type = std::remove_cvref_t<std::invoke_result_t<Function, const value_type&>>;
+    static_assert(Result<type>, "The function must return an ice::result.");
+    if (ICE_LIKELY(!layout_.error())) {
+      return type(std::invoke(std::forward<Function>(function), value()));
+    }
+    return type(error());
+  }
+
+  template <typename Function>
+  constexpr auto and_then(Function&& function) && noexcept
+  {
+    using type = std::remove_cvref_t<std::invoke_result_t<Function, value_type&&>>;
+    static_assert(Result<type>, "The function must return an ice::result.");
+    if (ICE_LIKELY(!layout_.error())) {
+      return type(std::invoke(std::forward<Function>(function), std::move(*this).value()));
+    }
+    return type(error());
+  }
+
+  // Calls the function with the value and returns the return value of the function as a result or the error.
+  template <typename Function>
+  constexpr auto transform(Function&& function) const& noexcept
+  {
+    using type = std::remove_cvref_t<std::invoke_result_t<Function, const value_type&>>;
+    if constexpr (std::is_void_v<type>) {
+      if (ICE_LIKELY(!layout_.error())) {
+        std::invoke(std::forward<Function>(function), value());
+        return ice::result<void>();
+      }
+      return ice::result<void>(error());
+    } else {
+      if (ICE_LIKELY(!layout_.error())) {
+        return ice::result<type>(std::invoke(std::forward<Function>(function), value()));
+      }
+      return ice::result<type>(error());
+    }
+  }
+
+  template <typename Function>
+  constexpr auto transform(Function&& function) && noexcept
+  {
+    using type = std::remove_cvref_t<std::invoke_result_t<Function, value_type&&>>;
+    if constexpr (std::is_void_v<type>) {
+      if (ICE_LIKELY(!layout_.error())) {
+        std::invoke(std::forward<Function>(function), std::move(*this).value());
+        return ice::result<void>();
+      }
+      return ice::result<void>(error());
+    } else {
+      if (ICE_LIKELY(!layout_.error())) {
+        return ice::result<type>(std::invoke(std::forward<Function>(function), std::move(*this).value()));
+      }
+      return ice::result<type>(error());
+    }
+  }
+
+  // Returns the value or calls the function with the error and returns the return value of the function as a result.
+  // The function can recover with a value or return the same or a different error.
+  template <typename Function>
+  constexpr result or_else(Function&& function) const& noexcept
+  {
+    if (ICE_LIKELY(!layout_.error())) {
+      return *this;
+    }
+    return result(std::invoke(std::forward<Function>(function), error()));
+  }
+
+  template <typename Function>
+  constexpr result or_else(Function&& function) && noexcept
+  {
+    if (ICE_LIKELY(!layout_.error())) {
+      return std::move(*this);
+    }
+    return result(std::invoke(std::forward<Function>(function), error()));
+  }
+
+private:
+  static constexpr std::uint32_t index(ice::error e) noexcept
+  {
+    return ICE_LIKELY(static_cast<bool>(e)) ? detail::error_index(e) : detail::error_index_invalid_result_value;
+  }
+
+  template <typename... Args>
+  constexpr void return_value(Args&&... args) noexcept
+  {
+    layout_ = detail::result_layout<value_type>(value_type(std::forward<Args>(args)...));
+  }
+
+  constexpr void return_error(ice::error e) noexcept
+  {
+    layout_ = detail::result_layout<value_type>(index(e), nullptr);
+  }
+
+  detail::result_layout<value_type> layout_;
+};
+
+static_assert(std::is_trivially_copyable_v<ice::result<int>>);
+static_assert(std::is_trivially_destructible_v<ice::result<int>>);
+static_assert(std::is_trivially_copyable_v<ice::result<int*>>);
+
 // ------------------------------------------------------------------------------------------------
 // result (void specialization)
 // ------------------------------------------------------------------------------------------------
@@ -391,7 +890,47 @@ public:
 
   constexpr void await_resume() const noexcept  // NOLINT(readability-convert-member-functions-to-static)
   {
-    ICE_ASSERT(error_);
+    ICE_ASSERT(!error_);
+  }
+
+  // Calls the function and returns the result of the function or the error.
+  template <typename Function>
+  constexpr auto and_then(Function&& function) const noexcept
+  {
+    using type = std::remove_cvref_t<std::invoke_result_t<Function>>;
+    static_assert(Result<type>, "The function must return an ice::result.");
+    if (ICE_LIKELY(!error_)) {
+      return type(std::invoke(std::forward<Function>(function)));
+    }
+    return type(error_);
+  }
+
+  // Calls the function and returns the return value of the function as a result or the error.
+  template <typename Function>
+  constexpr auto transform(Function&& function) const noexcept
+  {
+    using type = std::remove_cvref_t<std::invoke_result_t<Function>>;
+    if constexpr (std::is_void_v<type>) {
+      if (ICE_LIKELY(!error_)) {
+        std::invoke(std::forward<Function>(function));
+      }
+      return *this;
+    } else {
+      if (ICE_LIKELY(!error_)) {
+        return ice::result<type>(std::invoke(std::forward<Function>(function)));
+      }
+      return ice::result<type>(error_);
+    }
+  }
+
+  // Returns success or calls the function with the error and returns the return value of the function as a result.
+  template <typename Function>
+  constexpr result or_else(Function&& function) const noexcept
+  {
+    if (ICE_LIKELY(!error_)) {
+      return *this;
+    }
+    return result(std::invoke(std::forward<Function>(function), error_));
   }
 
 private:
@@ -426,4 +965,58 @@ constexpr bool operator==(const ice::result<T>& lhs, ice::error rhs) noexcept
   return lhs.error() == rhs;
 }
 
+// ================================================================================================
+// try
+// ================================================================================================
+
+// Returns the error of an error, error code or result from the current function.
+// Unlike co_await, these macros do not require the function to be a coroutine and compile to a branch and a return.
+//
+//   ice::result<int> parse(std::string_view text) noexcept;
+//
+//   ice::result<int> sum(std::string_view lhs, std::string_view rhs) noexcept
+//   {
+//     ICE_TRY(validate(lhs));
+//     ICE_TRY_ASSIGN(const auto value, parse(lhs));
+//     return parse(rhs).transform([&](int other) noexcept {
+//       return value + other;
+//     });
+//   }
+
+namespace detail {
+
+template <typename T>
+constexpr ice::error result_error(const T& value) noexcept
+{
+  if constexpr (Result<T>) {
+    return value.error();
+  } else {
+    return ice::error(value);
+  }
+}
+
+}  // namespace detail
+
 }  // namespace ice
+
+// Returns the error from the current function if the expression failed.
+#define ICE_TRY(expression)                                                \
+  if (const auto ice_try_error = ice::detail::result_error(expression);    \
+      ICE_UNLIKELY(static_cast<bool>(ice_try_error))) {                    \
+    return ice_try_error;                                                  \
+  }                                                                        \
+  static_cast<void>(0)
+
+// Declares or assigns the value of the result or returns the error from the current function.
+#define ICE_TRY_ASSIGN(declaration, expression) \
+  ICE_TRY_ASSIGN_IMPL(ICE_TRY_CONCAT(ice_try_result_, __LINE__), declaration, expression)
+
+#define ICE_TRY_ASSIGN_IMPL(name, declaration, expression) \
+  auto name = (expression);                                \
+  if (ICE_UNLIKELY(!static_cast<bool>(name))) {            \
+    return name.error();                                   \
+  }                                                        \
+  declaration = *std::move(name)
+
+#define ICE_TRY_CONCAT(lhs, rhs) ICE_TRY_CONCAT_IMPL(lhs, rhs)
+#define ICE_TRY_CONCAT_IMPL(lhs, rhs) lhs##rhs
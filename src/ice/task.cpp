@@ -1,5 +1,8 @@
 #include "task.hpp"
+#include <ice/backtrace.hpp>
+#include <ice/error_context.hpp>
 #include <ice/format.hpp>
+#include <ice/logger.hpp>
 #include <cstdio>
 #include <cstdlib>
 
@@ -7,11 +10,14 @@ namespace ice {
 
 void task::promise_type::return_error(ice::error error) noexcept
 {
+  const auto backtrace = ice::backtrace::capture();
+  ice::logger::flush();
   fmt::print(stderr, "unhandled {} error: {}\n", error.type(), error);
-  std::fflush(stderr);
-  {
-    // TODO: Print stack trace.
+  if (const auto context = ice::error_context::get(error); !context.empty()) {
+    fmt::print(stderr, "context:\n{}", context);
   }
+  backtrace.print(stderr);
+  std::fflush(stderr);
   std::abort();
 }
 
@@ -0,0 +1,178 @@
+#include "arena.hpp"
+#include <ice/os/nuklear.hpp>
+#include <algorithm>
+#include <new>
+
+namespace ice::ui {
+namespace {
+
+// Size of the smallest pool block including the header.
+constexpr std::size_t minimum = 64;
+
+// Size of the pool header, which keeps the block memory aligned.
+constexpr std::size_t header = 16;
+
+// Size of the chunks that pool blocks are carved from.
+constexpr std::size_t chunk_size = 64 * 1024;
+
+}  // namespace
+
+ice::error arena::create(nk_context* context, const nk_user_font* font, std::size_t frame) noexcept
+{
+  static_assert(sizeof(block) <= header);
+  if (frame_) {
+    return ice::errc::context_not_empty;
+  }
+  frame_size_ = std::max(frame, std::size_t(4 * 1024));
+  frame_.reset(new (std::nothrow) std::byte[frame_size_]);
+  if (!frame_) {
+    frame_size_ = 0;
+    return std::errc::not_enough_memory;
+  }
+  stats_.allocations++;
+  stats_.reserved += frame_size_;
+
+  nk_allocator frame_allocator{};
+  frame_allocator.userdata = nk_handle_ptr(this);
+  frame_allocator.alloc = [](nk_handle handle, void* old, nk_size size) noexcept {
+    return static_cast<arena*>(handle.ptr)->frame_alloc(old, size);
+  };
+  frame_allocator.free = [](nk_handle handle, void* memory) noexcept {
+    static_cast<arena*>(handle.ptr)->frame_free(memory);
+  };
+
+  nk_allocator pool_allocator{};
+  pool_allocator.userdata = nk_handle_ptr(this);
+  pool_allocator.alloc = [](nk_handle handle, void*, nk_size size) noexcept {
+    return static_cast<arena*>(handle.ptr)->pool_alloc(size);
+  };
+  pool_allocator.free = [](nk_handle handle, void* memory) noexcept {
+    static_cast<arena*>(handle.ptr)->pool_free(memory);
+  };
+
+  nk_buffer commands{};
+  nk_buffer_init(&commands, &frame_allocator, frame_size_);
+  nk_buffer pool{};
+  pool.pool = pool_allocator;
+  pool.type = NK_BUFFER_DYNAMIC;
+  if (!nk_init_custom(context, &commands, &pool, font)) {
+    return ice::errc::not_available;
+  }
+  return {};
+}
+
+void arena::clear(nk_context* context) noexcept
+{
+  nk_memory_status status{};
+  nk_buffer_info(&status, &context->memory);
+  frame_used_ = status.allocated;
+  update();
+  nk_clear(context);
+}
+
+// The command buffer grows in place while it fits into the frame region. Otherwise, the frame region is replaced
+// with a larger one and the old region is kept until nuklear copied the commands and released it.
+void* arena::frame_alloc(void* old, std::size_t size) noexcept
+{
+  if (size <= frame_size_) {
+    return frame_.get();
+  }
+  const auto frame_size = std::max(size, frame_size_ * 2);
+  std::unique_ptr<std::byte[]> frame(new (std::nothrow) std::byte[frame_size]);
+  if (!frame) {
+    return nullptr;
+  }
+  stats_.allocations++;
+  stats_.reserved += frame_size;
+  if (old) {
+    previous_ = std::move(frame_);
+    previous_size_ = frame_size_;
+  } else {
+    stats_.reserved -= frame_size_;
+  }
+  frame_ = std::move(frame);
+  frame_size_ = frame_size;
+  return frame_.get();
+}
+
+// The frame region is owned by the arena and released with it.
+void arena::frame_free(void* memory) noexcept
+{
+  if (memory && memory == previous_.get()) {
+    stats_.reserved -= previous_size_;
+    previous_.reset();
+    previous_size_ = 0;
+  }
+}
+
+void* arena::pool_alloc(std::size_t size) noexcept
+{
+  std::size_t index = 0;
+  while (index < classes && (minimum << index) < size + header) {
+    index++;
+  }
+  if (index == classes) {
+    return nullptr;
+  }
+  const auto total = minimum << index;
+  auto b = free_[index];
+  if (b) {
+    free_[index] = b->next;
+  } else {
+    std::byte* memory = nullptr;
+    if (total >= chunk_size) {
+      memory = reserve(total);
+    } else {
+      if (chunk_left_ < total) {
+        chunk_ = reserve(chunk_size);
+        chunk_left_ = chunk_ ? chunk_size : 0;
+      }
+      if (chunk_) {
+        memory = chunk_;
+        chunk_ += total;
+        chunk_left_ -= total;
+      }
+    }
+    if (!memory) {
+      return nullptr;
+    }
+    b = new (memory) block{};
+  }
+  b->next = nullptr;
+  b->index = index;
+  pool_used_ += total;
+  update();
+  return reinterpret_cast<std::byte*>(b) + header;
+}
+
+void arena::pool_free(void* memory) noexcept
+{
+  if (!memory) {
+    return;
+  }
+  const auto b = reinterpret_cast<block*>(static_cast<std::byte*>(memory) - header);
+  pool_used_ -= minimum << b->index;
+  b->next = free_[b->index];
+  free_[b->index] = b;
+  update();
+}
+
+std::byte* arena::reserve(std::size_t size) noexcept
+{
+  std::unique_ptr<std::byte[]> chunk(new (std::nothrow) std::byte[size]);
+  if (!chunk) {
+    return nullptr;
+  }
+  stats_.allocations++;
+  stats_.reserved += size;
+  chunks_.push_back(std::move(chunk));
+  return chunks_.back().get();
+}
+
+void arena::update() noexcept
+{
+  stats_.current = frame_used_ + pool_used_;
+  stats_.peak = std::max(stats_.peak, stats_.current);
+}
+
+}  // namespace ice::ui
@@ -0,0 +1,88 @@
+#pragma once
+#include <ice/error.hpp>
+#include <array>
+#include <memory>
+#include <vector>
+#include <cstddef>
+
+extern "C" struct nk_context;
+extern "C" struct nk_user_font;
+
+namespace ice::ui {
+
+// ================================================================================================
+// arena
+// ================================================================================================
+
+// Memory of a nuklear context.
+// The command buffer lives in a frame region that nuklear fills front to back and rewinds in every clear call.
+// Window, panel and table pages are taken from a pool of power of two size classes that reuses freed blocks.
+// Once the frame region fits the largest frame, frames do not allocate heap memory.
+
+class ICE_API arena {
+public:
+  struct statistics {
+    // Bytes used by the commands of the last frame and by live pool blocks.
+    std::size_t current{ 0 };
+
+    // Highest value of current since the arena was created.
+    std::size_t peak{ 0 };
+
+    // Bytes allocated from the heap and owned by the arena.
+    std::size_t reserved{ 0 };
+
+    // Number of heap allocations made by the arena.
+    std::size_t allocations{ 0 };
+  };
+
+  arena() noexcept = default;
+  arena(arena&& other) = delete;
+  arena(const arena& other) = delete;
+  arena& operator=(arena&& other) = delete;
+  arena& operator=(const arena& other) = delete;
+  ~arena() = default;
+
+  // Initializes the context with memory from this arena. Only one context can use an arena and the arena must
+  // outlive the context until nk_free is called.
+  ice::error create(nk_context* context, const nk_user_font* font, std::size_t frame = 64 * 1024) noexcept;
+
+  // Records the memory used by the frame and calls nk_clear.
+  void clear(nk_context* context) noexcept;
+
+  const statistics& stats() const noexcept
+  {
+    return stats_;
+  }
+
+private:
+  static constexpr std::size_t classes = 32;
+
+  struct block {
+    block* next{ nullptr };
+    std::size_t index{ 0 };
+  };
+
+  void* frame_alloc(void* old, std::size_t size) noexcept;
+  void frame_free(void* memory) noexcept;
+
+  void* pool_alloc(std::size_t size) noexcept;
+  void pool_free(void* memory) noexcept;
+
+  std::byte* reserve(std::size_t size) noexcept;
+  void update() noexcept;
+
+  std::unique_ptr<std::byte[]> frame_;
+  std::unique_ptr<std::byte[]> previous_;
+  std::size_t frame_size_{ 0 };
+  std::size_t previous_size_{ 0 };
+  std::size_t frame_used_{ 0 };
+  std::size_t pool_used_{ 0 };
+
+  std::vector<std::unique_ptr<std::byte[]>> chunks_;
+  std::byte* chunk_{ nullptr };
+  std::size_t chunk_left_{ 0 };
+  std::array<block*, classes> free_{};
+  statistics stats_;
+};
+
+}  // namespace ice::ui
@@ -0,0 +1,128 @@
+#include "atlas.hpp"
+#include <algorithm>
+#include <new>
+
+namespace ice::ui {
+namespace {
+
+// Empty space between glyphs and shelves.
+constexpr int padding = 1;
+
+}  // namespace
+
+ice::error atlas::create(int cx, int cy) noexcept
+{
+  if (cx <= 0 || cy <= 0) {
+    return std::errc::invalid_argument;
+  }
+  const auto size = static_cast<std::size_t>(cx) * static_cast<std::size_t>(cy);
+  data_.reset(new (std::nothrow) std::uint8_t[size]);
+  if (!data_) {
+    cx_ = 0;
+    cy_ = 0;
+    return std::errc::not_enough_memory;
+  }
+  std::fill_n(data_.get(), size, std::uint8_t{ 0 });
+  cx_ = cx;
+  cy_ = cy;
+  clear();
+  return {};
+}
+
+const atlas::entry* atlas::find(std::uint32_t key) const noexcept
+{
+  const auto it = entries_.find(key);
+  return it != entries_.end() ? &it->second : nullptr;
+}
+
+void atlas::touch(const entry& entry) noexcept
+{
+  if (entry.shelf >= 0) {
+    shelves_[static_cast<std::size_t>(entry.shelf)].used = ++tick_;
+  }
+}
+
+const atlas::entry* atlas::insert(std::uint32_t key, int cx, int cy, int dx, int dy) noexcept
+{
+  if (const auto it = entries_.find(key); it != entries_.end()) {
+    touch(it->second);
+    return &it->second;
+  }
+  entry entry{ 0, 0, std::max(cx, 0), std::max(cy, 0), dx, dy, -1 };
+  if (entry.cx > 0 && entry.cy > 0) {
+    const auto index = place(entry.cx, entry.cy);
+    if (index < 0) {
+      return nullptr;
+    }
+    auto& shelf = shelves_[static_cast<std::size_t>(index)];
+    entry.x = shelf.x;
+    entry.y = shelf.y;
+    entry.shelf = index;
+    shelf.x += entry.cx + padding;
+    shelf.used = ++tick_;
+    shelf.keys.push_back(key);
+  }
+  return &entries_.emplace(key, entry).first->second;
+}
+
+void atlas::clear() noexcept
+{
+  top_ = 0;
+  shelves_.clear();
+  entries_.clear();
+}
+
+// Returns the index of a shelf with enough room for the glyph or -1 if the glyph does not fit into the texture.
+int atlas::place(int cx, int cy) noexcept
+{
+  const auto w = cx + padding;
+  const auto h = cy + padding;
+  if (w > cx_ || h > cy_) {
+    return -1;
+  }
+
+  // Use the lowest shelf with enough room that does not waste more than half of its height.
+  int index = -1;
+  for (std::size_t i = 0; i < shelves_.size(); i++) {
+    const auto& shelf = shelves_[i];
+    if (shelf.cy >= h && shelf.cy <= h + h / 2 && shelf.x + w <= cx_) {
+      if (index < 0 || shelf.cy < shelves_[static_cast<std::size_t>(index)].cy) {
+        index = static_cast<int>(i);
+      }
+    }
+  }
+  if (index >= 0) {
+    return index;
+  }
+
+  // Open a new shelf. Heights are rounded up to improve reuse by glyphs of similar size.
+  if (top_ + h <= cy_) {
+    const auto height = std::min((h + 3) & ~3, cy_ - top_);
+    shelves_.push_back({ top_, height, 0, 0, {} });
+    top_ += height;
+    return static_cast<int>(shelves_.size() - 1);
+  }
+
+  // Evict the least recently used shelf that is high enough.
+  for (std::size_t i = 0; i < shelves_.size(); i++) {
+    const auto& shelf = shelves_[i];
+    if (shelf.cy >= h && (index < 0 || shelf.used < shelves_[static_cast<std::size_t>(index)].used)) {
+      index = static_cast<int>(i);
+    }
+  }
+  evictions_++;
+  if (index < 0) {
+    // All shelves are too low for the glyph.
+    clear();
+    return place(cx, cy);
+  }
+  auto& shelf = shelves_[static_cast<std::size_t>(index)];
+  for (const auto key : shelf.keys) {
+    entries_.erase(key);
+  }
+  shelf.keys.clear();
+  shelf.x = 0;
+  return index;
+}
+
+}  // namespace ice::ui
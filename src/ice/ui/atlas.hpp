@@ -0,0 +1,108 @@
+#pragma once
+#include <ice/error.hpp>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace ice::ui {
+
+// ================================================================================================
+// atlas
+// ================================================================================================
+
+// Glyph bitmap cache packed into shelves of a single 8-bit coverage texture.
+// When no shelf has room for a new glyph, the least recently used shelf is evicted with all of its glyphs.
+
+class ICE_API atlas {
+public:
+  struct entry {
+    int x{ 0 };
+    int y{ 0 };
+    int cx{ 0 };
+    int cy{ 0 };
+
+    // Offset of the bitmap relative to the glyph origin.
+    int dx{ 0 };
+    int dy{ 0 };
+
+    // Index of the shelf or -1 for empty glyphs, which do not use texture space.
+    int shelf{ -1 };
+  };
+
+  atlas() noexcept = default;
+  atlas(atlas&& other) = delete;
+  atlas(const atlas& other) = delete;
+  atlas& operator=(atlas&& other) = delete;
+  atlas& operator=(const atlas& other) = delete;
+  ~atlas() = default;
+
+  ice::error create(int cx, int cy) noexcept;
+
+  // Returns a cached entry without marking it as used.
+  const entry* find(std::uint32_t key) const noexcept;
+
+  // Marks the shelf of the entry as used.
+  void touch(const entry& entry) noexcept;
+
+  // Reserves texture space for a glyph and marks it as used. The caller must write all cx * cy pixels.
+  // Returns nullptr when the glyph is larger than the texture.
+  const entry* insert(std::uint32_t key, int cx, int cy, int dx, int dy) noexcept;
+
+  // Removes all entries.
+  void clear() noexcept;
+
+  std::uint8_t* data() noexcept
+  {
+    return data_.get();
+  }
+
+  const std::uint8_t* data() const noexcept
+  {
+    return data_.get();
+  }
+
+  constexpr int cx() const noexcept
+  {
+    return cx_;
+  }
+
+  constexpr int cy() const noexcept
+  {
+    return cy_;
+  }
+
+  std::size_t size() const noexcept
+  {
+    return entries_.size();
+  }
+
+  // Returns the number of evicted shelves.
+  constexpr std::size_t evictions() const noexcept
+  {
+    return evictions_;
+  }
+
+private:
+  struct shelf {
+    int y{ 0 };
+    int cy{ 0 };
+    int x{ 0 };
+    std::uint64_t used{ 0 };
+    std::vector<std::uint32_t> keys;
+  };
+
+  int place(int cx, int cy) noexcept;
+
+  std::unique_ptr<std::uint8_t[]> data_;
+  int cx_{ 0 };
+  int cy_{ 0 };
+  int top_{ 0 };
+  std::uint64_t tick_{ 0 };
+  std::size_t evictions_{ 0 };
+  std::vector<shelf> shelves_;
+  std::unordered_map<std::uint32_t, entry> entries_;
+};
+
+}  // namespace ice::ui
@@ -0,0 +1,219 @@
+#include "cache.hpp"
+#include <ice/os/nuklear.hpp>
+#include <algorithm>
+#include <iterator>
+#include <cmath>
+
+namespace ice::ui {
+
+bool cache::begin(nk_context* context, std::uint64_t id, std::uint64_t hash, float height) noexcept
+{
+  const auto window = context->current;
+  if (!window || !window->layout || current_) {
+    return false;
+  }
+
+  // Remove records that were not used in the previous frame.
+  if (context->seq != seq_) {
+    seq_ = context->seq;
+    for (auto it = records_.begin(); it != records_.end();) {
+      it = it->second.seq + 1 < seq_ ? records_.erase(it) : std::next(it);
+    }
+  }
+
+  // The row bounds do not include the scroll offset of the panel.
+  nk_layout_row_dynamic(context, height, 1);
+  auto row = nk_layout_widget_bounds(context);
+  const auto layout = window->layout;
+  row.x -= layout->offset_x ? static_cast<float>(*layout->offset_x) : 0.0f;
+  row.y -= layout->offset_y ? static_cast<float>(*layout->offset_y) : 0.0f;
+  const auto clip = layout->clip;
+  auto& record = records_[id];
+  record.seq = seq_;
+
+  // Skip rows that are not visible.
+  if (row.x >= clip.x + clip.w || row.y >= clip.y + clip.h || row.x + row.w <= clip.x || row.y + row.h <= clip.y) {
+    struct nk_rect bounds {};
+    nk_widget(&bounds, context);
+    return false;
+  }
+
+  // Replay the commands with the offset of the row when the layout did not change.
+  const auto dx = row.x - record.x;
+  const auto dy = row.y - record.y;
+  const auto& input = context->input;
+  auto hovered = nk_input_is_mouse_hovering_rect(&input, row) || nk_input_is_mouse_prev_hovering_rect(&input, row);
+  for (auto i = 0; i < NK_BUTTON_MAX && !hovered; i++) {
+    const auto& button = input.mouse.buttons[i];
+    hovered = (button.down || button.clicked) && nk_input_has_mouse_click_in_rect(&input, nk_buttons(i), row);
+  }
+  if (record.valid && record.hash == hash && record.w == row.w && record.h == row.h && !hovered &&
+      dx == std::floor(dx) && dy == std::floor(dy)) {
+    hits_++;
+    struct nk_rect bounds {};
+    if (nk_widget(&bounds, context) == NK_WIDGET_INVALID) {
+      return false;
+    }
+    const auto data = record.commands.data();
+    const auto size = record.commands.size();
+    for (std::size_t offset = 0; offset + sizeof(nk_command) <= size;) {
+      const auto command = reinterpret_cast<const nk_command*>(data + offset);
+      replay(&window->buffer, command, dx, dy, clip);
+      if (command->next <= record.start + offset) {
+        break;
+      }
+      offset = command->next - record.start;
+    }
+    nk_push_scissor(&window->buffer, clip);
+    return false;
+  }
+
+  // Build and record the subtree. Groups that are clipped can not be replayed at other offsets and groups that are
+  // hovered or pressed contain widget states that must not be replayed in later frames.
+  misses_++;
+  record.hash = hash;
+  record.x = row.x;
+  record.y = row.y;
+  record.w = row.w;
+  record.h = row.h;
+  record.valid = false;
+  record.commands.clear();
+  start_ = context->memory.allocated;
+  offsets_[0] = 0;
+  offsets_[1] = 0;
+  if (!nk_group_scrolled_offset_begin(context, &offsets_[0], &offsets_[1], "", NK_WINDOW_NO_SCROLLBAR)) {
+    return false;
+  }
+  const auto group = window->layout;
+  const auto visible = group->clip.x == group->bounds.x && group->clip.y == group->bounds.y &&
+    group->clip.w == group->bounds.w && group->clip.h == group->bounds.h;
+  current_ = visible && !hovered ? &record : nullptr;
+  return true;
+}
+
+void cache::end(nk_context* context) noexcept
+{
+  nk_group_scrolled_end(context);
+  if (!current_) {
+    return;
+  }
+  auto& record = *current_;
+  current_ = nullptr;
+
+  // Commands are aligned relative to the start of the context memory.
+  constexpr auto align = alignof(nk_command);
+  const auto first = (start_ + align - 1) & ~(align - 1);
+  const auto last = context->memory.allocated;
+  if (last > first) {
+    const auto data = static_cast<const std::byte*>(context->memory.memory.ptr);
+    record.commands.assign(data + first, data + last);
+  }
+  record.start = first;
+  record.valid = true;
+}
+
+void cache::clear() noexcept
+{
+  current_ = nullptr;
+  records_.clear();
+}
+
+void cache::replay(nk_command_buffer* b, const nk_command* command, float dx, float dy,
+  const struct nk_rect& clip) noexcept
+{
+  const auto box = [dx, dy](short x, short y, unsigned short w, unsigned short h) noexcept {
+    return nk_rect(x + dx, y + dy, w, h);
+  };
+  const auto points = [this, dx, dy](const struct nk_vec2i* points, unsigned short count) noexcept {
+    points_.resize(static_cast<std::size_t>(count) * 2);
+    for (std::size_t i = 0; i < count; i++) {
+      points_[i * 2 + 0] = points[i].x + dx;
+      points_[i * 2 + 1] = points[i].y + dy;
+    }
+    return points_.data();
+  };
+  switch (command->type) {
+  case NK_COMMAND_NOP:
+    break;
+  case NK_COMMAND_SCISSOR: {
+    const auto& c = *reinterpret_cast<const nk_command_scissor*>(command);
+    const auto x0 = std::max(c.x + dx, clip.x);
+    const auto y0 = std::max(c.y + dy, clip.y);
+    const auto x1 = std::min(c.x + dx + c.w, clip.x + clip.w);
+    const auto y1 = std::min(c.y + dy + c.h, clip.y + clip.h);
+    nk_push_scissor(b, nk_rect(x0, y0, std::max(x1 - x0, 0.0f), std::max(y1 - y0, 0.0f)));
+  } break;
+  case NK_COMMAND_LINE: {
+    const auto& c = *reinterpret_cast<const nk_command_line*>(command);
+    nk_stroke_line(b, c.begin.x + dx, c.begin.y + dy, c.end.x + dx, c.end.y + dy, c.line_thickness, c.color);
+  } break;
+  case NK_COMMAND_CURVE: {
+    const auto& c = *reinterpret_cast<const nk_command_curve*>(command);
+    nk_stroke_curve(b, c.begin.x + dx, c.begin.y + dy, c.ctrl[0].x + dx, c.ctrl[0].y + dy, c.ctrl[1].x + dx,
+      c.ctrl[1].y + dy, c.end.x + dx, c.end.y + dy, c.line_thickness, c.color);
+  } break;
+  case NK_COMMAND_RECT: {
+    const auto& c = *reinterpret_cast<const nk_command_rect*>(command);
+    nk_stroke_rect(b, box(c.x, c.y, c.w, c.h), c.rounding, c.line_thickness, c.color);
+  } break;
+  case NK_COMMAND_RECT_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_rect_filled*>(command);
+    nk_fill_rect(b, box(c.x, c.y, c.w, c.h), c.rounding, c.color);
+  } break;
+  case NK_COMMAND_RECT_MULTI_COLOR: {
+    const auto& c = *reinterpret_cast<const nk_command_rect_multi_color*>(command);
+    nk_fill_rect_multi_color(b, box(c.x, c.y, c.w, c.h), c.left, c.top, c.right, c.bottom);
+  } break;
+  case NK_COMMAND_CIRCLE: {
+    const auto& c = *reinterpret_cast<const nk_command_circle*>(command);
+    nk_stroke_circle(b, box(c.x, c.y, c.w, c.h), c.line_thickness, c.color);
+  } break;
+  case NK_COMMAND_CIRCLE_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_circle_filled*>(command);
+    nk_fill_circle(b, box(c.x, c.y, c.w, c.h), c.color);
+  } break;
+  case NK_COMMAND_ARC: {
+    const auto& c = *reinterpret_cast<const nk_command_arc*>(command);
+    nk_stroke_arc(b, c.cx + dx, c.cy + dy, c.r, c.a[0], c.a[1], c.line_thickness, c.color);
+  } break;
+  case NK_COMMAND_ARC_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_arc_filled*>(command);
+    nk_fill_arc(b, c.cx + dx, c.cy + dy, c.r, c.a[0], c.a[1], c.color);
+  } break;
+  case NK_COMMAND_TRIANGLE: {
+    const auto& c = *reinterpret_cast<const nk_command_triangle*>(command);
+    nk_stroke_triangle(b, c.a.x + dx, c.a.y + dy, c.b.x + dx, c.b.y + dy, c.c.x + dx, c.c.y + dy, c.line_thickness,
+      c.color);
+  } break;
+  case NK_COMMAND_TRIANGLE_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_triangle_filled*>(command);
+    nk_fill_triangle(b, c.a.x + dx, c.a.y + dy, c.b.x + dx, c.b.y + dy, c.c.x + dx, c.c.y + dy, c.color);
+  } break;
+  case NK_COMMAND_POLYGON: {
+    const auto& c = *reinterpret_cast<const nk_command_polygon*>(command);
+    nk_stroke_polygon(b, points(c.points, c.point_count), c.point_count, c.line_thickness, c.color);
+  } break;
+  case NK_COMMAND_POLYGON_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_polygon_filled*>(command);
+    nk_fill_polygon(b, points(c.points, c.point_count), c.point_count, c.color);
+  } break;
+  case NK_COMMAND_POLYLINE: {
+    const auto& c = *reinterpret_cast<const nk_command_polyline*>(command);
+    nk_stroke_polyline(b, points(c.points, c.point_count), c.point_count, c.line_thickness, c.color);
+  } break;
+  case NK_COMMAND_TEXT: {
+    const auto& c = *reinterpret_cast<const nk_command_text*>(command);
+    nk_draw_text(b, box(c.x, c.y, c.w, c.h), c.string, c.length, c.font, c.background, c.foreground);
+  } break;
+  case NK_COMMAND_IMAGE: {
+    const auto& c = *reinterpret_cast<const nk_command_image*>(command);
+    nk_draw_image(b, box(c.x, c.y, c.w, c.h), &c.img, c.col);
+  } break;
+  case NK_COMMAND_CUSTOM: {
+    const auto& c = *reinterpret_cast<const nk_command_custom*>(command);
+    nk_push_custom(b, box(c.x, c.y, c.w, c.h), c.callback, c.callback_data);
+  } break;
+  }
+}
+
+}  // namespace ice::ui
@@ -0,0 +1,96 @@
+#pragma once
+#include <ice/error.hpp>
+#include <unordered_map>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+extern "C" struct nk_command;
+extern "C" struct nk_command_buffer;
+extern "C" struct nk_context;
+extern "C" struct nk_rect;
+
+namespace ice::ui {
+
+// ================================================================================================
+// cache
+// ================================================================================================
+
+// Retained subtrees of a nuklear context.
+// A subtree is built in a group that fills a row. The commands of the group are recorded and replayed in later frames
+// instead of running the layout again, as long as the id, hash and size match and the mouse does not hover or press
+// the row.
+// The hash must cover every input of the subtree, including fonts and styles.
+// Subtrees can not be nested and must not open popups.
+
+class ICE_API cache {
+public:
+  cache() noexcept = default;
+  cache(cache&& other) = delete;
+  cache(const cache& other) = delete;
+  cache& operator=(cache&& other) = delete;
+  cache& operator=(const cache& other) = delete;
+  ~cache() = default;
+
+  // Returns true when the subtree must be built, which must be followed by an end call.
+  // Returns false when the recorded commands were replayed or the row is not visible.
+  bool begin(nk_context* context, std::uint64_t id, std::uint64_t hash, float height) noexcept;
+  void end(nk_context* context) noexcept;
+
+  // Removes all records.
+  void clear() noexcept;
+
+  std::size_t size() const noexcept
+  {
+    return records_.size();
+  }
+
+  // Returns the number of replayed subtrees.
+  constexpr std::size_t hits() const noexcept
+  {
+    return hits_;
+  }
+
+  // Returns the number of built subtrees.
+  constexpr std::size_t misses() const noexcept
+  {
+    return misses_;
+  }
+
+private:
+  struct record {
+    std::uint64_t hash{ 0 };
+
+    // Row bounds while recording.
+    float x{ 0.0f };
+    float y{ 0.0f };
+    float w{ 0.0f };
+    float h{ 0.0f };
+
+    // Offset of the first command in the context memory while recording.
+    std::size_t start{ 0 };
+
+    // Commands copied from the context memory.
+    std::vector<std::byte> commands;
+
+    // Frame in which the record was last used.
+    unsigned int seq{ 0 };
+
+    // True when the row was completely visible while recording and the commands can be replayed elsewhere.
+    bool valid{ false };
+  };
+
+  void replay(nk_command_buffer* buffer, const nk_command* command, float dx, float dy,
+    const struct nk_rect& clip) noexcept;
+
+  std::unordered_map<std::uint64_t, record> records_;
+  record* current_{ nullptr };
+  std::size_t start_{ 0 };
+  unsigned int offsets_[2]{};
+  unsigned int seq_{ 0 };
+  std::vector<float> points_;
+  std::size_t hits_{ 0 };
+  std::size_t misses_{ 0 };
+};
+
+}  // namespace ice::ui
@@ -28,6 +28,16 @@ void context::property_int(const char* text, int min, int* val, int max, int ste
   return nk_property_int(context_, text, min, val, max, step, inc_per_pixel);
 }
 
+bool context::retained_begin(std::uint64_t id, std::uint64_t hash, float height) noexcept
+{
+  return cache_.begin(context_, id, hash, height);
+}
+
+void context::retained_end() noexcept
+{
+  cache_.end(context_);
+}
+
 nk_context* context::get() const noexcept
 {
   return context_;
@@ -35,6 +45,7 @@ nk_context* context::get() const noexcept
 
 void context::set(nk_context* context) noexcept
 {
+  cache_.clear();
   context_ = context;
 }
 
@@ -1,5 +1,8 @@
 #pragma once
+#include <ice/ui/cache.hpp>
 #include <ice/ui/font.hpp>
+#include <ice/ui/latency.hpp>
+#include <cstdint>
 #include <memory>
 
 extern "C" struct nk_context;
@@ -23,13 +26,42 @@ public:
   bool option_label(const char* text, bool active) noexcept;
   void property_int(const char* text, int min, int* val, int max, int step, float inc_per_pixel) noexcept;
 
+  // Starts a retained subtree in a row of the given height. See ice::ui::cache for details.
+  // Returns true when the subtree must be built, which must be followed by a retained_end call.
+  bool retained_begin(std::uint64_t id, std::uint64_t hash, float height) noexcept;
+  void retained_end() noexcept;
+
+  const ice::ui::cache& cache() const noexcept
+  {
+    return cache_;
+  }
+
+  // Returns the time from input events to the presentation of the frames that they changed.
+  ice::ui::latency& latency() noexcept
+  {
+    return latency_;
+  }
+
+  const ice::ui::latency& latency() const noexcept
+  {
+    return latency_;
+  }
+
   nk_context* get() const noexcept;
 
 protected:
   void set(nk_context* context) noexcept;
 
+  // Records the latency of a presented frame. Can be called from any thread.
+  void record(ice::ui::latency::clock::time_point input) noexcept
+  {
+    latency_.record(input);
+  }
+
 private:
   nk_context* context_{ nullptr };
+  ice::ui::cache cache_;
+  ice::ui::latency latency_;
 };
 
 }  // namespace ice::ui
@@ -0,0 +1,358 @@
+#include "damage.hpp"
+#include <ice/os/nuklear.hpp>
+#include <algorithm>
+#include <new>
+#include <cstring>
+
+namespace ice::ui {
+namespace {
+
+constexpr std::uint64_t seed = 0xCBF29CE484222325;
+
+// Native renderers can modify pixels next to the command bounds (antialiasing, text overhang).
+constexpr int padding = 2;
+
+class hasher {
+public:
+  constexpr hasher(std::uint64_t value = seed) noexcept : value_(value) {}
+
+  constexpr void add(std::uint64_t value) noexcept
+  {
+    value_ = ((value_ << 5 | value_ >> 59) ^ value) * 0x517CC1B727220A95;
+  }
+
+  void add(float value) noexcept
+  {
+    std::uint32_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    add(static_cast<std::uint64_t>(bits));
+  }
+
+  void add(const void* value) noexcept
+  {
+    add(static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(value)));
+  }
+
+  void add(nk_color color) noexcept
+  {
+    add(static_cast<std::uint64_t>(color.r) | static_cast<std::uint64_t>(color.g) << 8 |
+      static_cast<std::uint64_t>(color.b) << 16 | static_cast<std::uint64_t>(color.a) << 24);
+  }
+
+  void add(struct nk_vec2i point) noexcept
+  {
+    add(static_cast<std::uint64_t>(static_cast<std::uint16_t>(point.x)) |
+      static_cast<std::uint64_t>(static_cast<std::uint16_t>(point.y)) << 16);
+  }
+
+  void add(int x, int y, int w, int h) noexcept
+  {
+    add(static_cast<std::uint64_t>(static_cast<std::uint16_t>(x)) |
+      static_cast<std::uint64_t>(static_cast<std::uint16_t>(y)) << 16 |
+      static_cast<std::uint64_t>(static_cast<std::uint16_t>(w)) << 32 |
+      static_cast<std::uint64_t>(static_cast<std::uint16_t>(h)) << 48);
+  }
+
+  void add(const char* data, std::size_t size) noexcept
+  {
+    add(static_cast<std::uint64_t>(size));
+    for (; size >= 8; data += 8, size -= 8) {
+      std::uint64_t value = 0;
+      std::memcpy(&value, data, 8);
+      add(value);
+    }
+    if (size) {
+      std::uint64_t value = 0;
+      std::memcpy(&value, data, size);
+      add(value);
+    }
+  }
+
+  constexpr std::uint64_t value() const noexcept
+  {
+    return value_;
+  }
+
+private:
+  std::uint64_t value_{ seed };
+};
+
+// Hashes all fields that affect the rendered pixels.
+// Commands that reference external state (images and custom callbacks) never compare equal.
+std::uint64_t hash_command(const nk_command* command, std::uint64_t frame) noexcept
+{
+  hasher h;
+  h.add(static_cast<std::uint64_t>(command->type));
+  switch (command->type) {
+  case NK_COMMAND_SCISSOR: {
+    const auto& c = *reinterpret_cast<const nk_command_scissor*>(command);
+    h.add(c.x, c.y, c.w, c.h);
+  } break;
+  case NK_COMMAND_LINE: {
+    const auto& c = *reinterpret_cast<const nk_command_line*>(command);
+    h.add(static_cast<std::uint64_t>(c.line_thickness));
+    h.add(c.begin);
+    h.add(c.end);
+    h.add(c.color);
+  } break;
+  case NK_COMMAND_CURVE: {
+    const auto& c = *reinterpret_cast<const nk_command_curve*>(command);
+    h.add(static_cast<std::uint64_t>(c.line_thickness));
+    h.add(c.begin);
+    h.add(c.end);
+    h.add(c.ctrl[0]);
+    h.add(c.ctrl[1]);
+    h.add(c.color);
+  } break;
+  case NK_COMMAND_RECT: {
+    const auto& c = *reinterpret_cast<const nk_command_rect*>(command);
+    h.add(c.x, c.y, c.w, c.h);
+    h.add(static_cast<std::uint64_t>(c.rounding) << 16 | c.line_thickness);
+    h.add(c.color);
+  } break;
+  case NK_COMMAND_RECT_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_rect_filled*>(command);
+    h.add(c.x, c.y, c.w, c.h);
+    h.add(static_cast<std::uint64_t>(c.rounding));
+    h.add(c.color);
+  } break;
+  case NK_COMMAND_RECT_MULTI_COLOR: {
+    const auto& c = *reinterpret_cast<const nk_command_rect_multi_color*>(command);
+    h.add(c.x, c.y, c.w, c.h);
+    h.add(c.left);
+    h.add(c.top);
+    h.add(c.right);
+    h.add(c.bottom);
+  } break;
+  case NK_COMMAND_CIRCLE: {
+    const auto& c = *reinterpret_cast<const nk_command_circle*>(command);
+    h.add(c.x, c.y, c.w, c.h);
+    h.add(static_cast<std::uint64_t>(c.line_thickness));
+    h.add(c.color);
+  } break;
+  case NK_COMMAND_CIRCLE_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_circle_filled*>(command);
+    h.add(c.x, c.y, c.w, c.h);
+    h.add(c.color);
+  } break;
+  case NK_COMMAND_ARC: {
+    const auto& c = *reinterpret_cast<const nk_command_arc*>(command);
+    h.add(c.cx, c.cy, c.r, c.line_thickness);
+    h.add(c.a[0]);
+    h.add(c.a[1]);
+    h.add(c.color);
+  } break;
+  case NK_COMMAND_ARC_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_arc_filled*>(command);
+    h.add(c.cx, c.cy, c.r, 0);
+    h.add(c.a[0]);
+    h.add(c.a[1]);
+    h.add(c.color);
+  } break;
+  case NK_COMMAND_TRIANGLE: {
+    const auto& c = *reinterpret_cast<const nk_command_triangle*>(command);
+    h.add(static_cast<std::uint64_t>(c.line_thickness));
+    h.add(c.a);
+    h.add(c.b);
+    h.add(c.c);
+    h.add(c.color);
+  } break;
+  case NK_COMMAND_TRIANGLE_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_triangle_filled*>(command);
+    h.add(c.a);
+    h.add(c.b);
+    h.add(c.c);
+    h.add(c.color);
+  } break;
+  case NK_COMMAND_POLYGON:
+  case NK_COMMAND_POLYLINE: {
+    const auto& c = *reinterpret_cast<const nk_command_polygon*>(command);
+    h.add(static_cast<std::uint64_t>(c.line_thickness) << 16 | c.point_count);
+    for (unsigned short i = 0; i < c.point_count; i++) {
+      h.add(c.points[i]);
+    }
+    h.add(c.color);
+  } break;
+  case NK_COMMAND_POLYGON_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_polygon_filled*>(command);
+    h.add(static_cast<std::uint64_t>(c.point_count));
+    for (unsigned short i = 0; i < c.point_count; i++) {
+      h.add(c.points[i]);
+    }
+    h.add(c.color);
+  } break;
+  case NK_COMMAND_TEXT: {
+    const auto& c = *reinterpret_cast<const nk_command_text*>(command);
+    h.add(c.font);
+    h.add(c.x, c.y, c.w, c.h);
+    h.add(c.height);
+    h.add(c.background);
+    h.add(c.foreground);
+    h.add(c.string, static_cast<std::size_t>(std::max(c.length, 0)));
+  } break;
+  case NK_COMMAND_IMAGE:
+  case NK_COMMAND_CUSTOM:
+    h.add(frame);
+    break;
+  default:
+    break;
+  }
+  return h.value();
+}
+
+}  // namespace
+
+ice::error damage::resize(int cx, int cy) noexcept
+{
+  if (cx == cx_ && cy == cy_ && tiles_) {
+    return {};
+  }
+  invalid_ = true;
+  tiles_.reset();
+  previous_.reset();
+  regions_.reset();
+  size_ = 0;
+  cx_ = 0;
+  cy_ = 0;
+  columns_ = 0;
+  rows_ = 0;
+  if (cx <= 0 || cy <= 0) {
+    return {};
+  }
+  const auto columns = (cx + tile - 1) / tile;
+  const auto rows = (cy + tile - 1) / tile;
+  const auto size = static_cast<std::size_t>(columns) * static_cast<std::size_t>(rows);
+  tiles_.reset(new (std::nothrow) std::uint64_t[size]);
+  previous_.reset(new (std::nothrow) std::uint64_t[size]);
+  regions_.reset(new (std::nothrow) ice::ui::raster::rect[size]);
+  if (!tiles_ || !previous_ || !regions_) {
+    tiles_.reset();
+    previous_.reset();
+    regions_.reset();
+    return std::errc::not_enough_memory;
+  }
+  std::fill_n(tiles_.get(), size, seed);
+  cx_ = cx;
+  cy_ = cy;
+  columns_ = columns;
+  rows_ = rows;
+  return {};
+}
+
+void damage::invalidate() noexcept
+{
+  invalid_ = true;
+}
+
+bool damage::update(nk_context* context) noexcept
+{
+  size_ = 0;
+  if (!tiles_) {
+    return false;
+  }
+  frame_++;
+
+  // Skip unchanged frames with a single pass over the command list.
+  hasher frame;
+  const nk_command* command = nullptr;
+  nk_foreach(command, context)
+  {
+    frame.add(hash_command(command, frame_));
+  }
+  if (frame.value() == hash_ && !invalid_) {
+    return false;
+  }
+  hash_ = frame.value();
+
+  // Hash each command into the tiles it can modify.
+  const auto size = static_cast<std::size_t>(columns_) * static_cast<std::size_t>(rows_);
+  std::swap(tiles_, previous_);
+  std::fill_n(tiles_.get(), size, seed);
+  ice::ui::raster::rect clip{ 0, 0, cx_, cy_ };
+  std::uint64_t clip_hash = seed;
+  nk_foreach(command, context)
+  {
+    const auto value = hash_command(command, frame_);
+    if (command->type == NK_COMMAND_SCISSOR) {
+      const auto& c = *reinterpret_cast<const nk_command_scissor*>(command);
+      clip.x0 = std::clamp<int>(c.x, 0, cx_);
+      clip.y0 = std::clamp<int>(c.y, 0, cy_);
+      clip.x1 = std::clamp<int>(c.x + c.w, 0, cx_);
+      clip.y1 = std::clamp<int>(c.y + c.h, 0, cy_);
+      clip_hash = value;
+      continue;
+    }
+    const auto bounds = ice::ui::raster::bounds(command);
+    const auto x0 = std::max(bounds.x0 - padding, clip.x0);
+    const auto y0 = std::max(bounds.y0 - padding, clip.y0);
+    const auto x1 = std::min(bounds.x1 + padding, clip.x1);
+    const auto y1 = std::min(bounds.y1 + padding, clip.y1);
+    if (x0 >= x1 || y0 >= y1) {
+      continue;
+    }
+    hasher h{ value };
+    h.add(clip_hash);
+    for (auto row = y0 / tile; row <= (y1 - 1) / tile; row++) {
+      const auto tiles = tiles_.get() + static_cast<std::size_t>(row) * static_cast<std::size_t>(columns_);
+      for (auto column = x0 / tile; column <= (x1 - 1) / tile; column++) {
+        hasher t{ tiles[column] };
+        t.add(h.value());
+        tiles[column] = t.value();
+      }
+    }
+  }
+
+  // Merge damaged tiles into horizontal runs and extend matching runs from the previous tile row.
+  // Regions in the range [first, size) end at the current tile row and can still be extended.
+  std::size_t first = 0;
+  for (int row = 0; row < rows_; row++) {
+    const auto tiles = tiles_.get() + static_cast<std::size_t>(row) * static_cast<std::size_t>(columns_);
+    const auto previous = previous_.get() + static_cast<std::size_t>(row) * static_cast<std::size_t>(columns_);
+    const auto y0 = row * tile;
+    const auto y1 = std::min(y0 + tile, cy_);
+    const auto open = regions_.get() + first;
+    const auto last = regions_.get() + size_;
+    for (int column = 0; column < columns_;) {
+      if (!invalid_ && tiles[column] == previous[column]) {
+        column++;
+        continue;
+      }
+      const auto x0 = column * tile;
+      while (column < columns_ && (invalid_ || tiles[column] != previous[column])) {
+        column++;
+      }
+      const auto x1 = std::min(column * tile, cx_);
+      const auto region = std::find_if(open, last, [&](const auto& r) noexcept {
+        return r.x0 == x0 && r.x1 == x1 && r.y1 == y0;
+      });
+      if (region != last) {
+        region->y1 = y1;
+      } else {
+        regions_[size_++] = { x0, y0, x1, y1 };
+      }
+    }
+    const auto closed = std::partition(open, regions_.get() + size_, [y1](const auto& r) noexcept {
+      return r.y1 != y1;
+    });
+    first = static_cast<std::size_t>(closed - regions_.get());
+  }
+  invalid_ = false;
+  return size_ > 0;
+}
+
+ice::ui::raster::rect damage::bounds() const noexcept
+{
+  if (!size_) {
+    return {};
+  }
+  auto r = regions_[0];
+  for (std::size_t i = 1; i < size_; i++) {
+    r.x0 = std::min(r.x0, regions_[i].x0);
+    r.y0 = std::min(r.y0, regions_[i].y0);
+    r.x1 = std::max(r.x1, regions_[i].x1);
+    r.y1 = std::max(r.y1, regions_[i].y1);
+  }
+  return r;
+}
+
+}  // namespace ice::ui
@@ -0,0 +1,74 @@
+#pragma once
+#include <ice/ui/raster.hpp>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+namespace ice::ui {
+
+// ================================================================================================
+// damage
+// ================================================================================================
+
+// Tracks which screen tiles changed between two nuklear command lists.
+// Every command is hashed together with the active scissor rectangle into each tile it can modify.
+// Tiles with a different hash than in the previous frame are reported as damaged.
+
+class ICE_API damage {
+public:
+  static constexpr int tile = 64;
+
+  damage() noexcept = default;
+  damage(damage&& other) noexcept = default;
+  damage(const damage& other) = delete;
+  damage& operator=(damage&& other) noexcept = default;
+  damage& operator=(const damage& other) = delete;
+  ~damage() = default;
+
+  ice::error resize(int cx, int cy) noexcept;
+
+  // Marks all tiles as damaged during the next update.
+  void invalidate() noexcept;
+
+  // Hashes the command list and returns true when at least one tile changed.
+  bool update(nk_context* context) noexcept;
+
+  // Returns the damaged regions from the last update.
+  const ice::ui::raster::rect* begin() const noexcept
+  {
+    return regions_.get();
+  }
+
+  const ice::ui::raster::rect* end() const noexcept
+  {
+    return regions_.get() + size_;
+  }
+
+  constexpr std::size_t size() const noexcept
+  {
+    return size_;
+  }
+
+  // Returns the smallest rectangle that contains all damaged regions.
+  ice::ui::raster::rect bounds() const noexcept;
+
+  constexpr std::uint64_t hash() const noexcept
+  {
+    return hash_;
+  }
+
+private:
+  std::unique_ptr<std::uint64_t[]> tiles_;
+  std::unique_ptr<std::uint64_t[]> previous_;
+  std::unique_ptr<ice::ui::raster::rect[]> regions_;
+  std::size_t size_{ 0 };
+  std::uint64_t hash_{ 0 };
+  std::uint64_t frame_{ 0 };
+  int cx_{ 0 };
+  int cy_{ 0 };
+  int columns_{ 0 };
+  int rows_{ 0 };
+  bool invalid_{ true };
+};
+
+}  // namespace ice::ui
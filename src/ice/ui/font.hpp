@@ -1,5 +1,8 @@
 #pragma once
 #include <ice/error.hpp>
+#include <string_view>
+#include <vector>
+#include <cstdint>
 
 extern "C" struct nk_user_font;
 
@@ -14,10 +17,49 @@ public:
     strikeout = (1 << 2),
   };
 
+  // Glyph coverage bitmap. The offset is relative to the pen position on the baseline.
+  struct glyph {
+    const std::uint8_t* data{ nullptr };
+    int stride{ 0 };
+    int x{ 0 };
+    int y{ 0 };
+    int cx{ 0 };
+    int cy{ 0 };
+  };
+
   virtual ~font() = default;
 
   virtual float width(std::string_view text, float height) const noexcept = 0;
 
+  // Returns the horizontal pen advance of a code point.
+  virtual float advance(char32_t code) const noexcept
+  {
+    return 0.0f;
+  }
+
+  // Returns the distance from the top of a line to the baseline.
+  virtual float ascent() const noexcept
+  {
+    return 0.0f;
+  }
+
+  // Caches the glyphs of the text for rendering.
+  // Must not be called concurrently with itself or find, but text can be measured on other threads.
+  virtual void prepare(std::string_view text) noexcept
+  {}
+
+  // Returns a cached glyph. Can be called concurrently, but the bitmap is only valid until the next prepare call.
+  virtual bool find(char32_t code, glyph& glyph) const noexcept
+  {
+    return false;
+  }
+
+  // Rasterizes a glyph into the buffer without caching it. Can be called concurrently.
+  virtual bool render(char32_t code, std::vector<std::uint8_t>& buffer, glyph& glyph) const noexcept
+  {
+    return false;
+  }
+
   float height() const noexcept;
 
   nk_user_font* get() const noexcept;
@@ -0,0 +1,74 @@
+#include "frame.hpp"
+#include <ice/os/nuklear.hpp>
+#include <algorithm>
+#include <new>
+#include <cstring>
+
+namespace ice::ui {
+
+frame::frame() noexcept = default;
+
+frame::~frame() = default;
+
+ice::error frame::assign(nk_context* context, int cx, int cy, clock::time_point input) noexcept
+{
+  if (!context_) {
+    context_.reset(new (std::nothrow) nk_context{});
+    window_.reset(new (std::nothrow) nk_window{});
+    if (!context_ || !window_) {
+      context_.reset();
+      return std::errc::not_enough_memory;
+    }
+  }
+  cx_ = cx;
+  cy_ = cy;
+  input_ = input;
+
+  // Iterating the command list links the window buffers into a single list.
+  const auto first = context ? nk__begin(context) : nullptr;
+  const auto size = first ? context->memory.allocated : 0;
+  auto& c = *context_;
+  auto& w = *window_;
+  c.count = 0;
+  c.begin = nullptr;
+  if (size > capacity_) {
+    const auto capacity = std::max(size, capacity_ * 2);
+    memory_.reset(new (std::nothrow) std::byte[capacity]);
+    capacity_ = memory_ ? capacity : 0;
+    if (!memory_) {
+      return std::errc::not_enough_memory;
+    }
+  }
+  if (!size) {
+    return {};
+  }
+  const auto data = static_cast<const std::byte*>(context->memory.memory.ptr);
+  std::memcpy(memory_.get(), data, size);
+
+  // The copy has a single window that starts at the first command and ends at the end of the memory.
+  c.memory.memory.ptr = memory_.get();
+  c.memory.memory.size = capacity_;
+  c.memory.allocated = size;
+  c.memory.size = capacity_;
+  c.build = nk_true;
+  c.seq = context->seq;
+  c.count = 1;
+  c.begin = &w;
+  c.end = &w;
+  w.seq = context->seq;
+  w.flags = 0;
+  w.next = nullptr;
+  w.prev = nullptr;
+  w.buffer.base = &c.memory;
+  w.buffer.begin = static_cast<nk_size>(reinterpret_cast<const std::byte*>(first) - data);
+  w.buffer.end = size;
+  w.buffer.last = size;
+  return {};
+}
+
+nk_context* frame::get() const noexcept
+{
+  return context_.get();
+}
+
+}  // namespace ice::ui
@@ -0,0 +1,64 @@
+#pragma once
+#include <ice/error.hpp>
+#include <chrono>
+#include <memory>
+#include <cstddef>
+
+extern "C" struct nk_context;
+extern "C" struct nk_window;
+
+namespace ice::ui {
+
+// ================================================================================================
+// frame
+// ================================================================================================
+
+// Copy of the command list of a nuklear context that can be rendered while the context builds the next frame.
+// The context memory is copied with the command offsets, and get() returns a context that only contains the copied
+// commands, so that the copy works with nk_foreach, ice::ui::damage and ice::ui::raster.
+// Fonts and images referenced by the commands must outlive the copy.
+
+class ICE_API frame {
+public:
+  using clock = std::chrono::steady_clock;
+
+  frame() noexcept;
+  frame(frame&& other) = delete;
+  frame(const frame& other) = delete;
+  frame& operator=(frame&& other) = delete;
+  frame& operator=(const frame& other) = delete;
+  ~frame();
+
+  // Copies the command list of a context after nk_end and before nk_clear. A null context copies an empty list.
+  // The size is the surface size of the frame and the time is the time of the first input event of the frame.
+  ice::error assign(nk_context* context, int cx, int cy, clock::time_point input = {}) noexcept;
+
+  nk_context* get() const noexcept;
+
+  constexpr int cx() const noexcept
+  {
+    return cx_;
+  }
+
+  constexpr int cy() const noexcept
+  {
+    return cy_;
+  }
+
+  // Returns the time of the first input event or a default constructed time point when there was no input.
+  constexpr clock::time_point input() const noexcept
+  {
+    return input_;
+  }
+
+private:
+  std::unique_ptr<nk_context> context_;
+  std::unique_ptr<nk_window> window_;
+  std::unique_ptr<std::byte[]> memory_;
+  std::size_t capacity_{ 0 };
+  clock::time_point input_;
+  int cx_{ 0 };
+  int cy_{ 0 };
+};
+
+}  // namespace ice::ui
@@ -0,0 +1,183 @@
+#include "input.hpp"
+#include <ice/os/nuklear.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace ice::ui {
+namespace {
+
+void put(std::vector<std::uint8_t>& data, std::uint64_t value) noexcept
+{
+  while (value >= 0x80) {
+    data.push_back(static_cast<std::uint8_t>(value | 0x80));
+    value >>= 7;
+  }
+  data.push_back(static_cast<std::uint8_t>(value));
+}
+
+void put(std::vector<std::uint8_t>& data, int value) noexcept
+{
+  const auto v = static_cast<std::int64_t>(value);
+  put(data, static_cast<std::uint64_t>((v << 1) ^ (v >> 63)));
+}
+
+void put(std::vector<std::uint8_t>& data, float value) noexcept
+{
+  std::uint32_t bits = 0;
+  std::memcpy(&bits, &value, sizeof(bits));
+  for (auto i = 0; i < 4; i++) {
+    data.push_back(static_cast<std::uint8_t>(bits >> (i * 8)));
+  }
+}
+
+bool get(const std::vector<std::uint8_t>& data, std::size_t& offset, std::uint64_t& value) noexcept
+{
+  value = 0;
+  for (auto shift = 0; shift < 64 && offset < data.size(); shift += 7) {
+    const auto byte = data[offset++];
+    value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+    if (!(byte & 0x80)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool get(const std::vector<std::uint8_t>& data, std::size_t& offset, int& value) noexcept
+{
+  std::uint64_t v = 0;
+  if (!get(data, offset, v)) {
+    return false;
+  }
+  value = static_cast<int>(static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1));
+  return true;
+}
+
+bool get(const std::vector<std::uint8_t>& data, std::size_t& offset, float& value) noexcept
+{
+  if (data.size() - offset < 4) {
+    return false;
+  }
+  std::uint32_t bits = 0;
+  for (auto i = 0; i < 4; i++) {
+    bits |= static_cast<std::uint32_t>(data[offset++]) << (i * 8);
+  }
+  std::memcpy(&value, &bits, sizeof(value));
+  return true;
+}
+
+bool get(const std::vector<std::uint8_t>& data, std::size_t& offset, std::uint8_t& value) noexcept
+{
+  if (offset >= data.size()) {
+    return false;
+  }
+  value = data[offset++];
+  return true;
+}
+
+}  // namespace
+
+void input::apply(nk_context* context) const noexcept
+{
+  switch (type) {
+  case type::frame:
+  case type::resize:
+    break;
+  case type::motion:
+    nk_input_motion(context, x, y);
+    break;
+  case type::button:
+    if (id < NK_BUTTON_MAX) {
+      nk_input_button(context, static_cast<nk_buttons>(id), x, y, down);
+    }
+    break;
+  case type::scroll:
+    nk_input_scroll(context, nk_vec2(dx, dy));
+    break;
+  case type::key:
+    if (id < NK_KEY_MAX) {
+      nk_input_key(context, static_cast<nk_keys>(id), down);
+    }
+    break;
+  case type::unicode:
+    nk_input_unicode(context, static_cast<nk_rune>(code));
+    break;
+  }
+}
+
+void input::encode(std::vector<std::uint8_t>& data, std::chrono::microseconds previous) const noexcept
+{
+  data.push_back(static_cast<std::uint8_t>(type));
+  put(data, static_cast<std::uint64_t>(std::max(time - previous, std::chrono::microseconds{ 0 }).count()));
+  switch (type) {
+  case type::frame:
+    break;
+  case type::motion:
+  case type::resize:
+    put(data, x);
+    put(data, y);
+    break;
+  case type::button:
+    data.push_back(id);
+    data.push_back(down ? 1 : 0);
+    put(data, x);
+    put(data, y);
+    break;
+  case type::scroll:
+    put(data, dx);
+    put(data, dy);
+    break;
+  case type::key:
+    data.push_back(id);
+    data.push_back(down ? 1 : 0);
+    break;
+  case type::unicode:
+    put(data, static_cast<std::uint64_t>(code));
+    break;
+  }
+}
+
+bool input::decode(const std::vector<std::uint8_t>& data, std::size_t& offset,
+  std::chrono::microseconds previous) noexcept
+{
+  std::uint8_t value = 0;
+  std::uint64_t delta = 0;
+  if (!get(data, offset, value) || value > static_cast<std::uint8_t>(type::resize) || !get(data, offset, delta)) {
+    return false;
+  }
+  *this = {};
+  type = static_cast<enum type>(value);
+  time = previous + std::chrono::microseconds{ static_cast<std::chrono::microseconds::rep>(delta) };
+  switch (type) {
+  case type::frame:
+    return true;
+  case type::motion:
+  case type::resize:
+    return get(data, offset, x) && get(data, offset, y);
+  case type::button:
+    if (!get(data, offset, id) || !get(data, offset, value)) {
+      return false;
+    }
+    down = value != 0;
+    return get(data, offset, x) && get(data, offset, y);
+  case type::scroll:
+    return get(data, offset, dx) && get(data, offset, dy);
+  case type::key:
+    if (!get(data, offset, id) || !get(data, offset, value)) {
+      return false;
+    }
+    down = value != 0;
+    return true;
+  case type::unicode: {
+    std::uint64_t code = 0;
+    if (!get(data, offset, code) || code > 0x10FFFF) {
+      return false;
+    }
+    this->code = static_cast<char32_t>(code);
+    return true;
+  }
+  }
+  return false;
+}
+
+}  // namespace ice::ui
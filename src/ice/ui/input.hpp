@@ -0,0 +1,69 @@
+#pragma once
+#include <ice/error.hpp>
+#include <chrono>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+extern "C" struct nk_context;
+
+namespace ice::ui {
+
+// ================================================================================================
+// input
+// ================================================================================================
+
+// Translated nuklear input call.
+// Platform layers translate native events into input events, which can be applied, recorded and replayed.
+
+struct ICE_API input {
+  enum class type : std::uint8_t {
+    // End of the input of a frame.
+    frame = 0,
+
+    // Mouse position in x and y.
+    motion = 1,
+
+    // Mouse button in id, position in x and y and state in down.
+    button = 2,
+
+    // Scroll delta in dx and dy.
+    scroll = 3,
+
+    // Key in id and state in down.
+    key = 4,
+
+    // Text input in code.
+    unicode = 5,
+
+    // Surface size in x and y.
+    resize = 6,
+  };
+
+  ice::ui::input::type type{ ice::ui::input::type::frame };
+  std::uint8_t id{ 0 };
+  bool down{ false };
+  int x{ 0 };
+  int y{ 0 };
+  float dx{ 0.0f };
+  float dy{ 0.0f };
+  char32_t code{ 0 };
+
+  // Time since the start of the recording.
+  std::chrono::microseconds time{ 0 };
+
+  // Recording header. See ice::ui::recorder for the format.
+  static constexpr std::uint8_t magic[4]{ 'I', 'C', 'E', 'I' };
+  static constexpr std::uint8_t version = 1;
+
+  // Calls the nuklear input function of the event. Frame and resize events are ignored.
+  void apply(nk_context* context) const noexcept;
+
+  // Appends the event to a recording. The time is stored relative to the time of the previous event.
+  void encode(std::vector<std::uint8_t>& data, std::chrono::microseconds previous) const noexcept;
+
+  // Reads an event from a recording and advances the offset. Returns false when the data ends or is corrupt.
+  bool decode(const std::vector<std::uint8_t>& data, std::size_t& offset, std::chrono::microseconds previous) noexcept;
+};
+
+}  // namespace ice::ui
@@ -0,0 +1,432 @@
+#include "kernels.hpp"
+#include <algorithm>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#  define ICE_KERNELS_X86 1
+#  include <immintrin.h>
+#  if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#    define ICE_TARGET_SSE2
+#    define ICE_TARGET_AVX2
+#  else
+#    define ICE_TARGET_SSE2 __attribute__((target("sse2")))
+#    define ICE_TARGET_AVX2 __attribute__((target("avx2")))
+#  endif
+#else
+#  define ICE_KERNELS_X86 0
+#endif
+
+namespace ice::ui {
+namespace {
+
+// ================================================================================================
+// scalar
+// ================================================================================================
+
+// Divides by 255 with rounding. Exact for all products of two 8-bit values and sums of such products up to 255 * 255.
+constexpr std::uint32_t div255(std::uint32_t x) noexcept
+{
+  x += 128;
+  return (x + (x >> 8)) >> 8;
+}
+
+// Interpolates each channel of two colors with a weight in the range [0, 256].
+constexpr std::uint32_t lerp(std::uint32_t a, std::uint32_t b, std::uint32_t t) noexcept
+{
+  std::uint32_t color = 0;
+  for (std::uint32_t shift = 0; shift < 32; shift += 8) {
+    const auto ca = (a >> shift) & 0xFF;
+    const auto cb = (b >> shift) & 0xFF;
+    color |= ((ca * (256 - t) + cb * t) >> 8) << shift;
+  }
+  return color;
+}
+
+// Blends the color channels over a pixel with the given alpha.
+// An alpha of 0 leaves the pixel unchanged and an alpha of 255 replaces it.
+constexpr std::uint32_t over(std::uint32_t pixel, std::uint32_t color, std::uint32_t a) noexcept
+{
+  const auto ia = 255 - a;
+  const auto r = div255(((color >> 16) & 0xFF) * a + ((pixel >> 16) & 0xFF) * ia);
+  const auto g = div255(((color >> 8) & 0xFF) * a + ((pixel >> 8) & 0xFF) * ia);
+  const auto b = div255((color & 0xFF) * a + (pixel & 0xFF) * ia);
+  return (r << 16) | (g << 8) | b;
+}
+
+void fill_scalar(std::uint32_t* dst, std::size_t size, std::uint32_t color) noexcept
+{
+  std::fill_n(dst, size, color & 0x00FFFFFF);
+}
+
+void blend_scalar(std::uint32_t* dst, std::size_t size, std::uint32_t color) noexcept
+{
+  const auto a = color >> 24;
+  const auto ia = 255 - a;
+  const auto r = ((color >> 16) & 0xFF) * a;
+  const auto g = ((color >> 8) & 0xFF) * a;
+  const auto b = (color & 0xFF) * a;
+  for (std::size_t i = 0; i < size; i++) {
+    const auto d = dst[i];
+    const auto dr = div255(r + ((d >> 16) & 0xFF) * ia);
+    const auto dg = div255(g + ((d >> 8) & 0xFF) * ia);
+    const auto db = div255(b + (d & 0xFF) * ia);
+    dst[i] = (dr << 16) | (dg << 8) | db;
+  }
+}
+
+void cover_scalar(std::uint32_t* dst, std::size_t size, std::uint32_t color, const std::uint8_t* coverage) noexcept
+{
+  const auto a = color >> 24;
+  for (std::size_t i = 0; i < size; i++) {
+    dst[i] = over(dst[i], color, div255(a * coverage[i]));
+  }
+}
+
+void gradient_scalar(std::uint32_t* dst, std::size_t size, std::uint32_t left, std::uint32_t right, std::uint32_t t,
+  std::uint32_t step) noexcept
+{
+  for (std::size_t i = 0; i < size; i++, t += step) {
+    const auto color = lerp(left, right, t >> 16);
+    dst[i] = over(dst[i], color, color >> 24);
+  }
+}
+
+constexpr kernels scalar{ kernels::isa::scalar, fill_scalar, blend_scalar, cover_scalar, gradient_scalar };
+
+#if ICE_KERNELS_X86
+
+// ================================================================================================
+// sse2
+// ================================================================================================
+
+// Pixels are processed as 16-bit channels, two pixels per register in the order b, g, r, a.
+// The alpha channel of the results is always zero, because the source and destination factors are masked.
+
+ICE_TARGET_SSE2 inline __m128i div255_sse2(__m128i x) noexcept
+{
+  x = _mm_add_epi16(x, _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(x, _mm_srli_epi16(x, 8)), 8);
+}
+
+ICE_TARGET_SSE2 inline __m128i channels_sse2(std::uint32_t color) noexcept
+{
+  return _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(color)), _mm_setzero_si128());
+}
+
+ICE_TARGET_SSE2 inline __m128i mask_sse2() noexcept
+{
+  return _mm_set_epi16(0, -1, -1, -1, 0, -1, -1, -1);
+}
+
+// Broadcasts four 32-bit weights in the range [0, 256] to the 16-bit channels of the pixels they belong to.
+ICE_TARGET_SSE2 inline void expand_sse2(__m128i w, __m128i& lo, __m128i& hi) noexcept
+{
+  w = _mm_packs_epi32(w, w);
+  w = _mm_unpacklo_epi16(w, w);
+  lo = _mm_unpacklo_epi32(w, w);
+  hi = _mm_unpackhi_epi32(w, w);
+}
+
+// Blends the color channels over the pixel channels with per-channel alpha.
+ICE_TARGET_SSE2 inline __m128i over_sse2(__m128i pixels, __m128i color, __m128i a) noexcept
+{
+  const auto mask = mask_sse2();
+  const auto s = _mm_and_si128(_mm_mullo_epi16(color, a), mask);
+  const auto ia = _mm_and_si128(_mm_sub_epi16(_mm_set1_epi16(255), a), mask);
+  return div255_sse2(_mm_add_epi16(s, _mm_mullo_epi16(pixels, ia)));
+}
+
+// Broadcasts the alpha channel of each pixel to all of its channels.
+ICE_TARGET_SSE2 inline __m128i alpha_sse2(__m128i color) noexcept
+{
+  return _mm_shufflehi_epi16(_mm_shufflelo_epi16(color, 0xFF), 0xFF);
+}
+
+ICE_TARGET_SSE2 void fill_sse2(std::uint32_t* dst, std::size_t size, std::uint32_t color) noexcept
+{
+  const auto value = _mm_set1_epi32(static_cast<int>(color & 0x00FFFFFF));
+  std::size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), value);
+  }
+  fill_scalar(dst + i, size - i, color);
+}
+
+ICE_TARGET_SSE2 void blend_sse2(std::uint32_t* dst, std::size_t size, std::uint32_t color) noexcept
+{
+  const auto zero = _mm_setzero_si128();
+  const auto mask = mask_sse2();
+  const auto a = static_cast<short>(color >> 24);
+  const auto s = _mm_and_si128(_mm_mullo_epi16(channels_sse2(color), _mm_set1_epi16(a)), mask);
+  const auto ia = _mm_and_si128(_mm_set1_epi16(static_cast<short>(255 - a)), mask);
+  std::size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    const auto d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    const auto lo = div255_sse2(_mm_add_epi16(s, _mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), ia)));
+    const auto hi = div255_sse2(_mm_add_epi16(s, _mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), ia)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+  }
+  blend_scalar(dst + i, size - i, color);
+}
+
+ICE_TARGET_SSE2 void cover_sse2(std::uint32_t* dst, std::size_t size, std::uint32_t color,
+  const std::uint8_t* coverage) noexcept
+{
+  const auto zero = _mm_setzero_si128();
+  const auto c = channels_sse2(color);
+  const auto a = _mm_set1_epi16(static_cast<short>(color >> 24));
+  std::size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    std::uint32_t bits = 0;
+    std::memcpy(&bits, coverage + i, sizeof(bits));
+    auto w = _mm_cvtsi32_si128(static_cast<int>(bits));
+    w = _mm_unpacklo_epi16(_mm_unpacklo_epi8(w, zero), zero);
+    __m128i wlo;
+    __m128i whi;
+    expand_sse2(w, wlo, whi);
+    const auto d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    const auto lo = over_sse2(_mm_unpacklo_epi8(d, zero), c, div255_sse2(_mm_mullo_epi16(a, wlo)));
+    const auto hi = over_sse2(_mm_unpackhi_epi8(d, zero), c, div255_sse2(_mm_mullo_epi16(a, whi)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+  }
+  cover_scalar(dst + i, size - i, color, coverage + i);
+}
+
+ICE_TARGET_SSE2 void gradient_sse2(std::uint32_t* dst, std::size_t size, std::uint32_t left, std::uint32_t right,
+  std::uint32_t t, std::uint32_t step) noexcept
+{
+  const auto zero = _mm_setzero_si128();
+  const auto full = _mm_set1_epi16(256);
+  const auto l = channels_sse2(left);
+  const auto r = channels_sse2(right);
+  const auto increment = _mm_set1_epi32(static_cast<int>(step * 4));
+  auto weights = _mm_set_epi32(static_cast<int>(t + step * 3), static_cast<int>(t + step * 2),
+    static_cast<int>(t + step), static_cast<int>(t));
+  std::size_t i = 0;
+  for (; i + 4 <= size; i += 4) {
+    __m128i wlo;
+    __m128i whi;
+    expand_sse2(_mm_srli_epi32(weights, 16), wlo, whi);
+    const auto clo = _mm_srli_epi16(
+      _mm_add_epi16(_mm_mullo_epi16(l, _mm_sub_epi16(full, wlo)), _mm_mullo_epi16(r, wlo)), 8);
+    const auto chi = _mm_srli_epi16(
+      _mm_add_epi16(_mm_mullo_epi16(l, _mm_sub_epi16(full, whi)), _mm_mullo_epi16(r, whi)), 8);
+    const auto d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+    const auto lo = over_sse2(_mm_unpacklo_epi8(d, zero), clo, alpha_sse2(clo));
+    const auto hi = over_sse2(_mm_unpackhi_epi8(d, zero), chi, alpha_sse2(chi));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(lo, hi));
+    weights = _mm_add_epi32(weights, increment);
+  }
+  gradient_scalar(dst + i, size - i, left, right, t + static_cast<std::uint32_t>(i) * step, step);
+}
+
+constexpr kernels sse2{ kernels::isa::sse2, fill_sse2, blend_sse2, cover_sse2, gradient_sse2 };
+
+// ================================================================================================
+// avx2
+// ================================================================================================
+
+// Same layout as the SSE2 kernels. Unpack and pack instructions operate on 128-bit lanes, which keeps
+// pixels 0, 1, 4, 5 in the low and pixels 2, 3, 6, 7 in the high registers.
+// The remaining pixels are handled by the SSE2 kernels after clearing the upper halves of the registers,
+// which avoids the transition penalty between VEX and legacy SSE instructions.
+
+ICE_TARGET_AVX2 inline __m256i div255_avx2(__m256i x) noexcept
+{
+  x = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+  return _mm256_srli_epi16(_mm256_add_epi16(x, _mm256_srli_epi16(x, 8)), 8);
+}
+
+ICE_TARGET_AVX2 inline __m256i channels_avx2(std::uint32_t color) noexcept
+{
+  return _mm256_unpacklo_epi8(_mm256_set1_epi32(static_cast<int>(color)), _mm256_setzero_si256());
+}
+
+ICE_TARGET_AVX2 inline __m256i mask_avx2() noexcept
+{
+  return _mm256_set_epi16(0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1, 0, -1, -1, -1);
+}
+
+ICE_TARGET_AVX2 inline void expand_avx2(__m256i w, __m256i& lo, __m256i& hi) noexcept
+{
+  w = _mm256_packs_epi32(w, w);
+  w = _mm256_unpacklo_epi16(w, w);
+  lo = _mm256_unpacklo_epi32(w, w);
+  hi = _mm256_unpackhi_epi32(w, w);
+}
+
+ICE_TARGET_AVX2 inline __m256i over_avx2(__m256i pixels, __m256i color, __m256i a) noexcept
+{
+  const auto mask = mask_avx2();
+  const auto s = _mm256_and_si256(_mm256_mullo_epi16(color, a), mask);
+  const auto ia = _mm256_and_si256(_mm256_sub_epi16(_mm256_set1_epi16(255), a), mask);
+  return div255_avx2(_mm256_add_epi16(s, _mm256_mullo_epi16(pixels, ia)));
+}
+
+ICE_TARGET_AVX2 inline __m256i alpha_avx2(__m256i color) noexcept
+{
+  return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(color, 0xFF), 0xFF);
+}
+
+ICE_TARGET_AVX2 void fill_avx2(std::uint32_t* dst, std::size_t size, std::uint32_t color) noexcept
+{
+  const auto value = _mm256_set1_epi32(static_cast<int>(color & 0x00FFFFFF));
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), value);
+  }
+  _mm256_zeroupper();
+  fill_scalar(dst + i, size - i, color);
+}
+
+ICE_TARGET_AVX2 void blend_avx2(std::uint32_t* dst, std::size_t size, std::uint32_t color) noexcept
+{
+  const auto zero = _mm256_setzero_si256();
+  const auto mask = mask_avx2();
+  const auto a = static_cast<short>(color >> 24);
+  const auto s = _mm256_and_si256(_mm256_mullo_epi16(channels_avx2(color), _mm256_set1_epi16(a)), mask);
+  const auto ia = _mm256_and_si256(_mm256_set1_epi16(static_cast<short>(255 - a)), mask);
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const auto d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+    const auto lo = div255_avx2(_mm256_add_epi16(s, _mm256_mullo_epi16(_mm256_unpacklo_epi8(d, zero), ia)));
+    const auto hi = div255_avx2(_mm256_add_epi16(s, _mm256_mullo_epi16(_mm256_unpackhi_epi8(d, zero), ia)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_packus_epi16(lo, hi));
+  }
+  _mm256_zeroupper();
+  blend_sse2(dst + i, size - i, color);
+}
+
+ICE_TARGET_AVX2 void cover_avx2(std::uint32_t* dst, std::size_t size, std::uint32_t color,
+  const std::uint8_t* coverage) noexcept
+{
+  const auto zero = _mm256_setzero_si256();
+  const auto c = channels_avx2(color);
+  const auto a = _mm256_set1_epi16(static_cast<short>(color >> 24));
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    const auto w = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(coverage + i)));
+    __m256i wlo;
+    __m256i whi;
+    expand_avx2(w, wlo, whi);
+    const auto d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+    const auto lo = over_avx2(_mm256_unpacklo_epi8(d, zero), c, div255_avx2(_mm256_mullo_epi16(a, wlo)));
+    const auto hi = over_avx2(_mm256_unpackhi_epi8(d, zero), c, div255_avx2(_mm256_mullo_epi16(a, whi)));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_packus_epi16(lo, hi));
+  }
+  _mm256_zeroupper();
+  cover_sse2(dst + i, size - i, color, coverage + i);
+}
+
+ICE_TARGET_AVX2 void gradient_avx2(std::uint32_t* dst, std::size_t size, std::uint32_t left, std::uint32_t right,
+  std::uint32_t t, std::uint32_t step) noexcept
+{
+  const auto zero = _mm256_setzero_si256();
+  const auto full = _mm256_set1_epi16(256);
+  const auto l = channels_avx2(left);
+  const auto r = channels_avx2(right);
+  const auto increment = _mm256_set1_epi32(static_cast<int>(step * 8));
+  auto weights = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(t)),
+    _mm256_mullo_epi32(_mm256_set1_epi32(static_cast<int>(step)), _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0)));
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    __m256i wlo;
+    __m256i whi;
+    expand_avx2(_mm256_srli_epi32(weights, 16), wlo, whi);
+    const auto clo = _mm256_srli_epi16(
+      _mm256_add_epi16(_mm256_mullo_epi16(l, _mm256_sub_epi16(full, wlo)), _mm256_mullo_epi16(r, wlo)), 8);
+    const auto chi = _mm256_srli_epi16(
+      _mm256_add_epi16(_mm256_mullo_epi16(l, _mm256_sub_epi16(full, whi)), _mm256_mullo_epi16(r, whi)), 8);
+    const auto d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst + i));
+    const auto lo = over_avx2(_mm256_unpacklo_epi8(d, zero), clo, alpha_avx2(clo));
+    const auto hi = over_avx2(_mm256_unpackhi_epi8(d, zero), chi, alpha_avx2(chi));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_packus_epi16(lo, hi));
+    weights = _mm256_add_epi32(weights, increment);
+  }
+  _mm256_zeroupper();
+  gradient_sse2(dst + i, size - i, left, right, t + static_cast<std::uint32_t>(i) * step, step);
+}
+
+constexpr kernels avx2{ kernels::isa::avx2, fill_avx2, blend_avx2, cover_avx2, gradient_avx2 };
+
+#endif
+
+bool supported(kernels::isa type) noexcept
+{
+  switch (type) {
+  case kernels::isa::scalar:
+    return true;
+#if ICE_KERNELS_X86
+#  if defined(_MSC_VER) && !defined(__clang__)
+  case kernels::isa::sse2: {
+    int info[4] = {};
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+  }
+  case kernels::isa::avx2: {
+    int info[4] = {};
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+      return false;
+    }
+    __cpuid(info, 1);
+    const auto osxsave = (info[2] & (1 << 27)) != 0;
+    const auto avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+      return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+  }
+#  else
+  case kernels::isa::sse2:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+  case kernels::isa::avx2:
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#  endif
+#endif
+  default:
+    break;
+  }
+  return false;
+}
+
+}  // namespace
+
+const kernels& kernels::get() noexcept
+{
+  static const auto best = []() noexcept {
+    for (const auto type : { isa::avx2, isa::sse2 }) {
+      if (const auto result = get(type)) {
+        return result;
+      }
+    }
+    return &scalar;
+  }();
+  return *best;
+}
+
+const kernels* kernels::get(isa type) noexcept
+{
+  if (!supported(type)) {
+    return nullptr;
+  }
+  switch (type) {
+  case isa::scalar:
+    return &scalar;
+#if ICE_KERNELS_X86
+  case isa::sse2:
+    return &sse2;
+  case isa::avx2:
+    return &avx2;
+#endif
+  default:
+    break;
+  }
+  return nullptr;
+}
+
+}  // namespace ice::ui
@@ -0,0 +1,54 @@
+#pragma once
+#include <ice/config.hpp>
+#include <cstddef>
+#include <cstdint>
+
+namespace ice::ui {
+
+// ================================================================================================
+// kernels
+// ================================================================================================
+
+// Pixel span kernels used by the software rasterizer.
+// Pixels are stored as 0x00RRGGBB and colors are passed as 0xAARRGGBB with straight alpha.
+// The SIMD implementations produce the same pixels as the scalar implementation.
+
+struct ICE_API kernels {
+  enum class isa {
+    scalar,
+    sse2,
+    avx2,
+  };
+
+  using fill_function = void (*)(std::uint32_t* dst, std::size_t size, std::uint32_t color) noexcept;
+  using blend_function = void (*)(std::uint32_t* dst, std::size_t size, std::uint32_t color) noexcept;
+  using cover_function = void (*)(std::uint32_t* dst, std::size_t size, std::uint32_t color,
+    const std::uint8_t* coverage) noexcept;
+  using gradient_function = void (*)(std::uint32_t* dst, std::size_t size, std::uint32_t left, std::uint32_t right,
+    std::uint32_t t, std::uint32_t step) noexcept;
+
+  // Instruction set used by the kernels.
+  isa type{ isa::scalar };
+
+  // Sets pixels to the color and ignores the alpha channel.
+  fill_function fill{ nullptr };
+
+  // Blends the color over pixels. The color channels are premultiplied once for the whole span.
+  blend_function blend{ nullptr };
+
+  // Blends the color over pixels with the alpha channel scaled by the per-pixel coverage in the range [0, 255].
+  // Used for anti-aliased edges.
+  cover_function cover{ nullptr };
+
+  // Blends a horizontal gradient from `left` to `right` over pixels.
+  // The weight of the right color for pixel `i` is `(t + i * step) >> 16` and must not exceed 256.
+  gradient_function gradient{ nullptr };
+
+  // Returns the kernels for the best instruction set supported by the processor.
+  static const kernels& get() noexcept;
+
+  // Returns the kernels for the instruction set or nullptr if it is not supported by the processor or the build.
+  static const kernels* get(isa type) noexcept;
+};
+
+}  // namespace ice::ui
@@ -0,0 +1,36 @@
+#include "latency.hpp"
+
+namespace ice::ui {
+
+void latency::record(clock::time_point input, clock::time_point presented) noexcept
+{
+  if (input == clock::time_point{} || presented < input) {
+    return;
+  }
+  const auto value = (presented - input).count();
+  last_.store(value, std::memory_order_relaxed);
+  total_.fetch_add(value, std::memory_order_relaxed);
+  if (value > max_.load(std::memory_order_relaxed)) {
+    max_.store(value, std::memory_order_relaxed);
+  }
+  count_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void latency::reset() noexcept
+{
+  count_.store(0, std::memory_order_relaxed);
+  last_.store(0, std::memory_order_relaxed);
+  max_.store(0, std::memory_order_relaxed);
+  total_.store(0, std::memory_order_relaxed);
+}
+
+latency::clock::duration latency::mean() const noexcept
+{
+  const auto count = count_.load(std::memory_order_relaxed);
+  if (!count) {
+    return {};
+  }
+  return clock::duration{ total_.load(std::memory_order_relaxed) / static_cast<clock::rep>(count) };
+}
+
+}  // namespace ice::ui
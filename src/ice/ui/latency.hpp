@@ -0,0 +1,57 @@
+#pragma once
+#include <ice/error.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace ice::ui {
+
+// ================================================================================================
+// latency
+// ================================================================================================
+
+// Time from the first input event of a frame until the pixels of the frame were presented.
+// Samples are recorded by the thread that presents frames and can be read from any thread.
+
+class ICE_API latency {
+public:
+  using clock = std::chrono::steady_clock;
+
+  latency() noexcept = default;
+  latency(latency&& other) = delete;
+  latency(const latency& other) = delete;
+  latency& operator=(latency&& other) = delete;
+  latency& operator=(const latency& other) = delete;
+  ~latency() = default;
+
+  // Records a sample. Frames without input are ignored.
+  void record(clock::time_point input, clock::time_point presented = clock::now()) noexcept;
+
+  void reset() noexcept;
+
+  std::size_t count() const noexcept
+  {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  clock::duration last() const noexcept
+  {
+    return clock::duration{ last_.load(std::memory_order_relaxed) };
+  }
+
+  clock::duration max() const noexcept
+  {
+    return clock::duration{ max_.load(std::memory_order_relaxed) };
+  }
+
+  clock::duration mean() const noexcept;
+
+private:
+  std::atomic_size_t count_{ 0 };
+  std::atomic<clock::rep> last_{ 0 };
+  std::atomic<clock::rep> max_{ 0 };
+  std::atomic<clock::rep> total_{ 0 };
+};
+
+}  // namespace ice::ui
@@ -0,0 +1,63 @@
+#include "player.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace ice::ui {
+
+ice::error player::open(const std::filesystem::path& path) noexcept
+{
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    return std::errc::no_such_file_or_directory;
+  }
+  std::vector<std::uint8_t> data(static_cast<std::size_t>(file.tellg()));
+  file.seekg(0);
+  if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()))) {
+    return std::errc::io_error;
+  }
+  return open(std::move(data));
+}
+
+ice::error player::open(std::vector<std::uint8_t> data) noexcept
+{
+  constexpr auto header = sizeof(ice::ui::input::magic) + 1;
+  const auto magic = std::begin(ice::ui::input::magic);
+  if (data.size() < header || !std::equal(magic, std::end(ice::ui::input::magic), data.begin())) {
+    return std::errc::invalid_argument;
+  }
+  if (data[header - 1] != ice::ui::input::version) {
+    return std::errc::not_supported;
+  }
+  data_ = std::move(data);
+  rewind();
+  return {};
+}
+
+void player::close() noexcept
+{
+  data_.clear();
+  offset_ = 0;
+  time_ = {};
+}
+
+bool player::next(ice::ui::input& event) noexcept
+{
+  if (!playing()) {
+    return false;
+  }
+  if (!event.decode(data_, offset_, time_)) {
+    offset_ = data_.size();
+    return false;
+  }
+  time_ = event.time;
+  return true;
+}
+
+void player::rewind() noexcept
+{
+  offset_ = data_.empty() ? 0 : sizeof(ice::ui::input::magic) + 1;
+  time_ = {};
+}
+
+}  // namespace ice::ui
@@ -0,0 +1,50 @@
+#pragma once
+#include <ice/ui/input.hpp>
+#include <chrono>
+#include <filesystem>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace ice::ui {
+
+// ================================================================================================
+// player
+// ================================================================================================
+
+// Reads input events from a recording that was written by ice::ui::recorder.
+// The player only decodes events. Callers apply them and decide whether to wait for the recorded times.
+
+class ICE_API player {
+public:
+  player() noexcept = default;
+  player(player&& other) = delete;
+  player(const player& other) = delete;
+  player& operator=(player&& other) = delete;
+  player& operator=(const player& other) = delete;
+  ~player() = default;
+
+  // Loads a recording from a file or from memory.
+  ice::error open(const std::filesystem::path& path) noexcept;
+  ice::error open(std::vector<std::uint8_t> data) noexcept;
+
+  void close() noexcept;
+
+  // Decodes the next event. Returns false at the end of the recording or when the recording is corrupt.
+  bool next(ice::ui::input& event) noexcept;
+
+  // Restarts the recording from the first event.
+  void rewind() noexcept;
+
+  bool playing() const noexcept
+  {
+    return offset_ < data_.size();
+  }
+
+private:
+  std::vector<std::uint8_t> data_;
+  std::size_t offset_{ 0 };
+  std::chrono::microseconds time_{ 0 };
+};
+
+}  // namespace ice::ui
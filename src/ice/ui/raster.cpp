@@ -0,0 +1,903 @@
+#include "raster.hpp"
+#include "kernels.hpp"
+#include <ice/ui/font.hpp>
+#include <ice/context.hpp>
+#include <ice/os/nuklear.hpp>
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <new>
+#include <vector>
+#include <cmath>
+
+namespace ice::ui {
+namespace {
+
+constexpr std::uint32_t make_color(nk_color c) noexcept
+{
+  const auto a = static_cast<std::uint32_t>(c.a);
+  const auto r = static_cast<std::uint32_t>(c.r);
+  const auto g = static_cast<std::uint32_t>(c.g);
+  const auto b = static_cast<std::uint32_t>(c.b);
+  return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+// Interpolates each channel of two colors with a weight in the range [0, 256].
+constexpr std::uint32_t lerp(std::uint32_t a, std::uint32_t b, std::uint32_t t) noexcept
+{
+  std::uint32_t color = 0;
+  for (std::uint32_t shift = 0; shift < 32; shift += 8) {
+    const auto ca = (a >> shift) & 0xFF;
+    const auto cb = (b >> shift) & 0xFF;
+    color |= ((ca * (256 - t) + cb * t) >> 8) << shift;
+  }
+  return color;
+}
+
+// Returns the fixed-point step that interpolates gradient weights from 0 to 256 over `size` pixels.
+constexpr std::uint32_t gradient_step(int size) noexcept
+{
+  if (size <= 1) {
+    return 0;
+  }
+  const auto n = static_cast<std::uint32_t>(size - 1);
+  return ((256u << 16) + n - 1) / n;
+}
+
+// Returns the horizontal inset of a rounded rectangle row.
+int inset(int h, int r, int row) noexcept
+{
+  if (r <= 0) {
+    return 0;
+  }
+  auto t = 0.0f;
+  if (row < r) {
+    t = static_cast<float>(r) - (static_cast<float>(row) + 0.5f);
+  } else if (row >= h - r) {
+    t = (static_cast<float>(row) + 0.5f) - static_cast<float>(h - r);
+  }
+  if (t <= 0.0f) {
+    return 0;
+  }
+  const auto rf = static_cast<float>(r);
+  return static_cast<int>(rf - std::sqrt(std::max(rf * rf - t * t, 0.0f)) + 0.5f);
+}
+
+// Ellipse inscribed into a rectangle.
+class oval {
+public:
+  oval(int x, int y, int w, int h) noexcept
+    : rx_(static_cast<float>(w) * 0.5f), ry_(static_cast<float>(h) * 0.5f), cx_(static_cast<float>(x) + rx_),
+      cy_(static_cast<float>(y) + ry_)
+  {}
+
+  // Returns the pixels of a row with centers inside the ellipse after growing the radii by `d`.
+  bool span(int row, float d, int& x0, int& x1) const noexcept
+  {
+    const auto rx = rx_ + d;
+    const auto ry = ry_ + d;
+    if (rx <= 0.0f || ry <= 0.0f) {
+      return false;
+    }
+    const auto dy = (static_cast<float>(row) + 0.5f - cy_) / ry;
+    const auto t = 1.0f - dy * dy;
+    if (t <= 0.0f) {
+      return false;
+    }
+    const auto hw = rx * std::sqrt(t);
+    x0 = static_cast<int>(std::ceil(cx_ - hw - 0.5f));
+    x1 = static_cast<int>(std::floor(cx_ + hw - 0.5f)) + 1;
+    return x0 < x1;
+  }
+
+  // Returns the coverage of a pixel in the range [0, 255].
+  // Uses the distance of the pixel center to the outline, approximated with the gradient of the implicit equation.
+  std::uint8_t coverage(int column, int row) const noexcept
+  {
+    if (rx_ <= 0.0f || ry_ <= 0.0f) {
+      return 0;
+    }
+    const auto rx2 = rx_ * rx_;
+    const auto ry2 = ry_ * ry_;
+    const auto dx = static_cast<float>(column) + 0.5f - cx_;
+    const auto dy = static_cast<float>(row) + 0.5f - cy_;
+    const auto f = dx * dx / rx2 + dy * dy / ry2 - 1.0f;
+    const auto gx = dx / rx2;
+    const auto gy = dy / ry2;
+    const auto g = 2.0f * std::sqrt(gx * gx + gy * gy);
+    const auto d = g > 1e-6f ? -f / g : 1.0f;
+    return static_cast<std::uint8_t>(std::clamp(d + 0.5f, 0.0f, 1.0f) * 255.0f + 0.5f);
+  }
+
+private:
+  float rx_;
+  float ry_;
+  float cx_;
+  float cy_;
+};
+
+constexpr std::size_t curve_segments = 16;
+constexpr std::size_t arc_segments = 22;
+constexpr std::size_t polygon_points = 64;
+
+template <typename Point>
+void arc(Point* points, int x, int y, int r, float a0, float a1) noexcept
+{
+  for (std::size_t i = 0; i <= arc_segments; i++) {
+    const auto a = a0 + (a1 - a0) * static_cast<float>(i) / static_cast<float>(arc_segments);
+    points[i].x = static_cast<float>(x) + std::cos(a) * static_cast<float>(r);
+    points[i].y = static_cast<float>(y) + std::sin(a) * static_cast<float>(r);
+  }
+}
+
+// Draws commands into the raster pixels. Pixels outside of the region are never modified.
+// Every pixel only depends on the command and its own coordinates, which makes the output independent of the region.
+class canvas {
+public:
+  using rect = ice::ui::raster::rect;
+
+  canvas(ice::ui::raster* raster, const rect& region) noexcept
+    : raster_(raster), kernels_(&kernels::get()), data_(raster->data()),
+      stride_(static_cast<std::size_t>(raster->cx())), region_(region), clip_(region)
+  {}
+
+  void clip(const rect& clip) noexcept
+  {
+    scissor(clip.x0, clip.y0, clip.x1 - clip.x0, clip.y1 - clip.y0);
+  }
+
+  void render(const nk_command* command) noexcept;
+
+private:
+  struct point {
+    float x{ 0.0f };
+    float y{ 0.0f };
+  };
+
+  void scissor(int x, int y, int w, int h) noexcept;
+  void span(int y, int x0, int x1, std::uint32_t color) noexcept;
+  void edge(int y, int x0, int x1, const oval& outer, const oval* inner, std::uint32_t color) noexcept;
+  void line(point a, point b, int thickness, std::uint32_t color) noexcept;
+  void polyline(const point* points, int count, bool closed, int thickness, std::uint32_t color) noexcept;
+  void polygon(const point* points, int count, std::uint32_t color) noexcept;
+  void rectangle(int x, int y, int w, int h, int rounding, int thickness, std::uint32_t color) noexcept;
+  void ellipse(int x, int y, int w, int h, int thickness, std::uint32_t color) noexcept;
+  void gradient(int x, int y, int w, int h, std::uint32_t tl, std::uint32_t tr, std::uint32_t br,
+    std::uint32_t bl) noexcept;
+  void text(const nk_command* command) noexcept;
+
+  ice::ui::raster* raster_;
+  const kernels* kernels_;
+  std::uint32_t* data_;
+  std::size_t stride_;
+  rect region_;
+  rect clip_;
+  std::vector<std::uint8_t> buffer_;
+};
+
+void canvas::render(const nk_command* command) noexcept
+{
+  switch (command->type) {
+  case NK_COMMAND_NOP:
+    break;
+  case NK_COMMAND_SCISSOR: {
+    const auto& c = *reinterpret_cast<const nk_command_scissor*>(command);
+    scissor(c.x, c.y, c.w, c.h);
+  } break;
+  case NK_COMMAND_LINE: {
+    const auto& c = *reinterpret_cast<const nk_command_line*>(command);
+    const point a{ static_cast<float>(c.begin.x), static_cast<float>(c.begin.y) };
+    const point b{ static_cast<float>(c.end.x), static_cast<float>(c.end.y) };
+    line(a, b, c.line_thickness, make_color(c.color));
+  } break;
+  case NK_COMMAND_CURVE: {
+    const auto& c = *reinterpret_cast<const nk_command_curve*>(command);
+    std::array<point, curve_segments + 1> points;
+    for (std::size_t i = 0; i <= curve_segments; i++) {
+      const auto t = static_cast<float>(i) / static_cast<float>(curve_segments);
+      const auto u = 1.0f - t;
+      const auto w0 = u * u * u;
+      const auto w1 = 3.0f * u * u * t;
+      const auto w2 = 3.0f * u * t * t;
+      const auto w3 = t * t * t;
+      points[i].x = w0 * c.begin.x + w1 * c.ctrl[0].x + w2 * c.ctrl[1].x + w3 * c.end.x;
+      points[i].y = w0 * c.begin.y + w1 * c.ctrl[0].y + w2 * c.ctrl[1].y + w3 * c.end.y;
+    }
+    polyline(points.data(), static_cast<int>(points.size()), false, c.line_thickness, make_color(c.color));
+  } break;
+  case NK_COMMAND_RECT: {
+    const auto& c = *reinterpret_cast<const nk_command_rect*>(command);
+    const auto thickness = std::max<int>(c.line_thickness, 1);
+    rectangle(c.x, c.y, c.w, c.h, c.rounding, thickness, make_color(c.color));
+  } break;
+  case NK_COMMAND_RECT_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_rect_filled*>(command);
+    rectangle(c.x, c.y, c.w, c.h, c.rounding, 0, make_color(c.color));
+  } break;
+  case NK_COMMAND_RECT_MULTI_COLOR: {
+    const auto& c = *reinterpret_cast<const nk_command_rect_multi_color*>(command);
+    gradient(c.x, c.y, c.w, c.h, make_color(c.left), make_color(c.top), make_color(c.right), make_color(c.bottom));
+  } break;
+  case NK_COMMAND_CIRCLE: {
+    const auto& c = *reinterpret_cast<const nk_command_circle*>(command);
+    const auto thickness = std::max<int>(c.line_thickness, 1);
+    ellipse(c.x, c.y, c.w, c.h, thickness, make_color(c.color));
+  } break;
+  case NK_COMMAND_CIRCLE_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_circle_filled*>(command);
+    ellipse(c.x, c.y, c.w, c.h, 0, make_color(c.color));
+  } break;
+  case NK_COMMAND_ARC: {
+    const auto& c = *reinterpret_cast<const nk_command_arc*>(command);
+    std::array<point, arc_segments + 1> points;
+    arc(points.data(), c.cx, c.cy, c.r, c.a[0], c.a[1]);
+    polyline(points.data(), static_cast<int>(points.size()), false, c.line_thickness, make_color(c.color));
+  } break;
+  case NK_COMMAND_ARC_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_arc_filled*>(command);
+    std::array<point, arc_segments + 2> points;
+    points[0] = { static_cast<float>(c.cx), static_cast<float>(c.cy) };
+    arc(points.data() + 1, c.cx, c.cy, c.r, c.a[0], c.a[1]);
+    polygon(points.data(), static_cast<int>(points.size()), make_color(c.color));
+  } break;
+  case NK_COMMAND_TRIANGLE: {
+    const auto& c = *reinterpret_cast<const nk_command_triangle*>(command);
+    const point points[] = {
+      { static_cast<float>(c.a.x), static_cast<float>(c.a.y) },
+      { static_cast<float>(c.b.x), static_cast<float>(c.b.y) },
+      { static_cast<float>(c.c.x), static_cast<float>(c.c.y) },
+    };
+    polyline(points, 3, true, c.line_thickness, make_color(c.color));
+  } break;
+  case NK_COMMAND_TRIANGLE_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_triangle_filled*>(command);
+    const point points[] = {
+      { static_cast<float>(c.a.x), static_cast<float>(c.a.y) },
+      { static_cast<float>(c.b.x), static_cast<float>(c.b.y) },
+      { static_cast<float>(c.c.x), static_cast<float>(c.c.y) },
+    };
+    polygon(points, 3, make_color(c.color));
+  } break;
+  case NK_COMMAND_POLYGON:
+  case NK_COMMAND_POLYGON_FILLED:
+  case NK_COMMAND_POLYLINE: {
+    const struct nk_vec2i* source = nullptr;
+    std::size_t count = 0;
+    std::uint32_t color = 0;
+    int thickness = 0;
+    if (command->type == NK_COMMAND_POLYGON_FILLED) {
+      const auto& c = *reinterpret_cast<const nk_command_polygon_filled*>(command);
+      source = c.points;
+      count = c.point_count;
+      color = make_color(c.color);
+    } else {
+      const auto& c = *reinterpret_cast<const nk_command_polygon*>(command);
+      source = c.points;
+      count = c.point_count;
+      color = make_color(c.color);
+      thickness = c.line_thickness;
+    }
+    std::array<point, polygon_points> points;
+    count = std::min(count, points.size());
+    for (std::size_t i = 0; i < count; i++) {
+      points[i] = { static_cast<float>(source[i].x), static_cast<float>(source[i].y) };
+    }
+    if (command->type == NK_COMMAND_POLYGON_FILLED) {
+      polygon(points.data(), static_cast<int>(count), color);
+    } else {
+      const auto closed = command->type == NK_COMMAND_POLYGON;
+      polyline(points.data(), static_cast<int>(count), closed, thickness, color);
+    }
+  } break;
+  case NK_COMMAND_CUSTOM: {
+    const auto& c = *reinterpret_cast<const nk_command_custom*>(command);
+    if (c.callback) {
+      c.callback(raster_, c.x, c.y, c.w, c.h, c.callback_data);
+    }
+  } break;
+  case NK_COMMAND_TEXT:
+    text(command);
+    break;
+  case NK_COMMAND_IMAGE:
+  default:
+    break;
+  }
+}
+
+void canvas::scissor(int x, int y, int w, int h) noexcept
+{
+  clip_.x0 = std::clamp(x, region_.x0, region_.x1);
+  clip_.y0 = std::clamp(y, region_.y0, region_.y1);
+  clip_.x1 = std::clamp(x + w, region_.x0, region_.x1);
+  clip_.y1 = std::clamp(y + h, region_.y0, region_.y1);
+}
+
+void canvas::span(int y, int x0, int x1, std::uint32_t color) noexcept
+{
+  if (y < clip_.y0 || y >= clip_.y1) {
+    return;
+  }
+  x0 = std::max(x0, clip_.x0);
+  x1 = std::min(x1, clip_.x1);
+  if (x0 >= x1) {
+    return;
+  }
+  const auto dst = data_ + static_cast<std::size_t>(y) * stride_ + x0;
+  const auto size = static_cast<std::size_t>(x1 - x0);
+  switch (color >> 24) {
+  case 0x00:
+    break;
+  case 0xFF:
+    kernels_->fill(dst, size, color);
+    break;
+  default:
+    kernels_->blend(dst, size, color);
+    break;
+  }
+}
+
+// Blends anti-aliased ellipse edge pixels. The coverage of a ring is limited by the coverage outside the inner ellipse.
+void canvas::edge(int y, int x0, int x1, const oval& outer, const oval* inner, std::uint32_t color) noexcept
+{
+  if (y < clip_.y0 || y >= clip_.y1) {
+    return;
+  }
+  x0 = std::max(x0, clip_.x0);
+  x1 = std::min(x1, clip_.x1);
+  std::array<std::uint8_t, 64> coverage;
+  for (auto x = x0; x < x1; x += static_cast<int>(coverage.size())) {
+    const auto size = std::min(x1 - x, static_cast<int>(coverage.size()));
+    for (int i = 0; i < size; i++) {
+      auto c = outer.coverage(x + i, y);
+      if (inner) {
+        c = std::min<std::uint8_t>(c, 255 - inner->coverage(x + i, y));
+      }
+      coverage[static_cast<std::size_t>(i)] = c;
+    }
+    const auto dst = data_ + static_cast<std::size_t>(y) * stride_ + x;
+    kernels_->cover(dst, static_cast<std::size_t>(size), color, coverage.data());
+  }
+}
+
+void canvas::line(point a, point b, int thickness, std::uint32_t color) noexcept
+{
+  if (thickness > 1) {
+    const auto dx = b.x - a.x;
+    const auto dy = b.y - a.y;
+    const auto length = std::sqrt(dx * dx + dy * dy);
+    if (length <= 0.0f) {
+      return;
+    }
+    const auto nx = -dy / length * static_cast<float>(thickness) * 0.5f;
+    const auto ny = dx / length * static_cast<float>(thickness) * 0.5f;
+    const point points[] = {
+      { a.x + nx, a.y + ny },
+      { b.x + nx, b.y + ny },
+      { b.x - nx, b.y - ny },
+      { a.x - nx, a.y - ny },
+    };
+    polygon(points, 4, color);
+    return;
+  }
+  auto x0 = static_cast<int>(std::lround(a.x));
+  auto y0 = static_cast<int>(std::lround(a.y));
+  const auto x1 = static_cast<int>(std::lround(b.x));
+  const auto y1 = static_cast<int>(std::lround(b.y));
+  const auto dx = std::abs(x1 - x0);
+  const auto dy = -std::abs(y1 - y0);
+  const auto sx = x0 < x1 ? 1 : -1;
+  const auto sy = y0 < y1 ? 1 : -1;
+  auto error = dx + dy;
+  while (true) {
+    span(y0, x0, x0 + 1, color);
+    if (x0 == x1 && y0 == y1) {
+      break;
+    }
+    const auto e2 = 2 * error;
+    if (e2 >= dy) {
+      error += dy;
+      x0 += sx;
+    }
+    if (e2 <= dx) {
+      error += dx;
+      y0 += sy;
+    }
+  }
+}
+
+void canvas::polyline(const point* points, int count, bool closed, int thickness, std::uint32_t color) noexcept
+{
+  for (int i = 1; i < count; i++) {
+    line(points[i - 1], points[i], thickness, color);
+  }
+  if (closed && count > 2) {
+    line(points[count - 1], points[0], thickness, color);
+  }
+}
+
+void canvas::polygon(const point* points, int count, std::uint32_t color) noexcept
+{
+  if (count < 3) {
+    return;
+  }
+  auto min = points[0].y;
+  auto max = points[0].y;
+  for (int i = 1; i < count; i++) {
+    min = std::min(min, points[i].y);
+    max = std::max(max, points[i].y);
+  }
+  const auto y0 = std::max(static_cast<int>(std::ceil(min - 0.5f)), clip_.y0);
+  const auto y1 = std::min(static_cast<int>(std::ceil(max - 0.5f)), clip_.y1);
+  std::array<float, polygon_points> intersections;
+  for (auto y = y0; y < y1; y++) {
+    const auto yc = static_cast<float>(y) + 0.5f;
+    std::size_t size = 0;
+    for (int i = 0; i < count && size < intersections.size(); i++) {
+      const auto& a = points[i];
+      const auto& b = points[(i + 1) % count];
+      if ((a.y <= yc && yc < b.y) || (b.y <= yc && yc < a.y)) {
+        intersections[size++] = a.x + (yc - a.y) * (b.x - a.x) / (b.y - a.y);
+      }
+    }
+    std::sort(intersections.begin(), intersections.begin() + size);
+    for (std::size_t i = 0; i + 1 < size; i += 2) {
+      const auto x0 = static_cast<int>(std::ceil(intersections[i] - 0.5f));
+      const auto x1 = static_cast<int>(std::ceil(intersections[i + 1] - 0.5f));
+      span(y, x0, x1, color);
+    }
+  }
+}
+
+void canvas::rectangle(int x, int y, int w, int h, int rounding, int thickness, std::uint32_t color) noexcept
+{
+  if (w <= 0 || h <= 0) {
+    return;
+  }
+  const auto r = std::min({ rounding, w / 2, h / 2 });
+  const auto ix = x + thickness;
+  const auto iy = y + thickness;
+  const auto iw = w - thickness * 2;
+  const auto ih = h - thickness * 2;
+  const auto ir = std::min({ std::max(r - thickness, 0), iw / 2, ih / 2 });
+  const auto y0 = std::max(y, clip_.y0);
+  const auto y1 = std::min(y + h, clip_.y1);
+  for (auto row = y0; row < y1; row++) {
+    const auto o = inset(h, r, row - y);
+    if (thickness <= 0 || iw <= 0 || ih <= 0 || row < iy || row >= iy + ih) {
+      span(row, x + o, x + w - o, color);
+      continue;
+    }
+    const auto i = inset(ih, ir, row - iy);
+    span(row, x + o, ix + i, color);
+    span(row, ix + iw - i, x + w - o, color);
+  }
+}
+
+void canvas::ellipse(int x, int y, int w, int h, int thickness, std::uint32_t color) noexcept
+{
+  if (w <= 0 || h <= 0 || !(color >> 24)) {
+    return;
+  }
+  const oval outer{ x, y, w, h };
+  const oval inner{ x + thickness, y + thickness, w - thickness * 2, h - thickness * 2 };
+  const auto hollow = thickness > 0 && w - thickness * 2 > 0 && h - thickness * 2 > 0;
+  const auto y0 = std::max(y, clip_.y0);
+  const auto y1 = std::min(y + h, clip_.y1);
+  for (auto row = y0; row < y1; row++) {
+    int ox0 = 0;
+    int ox1 = 0;
+    if (!outer.span(row, 0.5f, ox0, ox1)) {
+      continue;
+    }
+    ox0 = std::max(ox0, x);
+    ox1 = std::min(ox1, x + w);
+    int ix0 = 0;
+    int ix1 = 0;
+    if (hollow) {
+      // Pixels deep inside of the inner ellipse are not covered.
+      if (inner.span(row, -1.0f, ix0, ix1)) {
+        edge(row, ox0, ix0, outer, &inner, color);
+        edge(row, ix1, ox1, outer, &inner, color);
+      } else {
+        edge(row, ox0, ox1, outer, &inner, color);
+      }
+    } else {
+      // Pixels deep inside of the outer ellipse are fully covered.
+      if (outer.span(row, -1.0f, ix0, ix1)) {
+        edge(row, ox0, ix0, outer, nullptr, color);
+        span(row, ix0, ix1, color);
+        edge(row, ix1, ox1, outer, nullptr, color);
+      } else {
+        edge(row, ox0, ox1, outer, nullptr, color);
+      }
+    }
+  }
+}
+
+void canvas::gradient(int x, int y, int w, int h, std::uint32_t tl, std::uint32_t tr, std::uint32_t br,
+  std::uint32_t bl) noexcept
+{
+  if (w <= 0 || h <= 0) {
+    return;
+  }
+  const auto x0 = std::max(x, clip_.x0);
+  const auto x1 = std::min(x + w, clip_.x1);
+  const auto y0 = std::max(y, clip_.y0);
+  const auto y1 = std::min(y + h, clip_.y1);
+  if (x0 >= x1) {
+    return;
+  }
+  const auto sx = gradient_step(w);
+  const auto sy = gradient_step(h);
+  const auto t = static_cast<std::uint32_t>(x0 - x) * sx;
+  for (auto row = y0; row < y1; row++) {
+    const auto v = (static_cast<std::uint32_t>(row - y) * sy) >> 16;
+    const auto dst = data_ + static_cast<std::size_t>(row) * stride_ + x0;
+    const auto size = static_cast<std::size_t>(x1 - x0);
+    kernels_->gradient(dst, size, lerp(tl, bl, v), lerp(tr, br, v), t, sx);
+  }
+}
+
+}  // namespace
+
+// Blends glyph coverage bitmaps. Glyphs are clipped to the command bounds, which keeps damage and tiles consistent.
+void canvas::text(const nk_command* command) noexcept
+{
+  const auto& c = *reinterpret_cast<const nk_command_text*>(command);
+  const auto color = make_color(c.foreground);
+  if (c.length < 1 || !c.font || !c.font->userdata.ptr || !(color >> 24)) {
+    return;
+  }
+  const auto& font = *static_cast<const ice::ui::font*>(c.font->userdata.ptr);
+  const auto b = raster::bounds(command);
+  const auto x0 = std::max(b.x0, clip_.x0);
+  const auto y0 = std::max(b.y0, clip_.y0);
+  const auto x1 = std::min(b.x1, clip_.x1);
+  const auto y1 = std::min(b.y1, clip_.y1);
+  if (x0 >= x1 || y0 >= y1) {
+    return;
+  }
+  const auto baseline = c.y + static_cast<int>(std::lround(font.ascent()));
+  auto pen = static_cast<float>(c.x);
+  for (int i = 0; i < c.length;) {
+    nk_rune rune = 0;
+    const auto length = nk_utf_decode(c.string + i, &rune, c.length - i);
+    if (!length) {
+      break;
+    }
+    i += length;
+    const auto code = static_cast<char32_t>(rune);
+    const auto x = static_cast<int>(std::lround(pen));
+    pen += font.advance(code);
+    if (x >= x1) {
+      break;
+    }
+    ice::ui::font::glyph glyph;
+    if (!font.find(code, glyph) && !font.render(code, buffer_, glyph)) {
+      continue;
+    }
+    const auto gx0 = std::max(x + glyph.x, x0);
+    const auto gx1 = std::min(x + glyph.x + glyph.cx, x1);
+    const auto gy0 = std::max(baseline + glyph.y, y0);
+    const auto gy1 = std::min(baseline + glyph.y + glyph.cy, y1);
+    if (gx0 >= gx1 || gy0 >= gy1) {
+      continue;
+    }
+    const auto size = static_cast<std::size_t>(gx1 - gx0);
+    for (auto row = gy0; row < gy1; row++) {
+      const auto src = glyph.data + static_cast<std::size_t>(row - baseline - glyph.y) * glyph.stride +
+        (gx0 - x - glyph.x);
+      kernels_->cover(data_ + static_cast<std::size_t>(row) * stride_ + gx0, size, color, src);
+    }
+  }
+}
+
+ice::error raster::resize(int cx, int cy) noexcept
+{
+  if (cx == cx_ && cy == cy_ && data_) {
+    return {};
+  }
+  if (cx <= 0 || cy <= 0) {
+    data_.reset();
+    cx_ = 0;
+    cy_ = 0;
+    return {};
+  }
+  const auto size = static_cast<std::size_t>(cx) * static_cast<std::size_t>(cy);
+  data_.reset(new (std::nothrow) std::uint32_t[size]);
+  if (!data_) {
+    cx_ = 0;
+    cy_ = 0;
+    return std::errc::not_enough_memory;
+  }
+  cx_ = cx;
+  cy_ = cy;
+  return {};
+}
+
+void raster::clear(std::uint32_t color) noexcept
+{
+  if (data_) {
+    kernels::get().fill(data_.get(), static_cast<std::size_t>(cx_) * static_cast<std::size_t>(cy_), color);
+  }
+}
+
+void raster::clear(std::uint32_t color, const rect& region) noexcept
+{
+  const auto x0 = std::max(region.x0, 0);
+  const auto x1 = std::min(region.x1, cx_);
+  if (!data_ || x0 >= x1) {
+    return;
+  }
+  const auto y0 = std::max(region.y0, 0);
+  const auto y1 = std::min(region.y1, cy_);
+  const auto& kernels = kernels::get();
+  const auto size = static_cast<std::size_t>(x1 - x0);
+  for (auto y = y0; y < y1; y++) {
+    kernels.fill(data_.get() + static_cast<std::size_t>(y) * static_cast<std::size_t>(cx_) + x0, size, color);
+  }
+}
+
+void raster::render(nk_context* context) noexcept
+{
+  render(context, { 0, 0, cx_, cy_ });
+}
+
+void raster::render(nk_context* context, const rect& region) noexcept
+{
+  const auto r = clamp(region);
+  if (!data_ || r.x0 >= r.x1 || r.y0 >= r.y1) {
+    return;
+  }
+  canvas canvas{ this, r };
+  const nk_command* command = nullptr;
+  nk_foreach(command, context)
+  {
+    prepare(command);
+    canvas.render(command);
+  }
+}
+
+void raster::render(nk_context* context, std::uint32_t background, ice::context& workers,
+  std::size_t concurrency) noexcept
+{
+  render(context, { 0, 0, cx_, cy_ }, background, workers, concurrency);
+}
+
+void raster::render(nk_context* context, const rect& region, std::uint32_t background, ice::context& workers,
+  std::size_t concurrency) noexcept
+{
+  const auto r = clamp(region);
+  if (!data_ || r.x0 >= r.x1 || r.y0 >= r.y1) {
+    return;
+  }
+  region_ = r;
+  background_ = background;
+  columns_ = (r.x1 - r.x0 + tile - 1) / tile;
+  rows_ = (r.y1 - r.y0 + tile - 1) / tile;
+  const auto tiles = static_cast<std::size_t>(columns_) * static_cast<std::size_t>(rows_);
+
+  // Bin commands into tiles together with the scissor rectangle that is active when they are executed.
+  items_.clear();
+  offsets_.assign(tiles + 1, 0);
+  rect clip{ 0, 0, cx_, cy_ };
+  const nk_command* command = nullptr;
+  nk_foreach(command, context)
+  {
+    if (command->type == NK_COMMAND_SCISSOR) {
+      const auto& c = *reinterpret_cast<const nk_command_scissor*>(command);
+      clip = clamp({ c.x, c.y, c.x + c.w, c.y + c.h });
+      continue;
+    }
+    prepare(command);
+    if (command->type == NK_COMMAND_CUSTOM) {
+      // Custom callbacks draw without a clip rectangle and can not be split into tiles.
+      clear(background, r);
+      render(context, r);
+      return;
+    }
+    const auto b = bounds(command);
+    const auto x0 = std::max({ b.x0, clip.x0, r.x0 });
+    const auto y0 = std::max({ b.y0, clip.y0, r.y0 });
+    const auto x1 = std::min({ b.x1, clip.x1, r.x1 });
+    const auto y1 = std::min({ b.y1, clip.y1, r.y1 });
+    if (x0 >= x1 || y0 >= y1) {
+      continue;
+    }
+    const item item{ command, clip, (x0 - r.x0) / tile, (y0 - r.y0) / tile, (x1 - 1 - r.x0) / tile,
+      (y1 - 1 - r.y0) / tile };
+    for (auto row = item.row0; row <= item.row1; row++) {
+      for (auto column = item.column0; column <= item.column1; column++) {
+        offsets_[static_cast<std::size_t>(row * columns_ + column) + 1]++;
+      }
+    }
+    items_.push_back(item);
+  }
+  for (std::size_t i = 1; i <= tiles; i++) {
+    offsets_[i] += offsets_[i - 1];
+  }
+  entries_.resize(offsets_[tiles]);
+  cursors_.assign(offsets_.begin(), offsets_.end() - 1);
+  for (const auto& item : items_) {
+    for (auto row = item.row0; row <= item.row1; row++) {
+      for (auto column = item.column0; column <= item.column1; column++) {
+        entries_[cursors_[static_cast<std::size_t>(row * columns_ + column)]++] = { item.command, item.clip };
+      }
+    }
+  }
+
+  // Render tiles on the calling thread and the workers, then wait for all posted tasks to return.
+  // Small regions, like single damaged tiles, do not post tasks that would find no tiles left.
+  concurrency = std::min(concurrency, tiles - 1);
+  next_.store(0, std::memory_order_relaxed);
+  pending_.store(concurrency, std::memory_order_release);
+  for (std::size_t i = 0; i < concurrency; i++) {
+    workers.post([this]() noexcept {
+      work();
+      if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        pending_.notify_one();
+      }
+    });
+  }
+  work();
+  for (auto size = pending_.load(std::memory_order_acquire); size; size = pending_.load(std::memory_order_acquire)) {
+    pending_.wait(size, std::memory_order_acquire);
+  }
+}
+
+void raster::work() noexcept
+{
+  const auto tiles = static_cast<std::size_t>(columns_) * static_cast<std::size_t>(rows_);
+  for (auto i = next_.fetch_add(1, std::memory_order_relaxed); i < tiles;
+       i = next_.fetch_add(1, std::memory_order_relaxed)) {
+    const auto column = static_cast<int>(i % static_cast<std::size_t>(columns_));
+    const auto row = static_cast<int>(i / static_cast<std::size_t>(columns_));
+    const auto x0 = region_.x0 + column * tile;
+    const auto y0 = region_.y0 + row * tile;
+    const rect region{ x0, y0, std::min(x0 + tile, region_.x1), std::min(y0 + tile, region_.y1) };
+    clear(background_, region);
+    canvas canvas{ this, region };
+    for (auto entry = offsets_[i]; entry < offsets_[i + 1]; entry++) {
+      canvas.clip(entries_[entry].clip);
+      canvas.render(entries_[entry].command);
+    }
+  }
+}
+
+raster::rect raster::clamp(const rect& region) const noexcept
+{
+  const auto x0 = std::clamp(region.x0, 0, cx_);
+  const auto y0 = std::clamp(region.y0, 0, cy_);
+  return { x0, y0, std::clamp(region.x1, x0, cx_), std::clamp(region.y1, y0, cy_) };
+}
+
+raster::rect raster::bounds(const nk_command* command) noexcept
+{
+  rect r{ std::numeric_limits<int>::max(), std::numeric_limits<int>::max(), std::numeric_limits<int>::min(),
+    std::numeric_limits<int>::min() };
+  const auto add = [&r](int x, int y) noexcept {
+    r.x0 = std::min(r.x0, x);
+    r.y0 = std::min(r.y0, y);
+    r.x1 = std::max(r.x1, x);
+    r.y1 = std::max(r.y1, y);
+  };
+  const auto box = [](int x, int y, int w, int h) noexcept {
+    return rect{ x, y, x + std::max(w, 0), y + std::max(h, 0) };
+  };
+  const auto grow = [&r](int size) noexcept {
+    r.x0 -= size;
+    r.y0 -= size;
+    r.x1 += size + 1;
+    r.y1 += size + 1;
+    return r;
+  };
+  switch (command->type) {
+  case NK_COMMAND_LINE: {
+    const auto& c = *reinterpret_cast<const nk_command_line*>(command);
+    add(c.begin.x, c.begin.y);
+    add(c.end.x, c.end.y);
+    return grow(c.line_thickness);
+  }
+  case NK_COMMAND_CURVE: {
+    const auto& c = *reinterpret_cast<const nk_command_curve*>(command);
+    add(c.begin.x, c.begin.y);
+    add(c.ctrl[0].x, c.ctrl[0].y);
+    add(c.ctrl[1].x, c.ctrl[1].y);
+    add(c.end.x, c.end.y);
+    return grow(c.line_thickness);
+  }
+  case NK_COMMAND_RECT: {
+    const auto& c = *reinterpret_cast<const nk_command_rect*>(command);
+    return box(c.x, c.y, c.w, c.h);
+  }
+  case NK_COMMAND_RECT_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_rect_filled*>(command);
+    return box(c.x, c.y, c.w, c.h);
+  }
+  case NK_COMMAND_RECT_MULTI_COLOR: {
+    const auto& c = *reinterpret_cast<const nk_command_rect_multi_color*>(command);
+    return box(c.x, c.y, c.w, c.h);
+  }
+  case NK_COMMAND_CIRCLE: {
+    const auto& c = *reinterpret_cast<const nk_command_circle*>(command);
+    return box(c.x, c.y, c.w, c.h);
+  }
+  case NK_COMMAND_CIRCLE_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_circle_filled*>(command);
+    return box(c.x, c.y, c.w, c.h);
+  }
+  case NK_COMMAND_ARC: {
+    const auto& c = *reinterpret_cast<const nk_command_arc*>(command);
+    add(c.cx - c.r, c.cy - c.r);
+    add(c.cx + c.r, c.cy + c.r);
+    return grow(c.line_thickness);
+  }
+  case NK_COMMAND_ARC_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_arc_filled*>(command);
+    add(c.cx - c.r, c.cy - c.r);
+    add(c.cx + c.r, c.cy + c.r);
+    return grow(0);
+  }
+  case NK_COMMAND_TRIANGLE: {
+    const auto& c = *reinterpret_cast<const nk_command_triangle*>(command);
+    add(c.a.x, c.a.y);
+    add(c.b.x, c.b.y);
+    add(c.c.x, c.c.y);
+    return grow(c.line_thickness);
+  }
+  case NK_COMMAND_TRIANGLE_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_triangle_filled*>(command);
+    add(c.a.x, c.a.y);
+    add(c.b.x, c.b.y);
+    add(c.c.x, c.c.y);
+    return grow(0);
+  }
+  case NK_COMMAND_POLYGON:
+  case NK_COMMAND_POLYLINE: {
+    const auto& c = *reinterpret_cast<const nk_command_polygon*>(command);
+    for (unsigned short i = 0; i < c.point_count && i < polygon_points; i++) {
+      add(c.points[i].x, c.points[i].y);
+    }
+    return c.point_count ? grow(c.line_thickness) : rect{};
+  }
+  case NK_COMMAND_POLYGON_FILLED: {
+    const auto& c = *reinterpret_cast<const nk_command_polygon_filled*>(command);
+    for (unsigned short i = 0; i < c.point_count && i < polygon_points; i++) {
+      add(c.points[i].x, c.points[i].y);
+    }
+    return c.point_count ? grow(0) : rect{};
+  }
+  case NK_COMMAND_TEXT: {
+    // The text box can be lower than the font and glyphs can overhang it with bearings, accents and descenders.
+    const auto& c = *reinterpret_cast<const nk_command_text*>(command);
+    const auto height = static_cast<int>(std::ceil(c.height));
+    const auto r = box(c.x, c.y, c.w, std::max(static_cast<int>(c.h), height));
+    const auto overhang = std::max(2, height / 2);
+    return { r.x0 - overhang, r.y0 - overhang, r.x1 + overhang, r.y1 + overhang };
+  }
+  case NK_COMMAND_IMAGE: {
+    const auto& c = *reinterpret_cast<const nk_command_image*>(command);
+    return box(c.x, c.y, c.w, c.h);
+  }
+  case NK_COMMAND_CUSTOM: {
+    const auto& c = *reinterpret_cast<const nk_command_custom*>(command);
+    return box(c.x, c.y, c.w, c.h);
+  }
+  default:
+    break;
+  }
+  return {};
+}
+
+void raster::prepare(const nk_command* command) noexcept
+{
+  if (command->type == NK_COMMAND_TEXT) {
+    const auto& c = *reinterpret_cast<const nk_command_text*>(command);
+    if (c.length > 0 && c.font && c.font->userdata.ptr) {
+      const auto font = static_cast<ice::ui::font*>(c.font->userdata.ptr);
+      font->prepare({ c.string, static_cast<std::size_t>(c.length) });
+    }
+  }
+}
+
+}  // namespace ice::ui
@@ -0,0 +1,122 @@
+#pragma once
+#include <ice/error.hpp>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+extern "C" struct nk_context;
+extern "C" struct nk_command;
+
+namespace ice {
+
+class context;
+
+}  // namespace ice
+
+namespace ice::ui {
+
+// ================================================================================================
+// raster
+// ================================================================================================
+
+// Software rasterizer for nuklear command lists.
+// Pixels are stored as 0x00RRGGBB, which matches both 32-bit X11 ZPixmap images and 32-bit DIBs.
+
+class ICE_API raster {
+public:
+  struct rect {
+    int x0{ 0 };
+    int y0{ 0 };
+    int x1{ 0 };
+    int y1{ 0 };
+  };
+
+  static constexpr int tile = 64;
+
+  raster() noexcept = default;
+  raster(raster&& other) = delete;
+  raster(const raster& other) = delete;
+  raster& operator=(raster&& other) = delete;
+  raster& operator=(const raster& other) = delete;
+  ~raster() = default;
+
+  ice::error resize(int cx, int cy) noexcept;
+
+  void clear(std::uint32_t color) noexcept;
+  void clear(std::uint32_t color, const rect& region) noexcept;
+
+  // Renders the command list. Pixels outside of the region are not modified.
+  void render(nk_context* context) noexcept;
+  void render(nk_context* context, const rect& region) noexcept;
+
+  // Clears and renders the command list in tiles on the calling thread and up to `concurrency` tasks posted to
+  // the workers context. The output is identical to the single-threaded overloads. Returns after all posted tasks
+  // finished, which requires at least one thread to run the workers context when `concurrency` is not zero.
+  void render(nk_context* context, std::uint32_t background, ice::context& workers, std::size_t concurrency) noexcept;
+  void render(nk_context* context, const rect& region, std::uint32_t background, ice::context& workers,
+    std::size_t concurrency) noexcept;
+
+  // Returns the area that can be modified by the command, ignoring scissor commands.
+  static rect bounds(const nk_command* command) noexcept;
+
+  constexpr int cx() const noexcept
+  {
+    return cx_;
+  }
+
+  constexpr int cy() const noexcept
+  {
+    return cy_;
+  }
+
+  std::uint32_t* data() noexcept
+  {
+    return data_.get();
+  }
+
+  const std::uint32_t* data() const noexcept
+  {
+    return data_.get();
+  }
+
+private:
+  struct entry {
+    const nk_command* command{ nullptr };
+    rect clip;
+  };
+
+  struct item {
+    const nk_command* command{ nullptr };
+    rect clip;
+    int column0{ 0 };
+    int row0{ 0 };
+    int column1{ 0 };
+    int row1{ 0 };
+  };
+
+  // Caches font glyphs used by text commands. Called serially before commands are rendered.
+  static void prepare(const nk_command* command) noexcept;
+
+  void work() noexcept;
+  rect clamp(const rect& region) const noexcept;
+
+  std::unique_ptr<std::uint32_t[]> data_;
+  int cx_{ 0 };
+  int cy_{ 0 };
+
+  // Tiled rendering state.
+  rect region_;
+  int columns_{ 0 };
+  int rows_{ 0 };
+  std::uint32_t background_{ 0 };
+  std::vector<item> items_;
+  std::vector<entry> entries_;
+  std::vector<std::size_t> offsets_;
+  std::vector<std::size_t> cursors_;
+  std::atomic_size_t next_{ 0 };
+  std::atomic_size_t pending_{ 0 };
+};
+
+}  // namespace ice::ui
@@ -0,0 +1,84 @@
+#include "recorder.hpp"
+#include <algorithm>
+#include <iterator>
+
+namespace ice::ui {
+namespace {
+
+// Size of the buffer that is written to the file at the end of a frame.
+constexpr std::size_t flush_size = 64 * 1024;
+
+}  // namespace
+
+recorder::~recorder()
+{
+  close();
+}
+
+ice::error recorder::open(const std::filesystem::path& path, clock::time_point start) noexcept
+{
+  if (recording_) {
+    return ice::errc::not_available;
+  }
+  data_.clear();
+  if (!path.empty()) {
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_) {
+      return std::errc::no_such_file_or_directory;
+    }
+  }
+  data_.insert(data_.end(), std::begin(ice::ui::input::magic), std::end(ice::ui::input::magic));
+  data_.push_back(ice::ui::input::version);
+  start_ = start;
+  time_ = {};
+  recording_ = true;
+  failed_ = false;
+  return {};
+}
+
+ice::error recorder::close() noexcept
+{
+  if (!recording_) {
+    return {};
+  }
+  recording_ = false;
+  auto e = flush();
+  if (file_.is_open()) {
+    file_.close();
+    if (!file_ && !e) {
+      e = std::errc::io_error;
+    }
+  }
+  return e;
+}
+
+void recorder::write(ice::ui::input event, clock::time_point time) noexcept
+{
+  if (!recording_) {
+    return;
+  }
+  event.time = std::max(std::chrono::duration_cast<std::chrono::microseconds>(time - start_), time_);
+  event.encode(data_, time_);
+  time_ = event.time;
+  if (event.type == ice::ui::input::type::frame && data_.size() >= flush_size) {
+    flush();
+  }
+}
+
+ice::error recorder::flush() noexcept
+{
+  if (!file_.is_open()) {
+    return {};
+  }
+  if (!data_.empty() && !failed_) {
+    file_.write(reinterpret_cast<const char*>(data_.data()), static_cast<std::streamsize>(data_.size()));
+    failed_ = !file_;
+  }
+  data_.clear();
+  if (failed_) {
+    return std::errc::io_error;
+  }
+  return {};
+}
+
+}  // namespace ice::ui
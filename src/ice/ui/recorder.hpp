@@ -0,0 +1,62 @@
+#pragma once
+#include <ice/ui/input.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include <cstdint>
+
+namespace ice::ui {
+
+// ================================================================================================
+// recorder
+// ================================================================================================
+
+// Writes input events into a compact binary recording that can be replayed with ice::ui::player.
+// A recording starts with the magic "ICEI" and a version byte. Each event is stored as a type byte, the time since
+// the previous event in microseconds and the fields of the type. Integers are stored as variable length quantities
+// and floats as little endian IEEE 754 values.
+
+class ICE_API recorder {
+public:
+  using clock = std::chrono::steady_clock;
+
+  recorder() noexcept = default;
+  recorder(recorder&& other) = delete;
+  recorder(const recorder& other) = delete;
+  recorder& operator=(recorder&& other) = delete;
+  recorder& operator=(const recorder& other) = delete;
+  ~recorder();
+
+  // Starts a recording. Events are kept in memory when the path is empty and written to the file otherwise.
+  ice::error open(const std::filesystem::path& path = {}, clock::time_point start = clock::now()) noexcept;
+
+  // Writes the remaining events to the file and stops the recording.
+  ice::error close() noexcept;
+
+  // Encodes an event. The time of the event is replaced with the time since the recording started.
+  void write(ice::ui::input event, clock::time_point time = clock::now()) noexcept;
+
+  // Returns the encoded events that were not written to the file yet.
+  const std::vector<std::uint8_t>& data() const noexcept
+  {
+    return data_;
+  }
+
+  constexpr bool recording() const noexcept
+  {
+    return recording_;
+  }
+
+private:
+  ice::error flush() noexcept;
+
+  std::vector<std::uint8_t> data_;
+  std::ofstream file_;
+  clock::time_point start_;
+  std::chrono::microseconds time_{ 0 };
+  bool recording_{ false };
+  bool failed_{ false };
+};
+
+}  // namespace ice::ui
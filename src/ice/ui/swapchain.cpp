@@ -0,0 +1,57 @@
+#include "swapchain.hpp"
+
+namespace ice::ui {
+
+void swapchain::publish() noexcept
+{
+  auto state = state_.load(std::memory_order_relaxed);
+  while (!state_.compare_exchange_weak(state, back_ | state_fresh | (state & (state_woken | state_closed)),
+    std::memory_order_acq_rel, std::memory_order_relaxed)) {
+  }
+  if (state & state_fresh) {
+    dropped_++;
+  }
+  published_++;
+  back_ = state & state_index;
+  state_.notify_one();
+}
+
+void swapchain::wake() noexcept
+{
+  state_.fetch_or(state_woken, std::memory_order_release);
+  state_.notify_one();
+}
+
+void swapchain::close() noexcept
+{
+  state_.fetch_or(state_closed, std::memory_order_release);
+  state_.notify_one();
+}
+
+void swapchain::open() noexcept
+{
+  state_.fetch_and(~state_closed, std::memory_order_release);
+}
+
+const ice::ui::frame* swapchain::acquire() noexcept
+{
+  constexpr auto signals = state_fresh | state_woken | state_closed;
+  auto state = state_.load(std::memory_order_acquire);
+  while (!(state & signals)) {
+    state_.wait(state, std::memory_order_acquire);
+    state = state_.load(std::memory_order_acquire);
+  }
+
+  // Take the ready frame when it is fresh and clear the wake flag.
+  auto next = 0u;
+  do {
+    next = state & state_fresh ? front_ | (state & state_closed) : state & (state_index | state_closed);
+  } while (!state_.compare_exchange_weak(state, next, std::memory_order_acq_rel, std::memory_order_acquire));
+  if (!(state & state_fresh)) {
+    return nullptr;
+  }
+  front_ = state & state_index;
+  return &frames_[front_];
+}
+
+}  // namespace ice::ui
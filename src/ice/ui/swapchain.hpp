@@ -0,0 +1,82 @@
+#pragma once
+#include <ice/ui/frame.hpp>
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace ice::ui {
+
+// ================================================================================================
+// swapchain
+// ================================================================================================
+
+// Lock-free handoff of frames from one producer thread to one consumer thread with three frames.
+// The producer fills the back frame and publishes it, which swaps it with the ready frame. The consumer acquires the
+// ready frame, which swaps it with the front frame. A frame that is published before the previous one was acquired
+// replaces it, so that the producer never waits and the consumer always renders the newest frame.
+
+class ICE_API swapchain {
+public:
+  swapchain() noexcept = default;
+  swapchain(swapchain&& other) = delete;
+  swapchain(const swapchain& other) = delete;
+  swapchain& operator=(swapchain&& other) = delete;
+  swapchain& operator=(const swapchain& other) = delete;
+  ~swapchain() = default;
+
+  // Returns the frame that is owned by the producer.
+  ice::ui::frame& back() noexcept
+  {
+    return frames_[back_];
+  }
+
+  // Hands the back frame to the consumer. Called by the producer.
+  void publish() noexcept;
+
+  // Wakes the consumer without publishing a frame. Called by the producer.
+  void wake() noexcept;
+
+  // Wakes the consumer and makes all following acquire calls return immediately.
+  void close() noexcept;
+
+  // Reopens a closed swapchain. Must not be called while the consumer is waiting.
+  void open() noexcept;
+
+  // Blocks until a frame is published, wake is called or the swapchain is closed. Called by the consumer.
+  // Returns the published frame, which is owned by the consumer until the next call, or nullptr when no frame was
+  // published since the last call.
+  const ice::ui::frame* acquire() noexcept;
+
+  bool closed() const noexcept
+  {
+    return state_.load(std::memory_order_acquire) & state_closed;
+  }
+
+  // Returns the number of published frames.
+  constexpr std::size_t published() const noexcept
+  {
+    return published_;
+  }
+
+  // Returns the number of published frames that were replaced before the consumer acquired them.
+  constexpr std::size_t dropped() const noexcept
+  {
+    return dropped_;
+  }
+
+private:
+  // The state holds the index of the ready frame and flags.
+  static constexpr unsigned state_index = 0x03;
+  static constexpr unsigned state_fresh = 0x04;
+  static constexpr unsigned state_woken = 0x08;
+  static constexpr unsigned state_closed = 0x10;
+
+  std::array<ice::ui::frame, 3> frames_;
+  std::atomic_uint state_{ 2 };
+  unsigned back_{ 0 };
+  unsigned front_{ 1 };
+  std::size_t published_{ 0 };
+  std::size_t dropped_{ 0 };
+};
+
+}  // namespace ice::ui
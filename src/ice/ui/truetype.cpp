@@ -0,0 +1,367 @@
+#include "truetype.hpp"
+#include <ice/format.hpp>
+#include <ice/os/nuklear.hpp>
+#include <ice/path.hpp>
+#include <stb_truetype.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+
+namespace ice::ui {
+namespace {
+
+// Families used when the requested family is empty or not installed.
+constexpr std::string_view fallback_families[] = {
+  "DejaVu Sans",
+  "Liberation Sans",
+  "Noto Sans",
+  "Segoe UI",
+  "Arial",
+};
+
+// Lower case letters and digits, which makes "DejaVu Sans", "dejavu-sans" and "DejaVuSans" compare equal.
+std::string normalize(std::string_view text)
+{
+  std::string result;
+  result.reserve(text.size());
+  for (const auto c : text) {
+    if (c >= 'A' && c <= 'Z') {
+      result.push_back(static_cast<char>(c - 'A' + 'a'));
+    } else if ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')) {
+      result.push_back(c);
+    }
+  }
+  return result;
+}
+
+std::vector<std::filesystem::path> directories()
+{
+  std::vector<std::filesystem::path> directories;
+#ifdef _WIN32
+  if (const auto windir = std::getenv("WINDIR")) {
+    directories.push_back(std::filesystem::path(windir) / "Fonts");
+  }
+#else
+  if (const auto data = std::getenv("XDG_DATA_HOME"); data && *data) {
+    directories.push_back(std::filesystem::path(data) / "fonts");
+  } else if (const auto home = std::getenv("HOME"); home && *home) {
+    directories.push_back(std::filesystem::path(home) / ".local/share/fonts");
+  }
+  if (const auto home = std::getenv("HOME"); home && *home) {
+    directories.push_back(std::filesystem::path(home) / ".fonts");
+  }
+  directories.emplace_back("/usr/local/share/fonts");
+  directories.emplace_back("/usr/share/fonts");
+#endif
+  return directories;
+}
+
+// Searches the font directories for a file named after the family and style.
+// Returns the first font file when the family is empty.
+std::filesystem::path search(std::string_view family, int weight, ice::ui::font::flags flags)
+{
+  const auto name = normalize(family);
+  std::string style;
+  if (weight >= 600) {
+    style += "bold";
+  }
+  const auto italic = flags & ice::ui::font::flags::italic;
+  std::vector<std::string> stems;
+  if (name.empty()) {
+    // Accept any file.
+  } else if (italic) {
+    stems.push_back(name + style + "italic");
+    stems.push_back(name + style + "oblique");
+  } else if (style.empty()) {
+    stems.push_back(name);
+    stems.push_back(name + "regular");
+    stems.push_back(name + "book");
+  } else {
+    stems.push_back(name + style);
+  }
+  std::error_code ec;
+  for (const auto& directory : directories()) {
+    auto it = std::filesystem::recursive_directory_iterator(directory, ec);
+    for (const auto end = std::filesystem::recursive_directory_iterator(); !ec && it != end; it.increment(ec)) {
+      const auto& path = it->path();
+      const auto extension = normalize(path.extension().string());
+      if (extension != "ttf" && extension != "otf" && extension != "ttc") {
+        continue;
+      }
+      const auto stem = normalize(path.stem().string());
+      if (stems.empty() || std::find(stems.begin(), stems.end(), stem) != stems.end()) {
+        return path;
+      }
+    }
+    ec.clear();
+  }
+  return {};
+}
+
+std::unique_ptr<unsigned char[]> load(const std::filesystem::path& path, std::size_t& size)
+{
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    return {};
+  }
+  size = static_cast<std::size_t>(file.tellg());
+  std::unique_ptr<unsigned char[]> data(new (std::nothrow) unsigned char[size]);
+  if (!data) {
+    return {};
+  }
+  file.seekg(0);
+  if (!file.read(reinterpret_cast<char*>(data.get()), static_cast<std::streamsize>(size))) {
+    return {};
+  }
+  return data;
+}
+
+float get_text_width(nk_handle handle, float height, const char* string, int length) noexcept
+{
+  if (!handle.ptr || !string || length < 1) {
+    return 0.0f;
+  }
+  const auto font = static_cast<const ice::ui::font*>(handle.ptr);
+  return font->width({ string, static_cast<std::size_t>(length) }, height);
+}
+
+}  // namespace
+
+struct truetype::info {
+  stbtt_fontinfo font{};
+};
+
+truetype::truetype() noexcept = default;
+
+truetype::~truetype()
+{
+  ice::ui::font::set(nullptr);
+}
+
+ice::error truetype::create(std::string_view name, int size, int weight, ice::ui::font::flags flags) noexcept
+{
+  if (data_) {
+    return ice::errc::context_not_empty;
+  }
+
+  std::error_code ec;
+  std::filesystem::path path;
+  if (const auto file = ice::make_path(name); !name.empty() && std::filesystem::is_regular_file(file, ec)) {
+    path = file;
+  } else {
+    if (!normalize(name).empty()) {
+      path = search(name, weight, flags);
+      if (path.empty()) {
+        path = search(name, 400, ice::ui::font::flags::normal);
+      }
+    }
+    for (const auto family : fallback_families) {
+      if (!path.empty()) {
+        break;
+      }
+      path = search(family, weight, flags);
+    }
+    for (const auto family : fallback_families) {
+      if (!path.empty()) {
+        break;
+      }
+      path = search(family, 400, ice::ui::font::flags::normal);
+    }
+    if (path.empty()) {
+      path = search({}, 400, ice::ui::font::flags::normal);
+    }
+  }
+  if (path.empty()) {
+    ICE_TRACE_FORMAT("Could not find font: {} ({}, {}, {})", name, size, weight, static_cast<int>(flags));
+    return ice::errc::not_available;
+  }
+
+  std::size_t data_size = 0;
+  auto data = load(path, data_size);
+  if (!data) {
+    ICE_TRACE_FORMAT("Could not read font: {}", path.string());
+    return ice::errc::not_available;
+  }
+
+  auto info = std::make_unique<truetype::info>();
+  const auto offset = stbtt_GetFontOffsetForIndex(data.get(), 0);
+  if (offset < 0 || !stbtt_InitFont(&info->font, data.get(), offset)) {
+    ICE_TRACE_FORMAT("Could not load font: {} ({} bytes)", path.string(), data_size);
+    return ice::errc::not_available;
+  }
+
+  // Sizes are in points at 96 DPI, which matches the default GDI behavior.
+  const auto pixels = static_cast<float>(size) * 96.0f / 72.0f;
+  scale_ = stbtt_ScaleForMappingEmToPixels(&info->font, pixels);
+
+  int ascent = 0;
+  int descent = 0;
+  int line_gap = 0;
+  stbtt_GetFontVMetrics(&info->font, &ascent, &descent, &line_gap);
+  ascent_ = std::ceil(static_cast<float>(ascent) * scale_);
+
+  const auto side = std::clamp(static_cast<int>(std::ceil(pixels)) * 32, 256, 2048);
+  if (auto e = atlas_.create(side, side)) {
+    ICE_TRACE_FORMAT("Could not create glyph atlas: {}", e);
+    return e;
+  }
+
+  data_ = std::move(data);
+  info_ = std::move(info);
+
+  for (char32_t code = 0; code < ascii_.size(); code++) {
+    ascii_[code] = measure(code);
+  }
+
+  font_ = std::make_unique<nk_user_font>();
+  font_->userdata = nk_handle_ptr(static_cast<ice::ui::font*>(this));
+  font_->height = ascent_ + std::ceil(static_cast<float>(-descent) * scale_);
+  font_->width = get_text_width;
+  ice::ui::font::set(font_.get());
+  return {};
+}
+
+float truetype::width(std::string_view text, float height) const noexcept
+{
+  auto width = 0.0f;
+  const auto data = text.data();
+  const auto size = static_cast<int>(text.size());
+  for (int i = 0; i < size;) {
+    const auto c = static_cast<unsigned char>(data[i]);
+    if (c < 0x80) {
+      width += ascii_[c];
+      i++;
+      continue;
+    }
+    nk_rune rune = 0;
+    const auto length = nk_utf_decode(data + i, &rune, size - i);
+    if (!length) {
+      break;
+    }
+    i += length;
+    width += cache(static_cast<char32_t>(rune));
+  }
+  return width;
+}
+
+float truetype::advance(char32_t code) const noexcept
+{
+  if (code < ascii_.size()) {
+    return ascii_[code];
+  }
+  std::shared_lock lock{ advances_mutex_ };
+  if (const auto it = advances_.find(code); it != advances_.end()) {
+    return it->second;
+  }
+  return measure(code);
+}
+
+float truetype::ascent() const noexcept
+{
+  return ascent_;
+}
+
+void truetype::prepare(std::string_view text) noexcept
+{
+  if (!info_) {
+    return;
+  }
+  const auto data = text.data();
+  const auto size = static_cast<int>(text.size());
+  for (int i = 0; i < size;) {
+    nk_rune rune = 0;
+    const auto length = nk_utf_decode(data + i, &rune, size - i);
+    if (!length) {
+      break;
+    }
+    i += length;
+    const auto code = static_cast<char32_t>(rune);
+    if (code >= ascii_.size()) {
+      cache(code);
+    }
+    if (const auto entry = atlas_.find(code)) {
+      atlas_.touch(*entry);
+      continue;
+    }
+    int x0 = 0;
+    int y0 = 0;
+    int x1 = 0;
+    int y1 = 0;
+    stbtt_GetCodepointBitmapBox(&info_->font, static_cast<int>(code), scale_, scale_, &x0, &y0, &x1, &y1);
+    const auto entry = atlas_.insert(code, x1 - x0, y1 - y0, x0, y0);
+    if (entry && entry->cx > 0 && entry->cy > 0) {
+      const auto dst = atlas_.data() + static_cast<std::size_t>(entry->y) * atlas_.cx() + entry->x;
+      stbtt_MakeCodepointBitmap(&info_->font, dst, entry->cx, entry->cy, atlas_.cx(), scale_, scale_,
+        static_cast<int>(code));
+    }
+  }
+}
+
+bool truetype::find(char32_t code, glyph& glyph) const noexcept
+{
+  const auto entry = atlas_.find(code);
+  if (!entry) {
+    return false;
+  }
+  glyph.data = atlas_.data() + static_cast<std::size_t>(entry->y) * atlas_.cx() + entry->x;
+  glyph.stride = atlas_.cx();
+  glyph.x = entry->dx;
+  glyph.y = entry->dy;
+  glyph.cx = entry->cx;
+  glyph.cy = entry->cy;
+  return true;
+}
+
+bool truetype::render(char32_t code, std::vector<std::uint8_t>& buffer, glyph& glyph) const noexcept
+{
+  if (!info_) {
+    return false;
+  }
+  int x0 = 0;
+  int y0 = 0;
+  int x1 = 0;
+  int y1 = 0;
+  stbtt_GetCodepointBitmapBox(&info_->font, static_cast<int>(code), scale_, scale_, &x0, &y0, &x1, &y1);
+  const auto cx = std::max(x1 - x0, 0);
+  const auto cy = std::max(y1 - y0, 0);
+  buffer.resize(static_cast<std::size_t>(cx) * static_cast<std::size_t>(cy));
+  if (!buffer.empty()) {
+    stbtt_MakeCodepointBitmap(&info_->font, buffer.data(), cx, cy, cx, scale_, scale_, static_cast<int>(code));
+  }
+  glyph.data = buffer.data();
+  glyph.stride = cx;
+  glyph.x = x0;
+  glyph.y = y0;
+  glyph.cx = cx;
+  glyph.cy = cy;
+  return true;
+}
+
+float truetype::cache(char32_t code) const noexcept
+{
+  {
+    std::shared_lock lock{ advances_mutex_ };
+    if (const auto it = advances_.find(code); it != advances_.end()) {
+      return it->second;
+    }
+  }
+  const auto advance = measure(code);
+  std::unique_lock lock{ advances_mutex_ };
+  advances_.emplace(code, advance);
+  return advance;
+}
+
+float truetype::measure(char32_t code) const noexcept
+{
+  int advance = 0;
+  int bearing = 0;
+  stbtt_GetCodepointHMetrics(&info_->font, static_cast<int>(code), &advance, &bearing);
+  return static_cast<float>(advance) * scale_;
+}
+
+}  // namespace ice::ui
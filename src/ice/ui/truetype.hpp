@@ -0,0 +1,68 @@
+#pragma once
+#include <ice/ui/atlas.hpp>
+#include <ice/ui/font.hpp>
+#include <array>
+#include <memory>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+
+extern "C" struct nk_user_font;
+
+namespace ice::ui {
+
+// ================================================================================================
+// truetype
+// ================================================================================================
+
+// TrueType font rasterized with the bundled stb_truetype library.
+// ASCII advances are stored in a table and other advances are cached on first use, which turns text measurement
+// into a sum of table lookups. Glyph bitmaps are cached in an atlas and rasterized only once while in use.
+// Text can be measured on one thread while another thread prepares and renders glyphs.
+
+class ICE_API truetype final : public ice::ui::font {
+public:
+  truetype() noexcept;
+  truetype(truetype&& other) = delete;
+  truetype(const truetype& other) = delete;
+  truetype& operator=(truetype&& other) = delete;
+  truetype& operator=(const truetype& other) = delete;
+  ~truetype() override;
+
+  // Loads a font file or searches the system font directories for a font family.
+  // Falls back to common sans-serif families and then to any installed font when the name can not be found.
+  ice::error create(std::string_view name, int size, int weight = 400,
+    ice::ui::font::flags flags = ice::ui::font::flags::normal) noexcept;
+
+  float width(std::string_view text, float height) const noexcept override;
+  float advance(char32_t code) const noexcept override;
+  float ascent() const noexcept override;
+
+  void prepare(std::string_view text) noexcept override;
+  bool find(char32_t code, glyph& glyph) const noexcept override;
+  bool render(char32_t code, std::vector<std::uint8_t>& buffer, glyph& glyph) const noexcept override;
+
+  const ice::ui::atlas& atlas() const noexcept
+  {
+    return atlas_;
+  }
+
+private:
+  struct info;
+
+  // Returns the advance of a code point and stores it in the advances cache.
+  float cache(char32_t code) const noexcept;
+  float measure(char32_t code) const noexcept;
+
+  std::unique_ptr<unsigned char[]> data_;
+  std::unique_ptr<info> info_;
+  std::unique_ptr<nk_user_font> font_;
+  float scale_{ 0.0f };
+  float ascent_{ 0.0f };
+  std::array<float, 128> ascii_{};
+  mutable std::unordered_map<char32_t, float> advances_;
+  mutable std::shared_mutex advances_mutex_;
+  ice::ui::atlas atlas_;
+};
+
+}  // namespace ice::ui
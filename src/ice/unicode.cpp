@@ -50,6 +50,15 @@ char32_t to_title(char32_t uc) noexcept
   return static_cast<char32_t>(utf8proc_totitle(static_cast<utf8proc_int32_t>(uc)));
 }
 
+char32_t combine(char32_t base, char32_t mark) noexcept
+{
+  utf8proc_int32_t buffer[2]{ static_cast<utf8proc_int32_t>(base), static_cast<utf8proc_int32_t>(mark) };
+  if (utf8proc_normalize_utf32(buffer, 2, utf8proc_option_t(UTF8PROC_COMPOSE | UTF8PROC_STABLE)) != 1) {
+    return 0;
+  }
+  return static_cast<char32_t>(buffer[0]);
+}
+
 ice::result<std::string> normalize(std::string_view src, options dec, options enc) noexcept
 {
   if (src.empty()) {
@@ -682,6 +682,9 @@ inline std::string replace_invalid(std::string_view s) noexcept
 //
 ICE_API ice::result<std::string> normalize(std::string_view src, options dec, options enc = options::nlf2lf) noexcept;
 
+// Returns the canonical composition of a base character and a combining mark or 0 if there is none.
+ICE_API char32_t combine(char32_t base, char32_t mark) noexcept;
+
 // ================================================================================================
 // transformation
 // ================================================================================================
@@ -66,6 +66,11 @@ ice::error window::set(ice::window::style style) noexcept
   return window_ ? window_->set(style) : ice::errc::not_initialized;
 }
 
+ice::error window::set(ice::window::render render) noexcept
+{
+  return window_ ? window_->set(render) : ice::errc::not_initialized;
+}
+
 ice::error window::text(std::string_view text) noexcept
 {
   return window_ ? window_->text(text) : ice::errc::not_initialized;
@@ -81,6 +86,16 @@ ice::error window::start(std::string_view name, int size, int weight, ice::ui::f
   return window_ ? window_->start(name, size, weight, flags) : ice::errc::not_initialized;
 }
 
+ice::error window::record(const std::filesystem::path& path) noexcept
+{
+  return window_ ? window_->record(path) : ice::errc::not_initialized;
+}
+
+ice::error window::replay(const std::filesystem::path& path, bool realtime) noexcept
+{
+  return window_ ? window_->replay(path, realtime) : ice::errc::not_initialized;
+}
+
 ice::error window::show() noexcept
 {
   return window_ ? window_->show() : ice::errc::not_initialized;
@@ -124,6 +139,9 @@ void window::on_render(ice::ui::context& context) noexcept
 void window::on_render(ice::vk::context& context) noexcept
 {}
 
+void window::on_replay(std::size_t frames, std::chrono::steady_clock::duration duration) noexcept
+{}
+
 void window::on_destroy() noexcept
 {}
 
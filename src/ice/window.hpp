@@ -1,5 +1,7 @@
 #pragma once
 #include <ice/ui/font.hpp>
+#include <chrono>
+#include <filesystem>
 #include <memory>
 
 namespace ice {
@@ -54,12 +56,29 @@ public:
 
   ice::error set(ice::window::style style) noexcept;
 
+  enum class render {
+    // Builds, rasterizes and presents frames in the event loop.
+    direct = 0,
+
+    // Builds frames in the event loop and rasterizes and presents them on a render thread.
+    thread = 1,
+  };
+
+  ice::error set(ice::window::render render) noexcept;
+
   ice::error text(std::string_view text) noexcept;
   ice::error icon(std::string_view icon) noexcept;
 
   ice::error start(std::string_view name = {}, int size = 9, int weight = 400,
     ice::ui::font::flags flags = ice::ui::font::flags::normal) noexcept;
 
+  // Records the input of the window into a file. Must be called after start.
+  ice::error record(const std::filesystem::path& path) noexcept;
+
+  // Replays recorded input instead of user input and calls on_replay when the recording ended. Must be called after
+  // start. Frames are delayed to match the recording in real time mode and rendered as fast as possible otherwise.
+  ice::error replay(const std::filesystem::path& path, bool realtime = true) noexcept;
+
   ice::error show() noexcept;
   ice::error hide() noexcept;
 
@@ -67,6 +86,7 @@ public:
   ice::error maximize() noexcept;
   ice::error restore() noexcept;
 
+  // Runs the event loop of the thread until all windows were destroyed.
   ice::error run() noexcept;
 
   virtual void on_create() noexcept;
@@ -74,6 +94,8 @@ public:
   virtual void on_render(ice::ui::context& context) noexcept;
   virtual void on_render(ice::vk::context& context) noexcept;
 
+  virtual void on_replay(std::size_t frames, std::chrono::steady_clock::duration duration) noexcept;
+
   virtual void on_destroy() noexcept;
   virtual void on_close() noexcept;
 
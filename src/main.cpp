@@ -1,6 +1,9 @@
 #include <ice/application.hpp>
+#include <ice/format.hpp>
 #include <ice/ui/context.hpp>
 #include <ice/window.hpp>
+#include <chrono>
+#include <string_view>
 
 class window : public ice::window {
 public:
@@ -12,6 +15,35 @@ public:
       destroy();
       return;
     }
+    // Usage: main [--record <file>] [--replay <file>] [--fast] [--render-thread]
+    const auto args = ice::application::args();
+    auto realtime = true;
+    auto thread = false;
+    for (const auto arg : args) {
+      if (arg == "--fast") {
+        realtime = false;
+      } else if (arg == "--render-thread") {
+        thread = true;
+      }
+    }
+    // Rasterize and present frames on a render thread.
+    if (thread) {
+      if (const auto e = set(ice::window::render::thread)) {
+        ice::application::message("Could not start render thread.\n{}: {} ({})", e.type(), e, e.code());
+      }
+    }
+    // Record or replay input for reproducible measurements.
+    for (std::size_t i = 0; i + 1 < args.size(); i++) {
+      if (args[i] == "--record") {
+        if (const auto e = record(args[i + 1])) {
+          ice::application::message("Could not record input.\n{}: {} ({})", e.type(), e, e.code());
+        }
+      } else if (args[i] == "--replay") {
+        if (const auto e = replay(args[i + 1], realtime)) {
+          ice::application::message("Could not replay input.\n{}: {} ({})", e.type(), e, e.code());
+        }
+      }
+    }
     // TODO: Set window title and icon.
     // TODO: Move or resize window.
     // Show window.
@@ -47,6 +79,15 @@ public:
   void on_render(ice::vk::context& context) noexcept override
   {}
 
+  void on_replay(std::size_t frames, std::chrono::steady_clock::duration duration) noexcept override
+  {
+    // Report the replay and close the window.
+    const auto ms = std::chrono::duration<double, std::milli>(duration).count();
+    ICE_TRACE_INFO(ice::trace_common, "Replayed {} frames in {:.3f} ms ({:.3f} ms per frame)", frames, ms,
+      frames ? ms / static_cast<double>(frames) : 0.0);
+    destroy();
+  }
+
   void on_destroy() noexcept override
   {
     // Can't stop from closing, but can do cleanup.
@@ -0,0 +1,56 @@
+#include <ice/os/nuklear.hpp>
+#include <ice/ui/arena.hpp>
+#include <doctest/doctest.h>
+
+namespace {
+
+float get_text_width(nk_handle, float height, const char*, int length) noexcept
+{
+  return static_cast<float>(length) * height * 0.5f;
+}
+
+void frame(nk_context* context, int rows) noexcept
+{
+  if (nk_begin(context, "arena", nk_rect(0, 0, 640, 4000), NK_WINDOW_BORDER)) {
+    for (int i = 0; i < rows; i++) {
+      nk_layout_row_dynamic(context, 20, 2);
+      nk_label(context, "label", NK_TEXT_LEFT);
+      nk_button_label(context, "button");
+    }
+  }
+  nk_end(context);
+}
+
+}  // namespace
+
+TEST_CASE("arena")
+{
+  nk_user_font font{};
+  font.height = 13.0f;
+  font.width = get_text_width;
+
+  ice::ui::arena arena;
+  nk_context context{};
+  REQUIRE(!arena.create(&context, &font, 4 * 1024));
+  CHECK(arena.create(&context, &font));
+
+  // Frames that do not fit into the frame region grow it.
+  frame(&context, 100);
+  arena.clear(&context);
+  const auto stats = arena.stats();
+  CHECK(stats.current > 4 * 1024);
+  CHECK(stats.peak >= stats.current);
+  CHECK(stats.reserved >= stats.current);
+
+  // Frames of the same or a smaller size do not allocate.
+  for (int i = 0; i < 16; i++) {
+    frame(&context, 100 - i);
+    arena.clear(&context);
+  }
+  CHECK(arena.stats().allocations == stats.allocations);
+  CHECK(arena.stats().reserved == stats.reserved);
+  CHECK(arena.stats().current < stats.current);
+  CHECK(arena.stats().peak == stats.peak);
+
+  nk_free(&context);
+}
@@ -0,0 +1,51 @@
+#include <ice/async_result.hpp>
+#include <doctest/doctest.h>
+#include <thread>
+
+namespace {
+
+ice::task async_result_await(ice::async_result<int>& result, ice::result<int>& value, std::thread::id& id) noexcept
+{
+  value = co_await result;
+  id = std::this_thread::get_id();
+}
+
+}  // namespace
+
+TEST_CASE("ice::async_result resumes the awaiter on its context")
+{
+  ice::context context;
+  ice::async_result<int> result{ context };
+  auto promise = result.promise();
+  ice::result<int> value{ ice::errc::not_initialized };
+  std::thread::id id;
+  async_result_await(result, value, id);
+  std::thread thread{ [promise = std::move(promise)]() mutable {
+    promise.set(42);
+  } };
+  REQUIRE(!context.run());
+  thread.join();
+  CHECK(id == std::this_thread::get_id());
+  REQUIRE(value);
+  CHECK(*value == 42);
+}
+
+TEST_CASE("ice::async_result continues when the result was already set")
+{
+  ice::context context;
+  ice::async_result<int> result{ context };
+  auto promise = result.promise();
+  promise.set(std::errc::interrupted);
+  CHECK(!promise);
+  ice::result<int> value{ 0 };
+  std::thread::id id;
+  async_result_await(result, value, id);
+  CHECK(id == std::this_thread::get_id());
+  CHECK(value.error() == std::errc::interrupted);
+  CHECK(!context.run());
+
+  ice::async_result<int> broken{ context };
+  broken.promise();
+  async_result_await(broken, value, id);
+  CHECK(value.error() == ice::errc::broken_promise);
+}
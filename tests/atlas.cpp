@@ -0,0 +1,57 @@
+#include <ice/ui/atlas.hpp>
+#include <doctest/doctest.h>
+
+TEST_CASE("atlas insert")
+{
+  ice::ui::atlas atlas;
+  REQUIRE(!atlas.create(64, 64));
+
+  const auto a = atlas.insert('a', 10, 12, 1, -12);
+  REQUIRE(a);
+  CHECK(a->cx == 10);
+  CHECK(a->cy == 12);
+  CHECK(a->dx == 1);
+  CHECK(a->dy == -12);
+  CHECK(atlas.find('a') == a);
+  CHECK(atlas.insert('a', 10, 12, 1, -12) == a);
+
+  // Glyphs of similar height share a shelf without overlapping.
+  const auto b = atlas.insert('b', 10, 11, 0, -11);
+  REQUIRE(b);
+  CHECK(b->y == a->y);
+  CHECK(b->x >= a->x + a->cx);
+
+  // Empty glyphs do not use texture space.
+  const auto space = atlas.insert(' ', 0, 0, 0, 0);
+  REQUIRE(space);
+  CHECK(space->shelf == -1);
+  CHECK(atlas.size() == 3);
+  CHECK(!atlas.find('c'));
+}
+
+TEST_CASE("atlas eviction")
+{
+  ice::ui::atlas atlas;
+  REQUIRE(!atlas.create(64, 64));
+
+  // Fill the texture with four shelves of four glyphs each.
+  for (std::uint32_t key = 0; key < 16; key++) {
+    REQUIRE(atlas.insert(key, 14, 14, 0, 0));
+  }
+  CHECK(atlas.evictions() == 0);
+  CHECK(atlas.size() == 16);
+
+  // Use the first shelf, which makes the second shelf the least recently used one.
+  atlas.touch(*atlas.find(0));
+  REQUIRE(atlas.insert(16, 14, 14, 0, 0));
+  CHECK(atlas.evictions() == 1);
+  CHECK(atlas.find(0));
+  CHECK(!atlas.find(4));
+  CHECK(!atlas.find(7));
+  CHECK(atlas.find(8));
+  CHECK(atlas.find(16));
+
+  // Glyphs larger than the texture are not cached.
+  CHECK(!atlas.insert('x', 64, 8, 0, 0));
+  CHECK(!atlas.find('x'));
+}
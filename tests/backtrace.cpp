@@ -0,0 +1,65 @@
+#include <ice/backtrace.hpp>
+#include <ice/context.hpp>
+#include <doctest/doctest.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+#if defined(_MSC_VER) && !defined(__clang__)
+__declspec(noinline)
+#else
+__attribute__((noinline))
+#endif
+std::string backtrace_function(std::size_t& size) noexcept
+{
+  const auto backtrace = ice::backtrace::capture();
+  size = backtrace.stack().size();
+  return size ? ice::backtrace::symbol(backtrace.stack()[0]) : std::string{};
+}
+
+}  // namespace
+
+TEST_CASE("ice::backtrace captures the calling thread")
+{
+  std::size_t size = 0;
+  const auto name = backtrace_function(size);
+  CHECK(size > 1);
+#ifdef __linux__
+  CHECK(name.find("backtrace_function") != std::string::npos);
+#endif
+  CHECK(ice::backtrace::capture().async().empty());
+}
+
+TEST_CASE("ice::backtrace follows coroutines that were resumed by a context")
+{
+  ice::context context;
+  std::vector<std::string> names;
+  std::size_t outer = 0;
+  std::size_t inner = 0;
+  context.post([&]() {
+    outer = ice::backtrace::capture().async().size();
+    context.post([&]() {
+      const auto backtrace = ice::backtrace::capture();
+      inner = backtrace.async().size();
+      for (const auto address : backtrace.async()) {
+        names.push_back(ice::backtrace::symbol(address));
+      }
+    });
+  });
+  REQUIRE(!context.run());
+  CHECK(!ice::async_stack::current());
+#if ICE_ASYNC_STACK
+  CHECK(outer == 1);
+  CHECK(inner == 2);
+#else
+  CHECK(outer == 0);
+  CHECK(inner == 0);
+#endif
+#if ICE_ASYNC_STACK && defined(__linux__)
+  REQUIRE(names.size() == 2);
+  CHECK(names[0].find("ice::context::post") != std::string::npos);
+  CHECK(names[1].find("ice::context::post") != std::string::npos);
+  CHECK(names[0] != names[1]);
+#endif
+}
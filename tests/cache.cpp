@@ -0,0 +1,81 @@
+#include <ice/os/nuklear.hpp>
+#include <ice/ui/arena.hpp>
+#include <ice/ui/cache.hpp>
+#include <doctest/doctest.h>
+#include <string>
+#include <vector>
+
+namespace {
+
+float get_text_width(nk_handle, float height, const char*, int length) noexcept
+{
+  return static_cast<float>(length) * height * 0.5f;
+}
+
+// Renders rows in retained subtrees and returns the text commands of the frame.
+std::vector<std::string> frame(nk_context* context, ice::ui::cache& cache, std::uint64_t hash) noexcept
+{
+  nk_input_begin(context);
+  nk_input_motion(context, -100, -100);
+  nk_input_end(context);
+  if (nk_begin(context, "cache", nk_rect(0, 0, 640, 480), NK_WINDOW_BORDER)) {
+    for (std::uint64_t id = 0; id < 4; id++) {
+      if (cache.begin(context, id, hash, 60)) {
+        for (int i = 0; i < 2; i++) {
+          nk_layout_row_dynamic(context, 20, 2);
+          nk_label(context, "label", NK_TEXT_LEFT);
+          nk_button_label(context, "button");
+        }
+        cache.end(context);
+      }
+    }
+  }
+  nk_end(context);
+
+  std::vector<std::string> texts;
+  const nk_command* command = nullptr;
+  nk_foreach(command, context)
+  {
+    if (command->type == NK_COMMAND_TEXT) {
+      const auto& text = *reinterpret_cast<const nk_command_text*>(command);
+      texts.push_back(std::string(text.string) + " " + std::to_string(text.x) + " " + std::to_string(text.y));
+    }
+  }
+  return texts;
+}
+
+}  // namespace
+
+TEST_CASE("cache")
+{
+  nk_user_font font{};
+  font.height = 13.0f;
+  font.width = get_text_width;
+
+  ice::ui::arena arena;
+  nk_context context{};
+  REQUIRE(!arena.create(&context, &font));
+
+  // The first frame builds and records every subtree.
+  ice::ui::cache cache;
+  const auto built = frame(&context, cache, 1);
+  arena.clear(&context);
+  CHECK(built.size() == 16);
+  CHECK(cache.size() == 4);
+  CHECK(cache.hits() == 0);
+  CHECK(cache.misses() == 4);
+
+  // Later frames with the same hash replay the same commands.
+  CHECK(frame(&context, cache, 1) == built);
+  arena.clear(&context);
+  CHECK(cache.hits() == 4);
+  CHECK(cache.misses() == 4);
+
+  // A different hash builds the subtrees again.
+  CHECK(frame(&context, cache, 2) == built);
+  arena.clear(&context);
+  CHECK(cache.hits() == 4);
+  CHECK(cache.misses() == 8);
+
+  nk_free(&context);
+}
@@ -0,0 +1,53 @@
+#include <ice/context.hpp>
+#include <doctest/doctest.h>
+#include <atomic>
+#include <optional>
+#include <thread>
+#include <vector>
+
+TEST_CASE("ice::context resumes tasks in the order in which they were posted")
+{
+  ice::context context;
+  std::vector<int> order;
+  for (int i = 0; i < 1000; i++) {
+    context.post([&order, i]() {
+      order.push_back(i);
+    });
+  }
+  REQUIRE(!context.run());
+  REQUIRE(order.size() == 1000);
+  for (int i = 0; i < 1000; i++) {
+    CHECK(order[static_cast<std::size_t>(i)] == i);
+  }
+}
+
+TEST_CASE("ice::context runs all tasks that are posted from multiple threads")
+{
+  ice::context context;
+  std::optional<ice::context::work> work{ context };
+  std::atomic_size_t count{ 0 };
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 100000; j++) {
+        context.post([&]() {
+          count.fetch_add(1, std::memory_order_relaxed);
+        });
+        if (j % 100 == 0) {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+  std::thread release{ [&]() {
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    context.post([&]() {
+      work.reset();
+    });
+  } };
+  REQUIRE(!context.run());
+  release.join();
+  CHECK(count.load() == 400000);
+}
@@ -0,0 +1,136 @@
+#include <ice/os/nuklear.hpp>
+#include <ice/ui/arena.hpp>
+#include <ice/ui/damage.hpp>
+#include <doctest/doctest.h>
+
+namespace {
+
+float get_text_width(nk_handle, float height, const char*, int length) noexcept
+{
+  return static_cast<float>(length) * height * 0.5f;
+}
+
+// Fills two rectangles and draws a text in different tiles. The first rectangle uses the given color and scissor width.
+void frame(nk_context* context, nk_color color, float scissor) noexcept
+{
+  nk_input_begin(context);
+  nk_input_motion(context, -100, -100);
+  nk_input_end(context);
+  if (nk_begin(context, "damage", nk_rect(0, 0, 640, 480), NK_WINDOW_NO_SCROLLBAR)) {
+    const auto canvas = nk_window_get_canvas(context);
+    const auto clip = canvas->clip;
+    nk_push_scissor(canvas, nk_rect(0, 0, scissor, 480));
+    nk_fill_rect(canvas, nk_rect(130, 130, 10, 10), 0, color);
+    nk_push_scissor(canvas, clip);
+    nk_fill_rect(canvas, nk_rect(400, 300, 10, 10), 0, nk_rgb(0, 0, 255));
+    nk_draw_text(canvas, nk_rect(10, 400, 100, 20), "text", 4, context->style.font, nk_rgb(0, 0, 0),
+      nk_rgb(255, 255, 255));
+  }
+  nk_end(context);
+}
+
+bool equal(const ice::ui::raster::rect& a, const ice::ui::raster::rect& b) noexcept
+{
+  return a.x0 == b.x0 && a.y0 == b.y0 && a.x1 == b.x1 && a.y1 == b.y1;
+}
+
+}  // namespace
+
+TEST_CASE("damage")
+{
+  nk_user_font font{};
+  font.height = 13.0f;
+  font.width = get_text_width;
+
+  ice::ui::arena arena;
+  nk_context context{};
+  REQUIRE(!arena.create(&context, &font));
+  ice::ui::damage damage;
+  REQUIRE(!damage.resize(640, 480));
+
+  // The first frame damages the whole screen.
+  frame(&context, nk_rgb(255, 0, 0), 640);
+  CHECK(damage.update(&context));
+  CHECK(equal(damage.bounds(), { 0, 0, 640, 480 }));
+  arena.clear(&context);
+
+  // An identical command list does not damage any tile.
+  frame(&context, nk_rgb(255, 0, 0), 640);
+  CHECK(!damage.update(&context));
+  CHECK(damage.size() == 0);
+  CHECK(equal(damage.bounds(), {}));
+  arena.clear(&context);
+
+  // A different color damages the tile of the changed rectangle.
+  frame(&context, nk_rgb(0, 255, 0), 640);
+  CHECK(damage.update(&context));
+  REQUIRE(damage.size() == 1);
+  CHECK(equal(*damage.begin(), { 128, 128, 192, 192 }));
+  CHECK(equal(damage.bounds(), { 128, 128, 192, 192 }));
+  arena.clear(&context);
+
+  // A different scissor that still contains the rectangle damages the same tile.
+  frame(&context, nk_rgb(0, 255, 0), 320);
+  CHECK(damage.update(&context));
+  REQUIRE(damage.size() == 1);
+  CHECK(equal(*damage.begin(), { 128, 128, 192, 192 }));
+  arena.clear(&context);
+
+  // A scissor that hides the rectangle damages the same tile.
+  frame(&context, nk_rgb(0, 255, 0), 64);
+  CHECK(damage.update(&context));
+  REQUIRE(damage.size() == 1);
+  CHECK(equal(*damage.begin(), { 128, 128, 192, 192 }));
+  arena.clear(&context);
+
+  // The same scissor does not damage any tile.
+  frame(&context, nk_rgb(0, 255, 0), 64);
+  CHECK(!damage.update(&context));
+  arena.clear(&context);
+
+  // Invalidating damages the whole screen even if the command list did not change.
+  damage.invalidate();
+  frame(&context, nk_rgb(0, 255, 0), 64);
+  CHECK(damage.update(&context));
+  CHECK(equal(damage.bounds(), { 0, 0, 640, 480 }));
+  arena.clear(&context);
+
+  nk_free(&context);
+}
+
+TEST_CASE("damage bounds")
+{
+  nk_user_font font{};
+  font.height = 13.0f;
+  font.width = get_text_width;
+
+  ice::ui::arena arena;
+  nk_context context{};
+  REQUIRE(!arena.create(&context, &font));
+  ice::ui::damage damage;
+  REQUIRE(!damage.resize(640, 480));
+  for (int i = 0; i < 2; i++) {
+    frame(&context, nk_rgb(255, 0, 0), 640);
+    damage.update(&context);
+    arena.clear(&context);
+  }
+
+  // Changing the text damages its tiles in addition to the tile of the first rectangle.
+  if (nk_begin(&context, "damage", nk_rect(0, 0, 640, 480), NK_WINDOW_NO_SCROLLBAR)) {
+    const auto canvas = nk_window_get_canvas(&context);
+    const auto clip = canvas->clip;
+    nk_push_scissor(canvas, nk_rect(0, 0, 640, 480));
+    nk_fill_rect(canvas, nk_rect(130, 130, 10, 10), 0, nk_rgb(0, 255, 0));
+    nk_push_scissor(canvas, clip);
+    nk_fill_rect(canvas, nk_rect(400, 300, 10, 10), 0, nk_rgb(0, 0, 255));
+    nk_draw_text(canvas, nk_rect(10, 400, 100, 20), "next", 4, context.style.font, nk_rgb(0, 0, 0),
+      nk_rgb(255, 255, 255));
+  }
+  nk_end(&context);
+  CHECK(damage.update(&context));
+  CHECK(damage.size() == 2);
+  CHECK(equal(damage.bounds(), { 0, 128, 192, 448 }));
+  arena.clear(&context);
+
+  nk_free(&context);
+}
@@ -0,0 +1,74 @@
+#ifndef _WIN32
+#  include <ice/os/xcb/display.hpp>
+#  include <doctest/doctest.h>
+#  include <memory>
+#  include <vector>
+
+namespace {
+
+class client final : public ice::os::xcb::display::client {
+public:
+  void handle(xcb_generic_event_t* event) noexcept override
+  {
+    events++;
+  }
+
+  bool idle() noexcept override
+  {
+    return false;
+  }
+
+  std::size_t events{ 0 };
+};
+
+// Returns window ids that share a resource id base like the ids of a connection.
+xcb_window_t id(std::size_t index) noexcept
+{
+  return static_cast<xcb_window_t>(0x04200000 + index + 1);
+}
+
+}  // namespace
+
+TEST_CASE("ice::os::xcb::display dispatches by window id")
+{
+  ice::os::xcb::display display;
+  std::vector<std::shared_ptr<client>> clients;
+  for (std::size_t i = 0; i < 100; i++) {
+    clients.push_back(std::make_shared<client>());
+    display.insert(id(i), clients.back());
+  }
+  CHECK(display.size() == 100);
+  for (std::size_t i = 0; i < 100; i++) {
+    CHECK(display.get(id(i)) == clients[i]);
+  }
+  CHECK(!display.get(id(100)));
+  CHECK(!display.get(0));
+}
+
+TEST_CASE("ice::os::xcb::display removes windows")
+{
+  ice::os::xcb::display display;
+  std::vector<std::shared_ptr<client>> clients;
+  for (std::size_t i = 0; i < 100; i++) {
+    clients.push_back(std::make_shared<client>());
+    display.insert(id(i), clients.back());
+  }
+  for (std::size_t i = 0; i < 100; i += 3) {
+    display.remove(id(i));
+    CHECK(clients[i].use_count() == 1);
+  }
+  display.remove(id(100));
+  CHECK(display.size() == 66);
+  for (std::size_t i = 0; i < 100; i++) {
+    if (i % 3) {
+      CHECK(display.get(id(i)) == clients[i]);
+    } else {
+      CHECK(!display.get(id(i)));
+    }
+  }
+  for (std::size_t i = 0; i < 100; i++) {
+    display.remove(id(i));
+  }
+  CHECK(display.size() == 0);
+}
+#endif
@@ -283,25 +283,19 @@ namespace error_tests {
 
 enum class errc;
 
-ice::error_info make_error_info(errc)
+constexpr auto make_error_category(errc) noexcept
 {
-  constexpr auto text = [](int code) -> std::string {
-    switch (code) {
-    case 0:
-      return "operation succeeded";
-    case 16:
-      return "operation failed";
-    }
-    return "unknown";
-  };
-  return { "error tests", text };
+  return ice::error_category{ "error tests", {
+    { errc{ 0 }, "operation succeeded" },
+    { errc{ 16 }, "operation failed" },
+  } };
 }
 
 }  // namespace error_tests
 
 TEST_CASE("error with std::errc")
 {
-  ice::application application;
+  ice::application::load();
 
   constexpr ice::error success{};
   constexpr ice::error failure{ std::errc::no_such_file_or_directory };
@@ -314,13 +308,13 @@ TEST_CASE("error with std::errc")
 
   CHECK(failure.code() == static_cast<int>(std::errc::no_such_file_or_directory));
   CHECK(failure.type() == type);
-  CHECK(fmt::format("{}", failure) == "no such file or directory");
-  CHECK(fmt::format("{}", failure.type()) == "system");
+  CHECK(fmt::format("{}", failure) == std::make_error_code(std::errc::no_such_file_or_directory).message());
+  CHECK(fmt::format("{}", failure.type()) == "generic");
 }
 
 TEST_CASE("error with error_tests::errc")
 {
-  ice::application application;
+  ice::application::load();
 
   constexpr ice::error success{};
   constexpr ice::error failure{ error_tests::errc{ 16 } };
@@ -346,7 +340,7 @@ TEST_CASE("error with error_tests::errc")
   CHECK(fmt::format("{}", failure) == code_number);
   CHECK(fmt::format("{}", failure.type()) == type_number);
 
-  ice::load_error_info<error_tests::errc>();
+  ice::application::load<error_tests::errc>();
 
   CHECK(success.code() == 0);
   CHECK(success.type() == ice::error_type::success);
@@ -358,7 +352,7 @@ TEST_CASE("error with error_tests::errc")
   CHECK(fmt::format("{}", failure) == "operation failed");
   CHECK(fmt::format("{}", failure.type()) == "error tests");
 
-  ice::unload_error_info<error_tests::errc>();
+  ice::application::unload<error_tests::errc>();
 
   CHECK(success.code() == 0);
   CHECK(success.type() == ice::error_type::success);
@@ -249,14 +249,14 @@ enum class errc;
 
 ice::error_info make_error_info(errc)
 {
-  constexpr auto text = [](int code) -> std::string {
+  constexpr auto text = [](int code) -> std::string_view {
     switch (code) {
     case 0:
       return "operation succeeded";
     case 16:
       return "operation failed";
     }
-    return "unknown";
+    return {};
   };
   return { "error code tests", text };
 }
@@ -265,7 +265,7 @@ ice::error_info make_error_info(errc)
 
 TEST_CASE("error code with std::errc")
 {
-  ice::application application;
+  ice::application::load();
 
   constexpr ice::error_code<std::errc> success{};
   constexpr ice::error_code<std::errc> failure{ std::errc::no_such_file_or_directory };
@@ -273,18 +273,18 @@ TEST_CASE("error code with std::errc")
 
   CHECK(success.code() == 0);
   CHECK(success.type() == type);
-  CHECK(fmt::format("{}", success) == "success");
-  CHECK(fmt::format("{}", success.type()) == "system");
+  CHECK(fmt::format("{}", success) == std::make_error_code(std::errc{}).message());
+  CHECK(fmt::format("{}", success.type()) == "generic");
 
   CHECK(failure.code() == static_cast<int>(std::errc::no_such_file_or_directory));
   CHECK(failure.type() == type);
-  CHECK(fmt::format("{}", failure) == "no such file or directory");
-  CHECK(fmt::format("{}", failure.type()) == "system");
+  CHECK(fmt::format("{}", failure) == std::make_error_code(std::errc::no_such_file_or_directory).message());
+  CHECK(fmt::format("{}", failure.type()) == "generic");
 }
 
 TEST_CASE("error code with error_code_tests::errc")
 {
-  ice::application application;
+  ice::application::load();
 
   constexpr ice::error_code<error_code_tests::errc> success{};
   constexpr ice::error_code<error_code_tests::errc> failure{ error_code_tests::errc{ 16 } };
@@ -310,7 +310,7 @@ TEST_CASE("error code with error_code_tests::errc")
   CHECK(fmt::format("{}", failure) == code_number);
   CHECK(fmt::format("{}", failure.type()) == type_number);
 
-  ice::load_error_info<error_code_tests::errc>();
+  ice::application::load<error_code_tests::errc>();
 
   CHECK(success.code() == 0);
   CHECK(success.type() == type);
@@ -322,7 +322,7 @@ TEST_CASE("error code with error_code_tests::errc")
   CHECK(fmt::format("{}", failure) == "operation failed");
   CHECK(fmt::format("{}", failure.type()) == "error code tests");
 
-  ice::unload_error_info<error_code_tests::errc>();
+  ice::application::unload<error_code_tests::errc>();
 
   CHECK(success.code() == 0);
   CHECK(success.type() == type);
@@ -0,0 +1,125 @@
+#include <ice/error_context.hpp>
+#include <doctest/doctest.h>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <cstdio>
+
+namespace {
+
+ice::result<int> error_context_open(std::string_view path) noexcept
+{
+  if (path.empty()) {
+    return ICE_ERROR_CONTEXT(std::errc::no_such_file_or_directory, "open '{}'", path);
+  }
+  return static_cast<int>(path.size());
+}
+
+ice::result<int> error_context_load(std::string_view path) noexcept
+{
+  ICE_TRY_CONTEXT(error_context_open(path), "load {} of {}", 1, 2);
+  return 1;
+}
+
+ice::error error_context_run() noexcept
+{
+  ICE_TRY_CONTEXT(error_context_load(""), "");
+  return {};
+}
+
+ice::error error_context_remove(std::string_view path) noexcept
+{
+  ICE_TRY_CONTEXT(path.empty() ? ice::error{ std::errc::no_such_file_or_directory } : ice::error{}, "remove");
+  return {};
+}
+
+}  // namespace
+
+TEST_CASE("ice::error_context records the propagation of an error")
+{
+  const auto e = error_context_run();
+  REQUIRE(e == std::errc::no_such_file_or_directory);
+  const auto context = ice::error_context::get(e);
+  REQUIRE(context.size() == 3);
+  CHECK(context[0].note == "open ''");
+  CHECK(std::string_view{ context[0].location.function_name() }.find("error_context_open") != std::string_view::npos);
+  CHECK(context[1].note == "load 1 of 2");
+  CHECK(context[1].location.line() > context[0].location.line());
+  CHECK(context[2].note.empty());
+
+  const auto text = fmt::format("{}", context);
+  CHECK(text.find("error_context.cpp:") != std::string::npos);
+  CHECK(text.find(": load 1 of 2\n") != std::string::npos);
+
+  CHECK(ice::error_context::get(std::errc::interrupted).empty());
+  CHECK(ice::error_context::get(ice::error{}).empty());
+  std::thread([e]() {
+    CHECK(ice::error_context::get(e).empty());
+  }).join();
+
+  // A new error starts a new chain and the handle of the previous chain becomes empty.
+  ice::error_context::attach(std::errc::interrupted, std::source_location::current(), "{}", std::string(200, 'x'));
+  CHECK(context.empty());
+  const auto interrupted = ice::error_context::get(std::errc::interrupted);
+  REQUIRE(interrupted.size() == 1);
+  CHECK(interrupted[0].note.size() == ice::error_context::note_size);
+
+  ice::error_context::clear();
+  CHECK(ice::error_context::get(std::errc::interrupted).empty());
+}
+
+TEST_CASE("ice::error_context starts a new chain for an unrelated error with the same code")
+{
+  const auto e = error_context_run();
+  const auto context = ice::error_context::get(e);
+  REQUIRE(context.size() == 3);
+
+  // The error was read and a later error with the same type and code is attached without a context.
+  const auto other = error_context_remove("");
+  REQUIRE(other == e);
+  CHECK(context.empty());
+  const auto chain = ice::error_context::get(other);
+  REQUIRE(chain.size() == 1);
+  CHECK(chain[0].note == "remove");
+
+  // The error was handled without reading the chain.
+  ICE_ERROR_CONTEXT(e, "origin");
+  ice::error_context::clear();
+  REQUIRE(error_context_remove("") == e);
+  REQUIRE(ice::error_context::get(e).size() == 1);
+  ice::error_context::clear();
+}
+
+TEST_CASE("ice::error_context drops entries past its capacity")
+{
+  const ice::error e = std::errc::interrupted;
+  ice::error_context::make(e, std::source_location::current(), "origin");
+  for (std::size_t i = 0; i < ice::error_context::capacity * 2; i++) {
+    ice::error_context::attach(e, std::source_location::current(), "hop {}", i);
+  }
+  const auto context = ice::error_context::get(e);
+  REQUIRE(context.size() == ice::error_context::capacity);
+  CHECK(context[0].note == "origin");
+  CHECK(context[1].note == "hop 0");
+  ice::error_context::clear();
+}
+
+TEST_CASE("ice::error_context is formatted by the calling thread when it is logged")
+{
+  static_assert(!ice::detail::LoggerArgument<ice::error_context>);
+  const auto file = std::tmpfile();
+  REQUIRE(file);
+  ice::logger::flush();
+  ice::logger::set(file);
+  const auto e = error_context_run();
+  ice::logger::write("function", "{}\n{}", e, ice::error_context::get(e));
+  ice::error_context::clear();
+  ice::logger::flush();
+  ice::logger::set(stderr);
+
+  std::string text(4096, '\0');
+  std::rewind(file);
+  text.resize(std::fread(text.data(), 1, text.size(), file));
+  std::fclose(file);
+  CHECK(text.find(": load 1 of 2\n") != std::string::npos);
+}
@@ -0,0 +1,171 @@
+#include <ice/error_code.hpp>
+#include <doctest/doctest.h>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::string error_info_message(int code)
+{
+  return "text " + std::to_string(code);
+}
+
+std::string_view error_info_text(int code)
+{
+  return ice::error_info::cache(static_cast<ice::error_type>(0x10000), code, error_info_message);
+}
+
+}  // namespace
+
+TEST_CASE("ice::error_info can be read while types are registered")
+{
+  constexpr auto count = 64u;
+  const auto type = [](unsigned i) {
+    return static_cast<ice::error_type>(0x10000 + i * 31);
+  };
+  ice::error_info::set(type(0), "stable");
+  ice::error_info::set(type(0), error_info_text);
+
+  std::atomic_bool done{ false };
+  std::atomic_int failures{ 0 };
+  std::vector<std::thread> readers;
+  for (auto i = 0; i < 4; i++) {
+    readers.emplace_back([&]() {
+      while (!done.load(std::memory_order_relaxed)) {
+        const auto name = ice::error_info::get(type(0));
+        if (!name || std::strcmp(name, "stable") != 0 || ice::error_info::get(type(0), 7) != "text 7") {
+          failures++;
+        }
+        for (auto j = 1u; j < count; j++) {
+          if (const auto text = ice::error_info::get(type(j)); text && std::strcmp(text, "dynamic") != 0) {
+            failures++;
+          }
+        }
+      }
+    });
+  }
+  for (auto round = 0; round < 8; round++) {
+    for (auto i = 1u; i < count; i++) {
+      ice::error_info::set(type(i), "dynamic");
+    }
+    for (auto i = 1u; i < count; i++) {
+      ice::error_info::set(type(i), static_cast<const char*>(nullptr));
+    }
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  CHECK(failures == 0);
+
+  for (auto i = 1u; i < count; i++) {
+    CHECK(!ice::error_info::get(type(i)));
+    CHECK(ice::error_info::get(type(i), 0x2A) == "0000002A");
+  }
+  ice::error_info::set(type(0), static_cast<const char*>(nullptr));
+  ice::error_info::set(type(0), static_cast<std::string_view (*)(int)>(nullptr));
+  CHECK(!ice::error_info::get(type(0)));
+  CHECK(ice::error_info::get(type(0), 7) == "00000007");
+}
+
+TEST_CASE("ice::error_info caches texts")
+{
+  static auto calls = 0;
+  constexpr auto type = static_cast<ice::error_type>(0x20000);
+  constexpr auto text = [](int code) {
+    calls++;
+    return std::to_string(code);
+  };
+  std::vector<std::string_view> texts;
+  for (auto code = 0; code < 100; code++) {
+    texts.push_back(ice::error_info::cache(type, code, text));
+  }
+  CHECK(calls == 100);
+  for (auto code = 0; code < 100; code++) {
+    const auto cached = ice::error_info::cache(type, code, text);
+    CHECK(cached == std::to_string(code));
+    CHECK(cached.data() == texts[static_cast<std::size_t>(code)].data());
+  }
+  CHECK(calls == 100);
+  CHECK(ice::error_info::cache(static_cast<ice::error_type>(0x20001), 0, text) == "0");
+  CHECK(calls == 101);
+}
+
+namespace error_info_tests {
+
+enum class errc {
+  success = 0,
+  first,
+  second,
+  sparse = 0x1000,
+  negative = -2,
+};
+
+constexpr auto make_error_category(errc) noexcept
+{
+  return ice::error_category{ "tests", {
+    { errc::sparse, "sparse" },
+    { errc::second, "second" },
+    { errc::success, "success" },
+    { errc::negative, "negative" },
+    { errc::first, "first" },
+  } };
+}
+
+enum class fallback_errc {
+  success = 0,
+};
+
+constexpr auto make_error_category(fallback_errc) noexcept
+{
+  return ice::error_category{ "fallback tests", {
+    { fallback_errc::success, "success" },
+  }, [](int code) {
+    return ice::error_info::message(ice::make_error_type<std::errc>(), code);
+  } };
+}
+
+}  // namespace error_info_tests
+
+TEST_CASE("ice::error_category looks up texts at compile time")
+{
+  using error_info_tests::errc;
+  constexpr auto& category = ice::detail::error_category<errc>;
+  static_assert(ice::ErrorCategoryType<errc>);
+  static_assert(!ice::ErrorCategoryType<std::errc>);
+  static_assert(category.dense() == 3);
+  static_assert(category.text(static_cast<int>(errc::second)) == "second");
+  static_assert(category.text(static_cast<int>(errc::sparse)) == "sparse");
+  static_assert(category.text(static_cast<int>(errc::negative)) == "negative");
+  static_assert(category.text(3).empty());
+  static_assert(category.text(-1).empty());
+  CHECK(std::string_view{ category.name() } == "tests");
+
+  const auto info = ice::make_error_info(errc{});
+  CHECK(std::string_view{ info.name } == "tests");
+  CHECK(info.text(static_cast<int>(errc::first)) == "first");
+}
+
+TEST_CASE("ice::error_info contains the library categories without registration")
+{
+  CHECK(std::string_view{ ice::error_info::get(ice::make_error_type<std::errc>()) } == "generic");
+  CHECK(std::string_view{ ice::error_info::get(ice::make_error_type<ice::system::errc>()) } == "system");
+  CHECK(std::string_view{ ice::error_info::get(ice::make_error_type<ice::errc>()) } == "common");
+  const auto type = ice::make_error_type<ice::errc>();
+  CHECK(ice::error_info::message(type, static_cast<int>(ice::errc::not_available)) == "not available");
+  CHECK(ice::error_info::message(type, static_cast<int>(ice::errc::unknown)) == "unknown");
+}
+
+TEST_CASE("ice::error_category uses the fallback for codes without text")
+{
+  using error_info_tests::fallback_errc;
+  constexpr auto& category = ice::detail::error_category<fallback_errc>;
+  CHECK(category.text(0) == "success");
+  CHECK(category.text(ENOENT) == std::make_error_code(std::errc::no_such_file_or_directory).message());
+}
@@ -0,0 +1,69 @@
+#include <ice/error_telemetry.hpp>
+#include <ice/format.hpp>
+#include <doctest/doctest.h>
+#include <algorithm>
+#include <string>
+#include <thread>
+
+namespace {
+
+enum class error_telemetry_errc {
+  first = 1,
+  second = 2,
+};
+
+std::uint64_t error_telemetry_count(error_telemetry_errc code) noexcept
+{
+  const auto snapshot = ice::error_telemetry::get();
+  const auto type = ice::make_error_type<error_telemetry_errc>();
+  const auto it = std::find_if(snapshot.entries.begin(), snapshot.entries.end(), [&](const auto& entry) {
+    return entry.type == type && entry.code == static_cast<int>(code);
+  });
+  return it != snapshot.entries.end() ? it->count : 0;
+}
+
+}  // namespace
+
+TEST_CASE("ice::error_telemetry merges the counters of running and exited threads")
+{
+  const auto type = ice::make_error_type<error_telemetry_errc>();
+  const auto first = error_telemetry_count(error_telemetry_errc::first);
+  const auto second = error_telemetry_count(error_telemetry_errc::second);
+  ice::detail::error_count(type, 1);
+  ice::detail::error_count(type, 1);
+  std::thread([&]() {
+    ice::detail::error_count(type, 1);
+    ice::detail::error_count(type, 2);
+  }).join();
+  CHECK(error_telemetry_count(error_telemetry_errc::first) == first + 3);
+  CHECK(error_telemetry_count(error_telemetry_errc::second) == second + 1);
+
+  const auto snapshot = ice::error_telemetry::get();
+  CHECK(std::is_sorted(snapshot.entries.begin(), snapshot.entries.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs.type < rhs.type || (lhs.type == rhs.type && lhs.code < rhs.code);
+  }));
+  const auto text = ice::error_telemetry::text(snapshot);
+  CHECK(text.find(fmt::format("  {} 1 00000001: ", type)) != std::string::npos);
+  const auto json = ice::error_telemetry::json(snapshot);
+  CHECK(json.find("{\"seconds\":") == 0);
+  CHECK(json.find(fmt::format("{{\"type\":\"{}\",\"code\":2,\"message\":\"00000002\",\"count\":", type)) !=
+    std::string::npos);
+  CHECK(json.back() == '}');
+}
+
+TEST_CASE("ice::error_telemetry counts errors that are created from error codes")
+{
+  const auto first = error_telemetry_count(error_telemetry_errc::first);
+  const ice::error e = error_telemetry_errc::first;
+  const auto copy = e;
+  CHECK(copy == error_telemetry_errc::first);
+  CHECK(error_telemetry_errc::first == copy);
+  CHECK(copy != error_telemetry_errc::second);
+  constexpr ice::error constant = error_telemetry_errc::first;
+  static_assert(constant == error_telemetry_errc::first);
+#if ICE_ERROR_TELEMETRY
+  CHECK(error_telemetry_count(error_telemetry_errc::first) == first + 1);
+#else
+  CHECK(error_telemetry_count(error_telemetry_errc::first) == first);
+#endif
+}
@@ -0,0 +1,186 @@
+#include <ice/os/nuklear.hpp>
+#include <ice/ui/arena.hpp>
+#include <ice/ui/input.hpp>
+#include <ice/ui/player.hpp>
+#include <ice/ui/recorder.hpp>
+#include <doctest/doctest.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace std::chrono_literals;
+
+float get_text_width(nk_handle, float height, const char*, int length) noexcept
+{
+  return static_cast<float>(length) * height * 0.5f;
+}
+
+// Returns a sequence that contains every event type.
+std::vector<ice::ui::input> events() noexcept
+{
+  return {
+    { .type = ice::ui::input::type::resize, .x = 640, .y = 480 },
+    { .type = ice::ui::input::type::motion, .x = 120, .y = -15 },
+    { .type = ice::ui::input::type::button, .id = NK_BUTTON_LEFT, .down = true, .x = 20, .y = 12 },
+    { .type = ice::ui::input::type::frame },
+    { .type = ice::ui::input::type::button, .id = NK_BUTTON_LEFT, .down = false, .x = 20, .y = 12 },
+    { .type = ice::ui::input::type::scroll, .dx = 0.5f, .dy = -3.25f },
+    { .type = ice::ui::input::type::key, .id = NK_KEY_BACKSPACE, .down = true },
+    { .type = ice::ui::input::type::unicode, .code = U'ユ' },
+    { .type = ice::ui::input::type::frame },
+  };
+}
+
+// Records the events in memory with increasing timestamps.
+std::vector<std::uint8_t> record(const std::vector<ice::ui::input>& events) noexcept
+{
+  const auto start = ice::ui::recorder::clock::now();
+  ice::ui::recorder recorder;
+  REQUIRE(!recorder.open({}, start));
+  auto time = start;
+  for (const auto& event : events) {
+    time += 1500us;
+    recorder.write(event, time);
+  }
+  auto data = recorder.data();
+  REQUIRE(!recorder.close());
+  return data;
+}
+
+// Runs one frame with an edit field per frame event and returns the text commands of the last frame.
+std::vector<std::string> edit(nk_context* context, ice::ui::arena& arena, const std::vector<ice::ui::input>& events,
+  bool replay) noexcept
+{
+  char buffer[64]{};
+  std::vector<std::string> texts;
+  auto event = events.begin();
+  while (event != events.end()) {
+    texts.clear();
+    nk_input_begin(context);
+    for (; event != events.end() && event->type != ice::ui::input::type::frame; ++event) {
+      if (replay) {
+        event->apply(context);
+      } else if (event->type == ice::ui::input::type::motion) {
+        nk_input_motion(context, event->x, event->y);
+      } else if (event->type == ice::ui::input::type::button) {
+        nk_input_button(context, static_cast<nk_buttons>(event->id), event->x, event->y, event->down);
+      } else if (event->type == ice::ui::input::type::unicode) {
+        nk_input_unicode(context, static_cast<nk_rune>(event->code));
+      }
+    }
+    if (event != events.end()) {
+      ++event;
+    }
+    nk_input_end(context);
+    if (nk_begin(context, "input", nk_rect(0, 0, 640, 480), NK_WINDOW_BORDER)) {
+      nk_layout_row_dynamic(context, 30, 1);
+      nk_edit_string_zero_terminated(context, NK_EDIT_FIELD, buffer, sizeof(buffer), nk_filter_default);
+    }
+    nk_end(context);
+    const nk_command* command = nullptr;
+    nk_foreach(command, context)
+    {
+      if (command->type == NK_COMMAND_TEXT) {
+        const auto& text = *reinterpret_cast<const nk_command_text*>(command);
+        texts.emplace_back(text.string, static_cast<std::size_t>(text.length));
+      }
+    }
+    arena.clear(context);
+  }
+  return texts;
+}
+
+}  // namespace
+
+TEST_CASE("ice::ui::recorder encodes events that ice::ui::player decodes")
+{
+  const auto expected = events();
+  ice::ui::player player;
+  REQUIRE(!player.open(record(expected)));
+  ice::ui::input event;
+  for (std::size_t i = 0; i < expected.size(); i++) {
+    REQUIRE(player.next(event));
+    CHECK(event.type == expected[i].type);
+    CHECK(event.id == expected[i].id);
+    CHECK(event.down == expected[i].down);
+    CHECK(event.x == expected[i].x);
+    CHECK(event.y == expected[i].y);
+    CHECK(event.dx == expected[i].dx);
+    CHECK(event.dy == expected[i].dy);
+    CHECK(event.code == expected[i].code);
+    CHECK(event.time == std::chrono::microseconds{ 1500 * static_cast<int>(i + 1) });
+  }
+  CHECK(!player.next(event));
+  CHECK(!player.playing());
+  player.rewind();
+  CHECK(player.playing());
+}
+
+TEST_CASE("ice::ui::player produces the same ui as direct input")
+{
+  std::vector<ice::ui::input> events{
+    { .type = ice::ui::input::type::motion, .x = 20, .y = 15 },
+    { .type = ice::ui::input::type::frame },
+    { .type = ice::ui::input::type::button, .id = NK_BUTTON_LEFT, .down = true, .x = 20, .y = 15 },
+    { .type = ice::ui::input::type::frame },
+    { .type = ice::ui::input::type::button, .id = NK_BUTTON_LEFT, .down = false, .x = 20, .y = 15 },
+    { .type = ice::ui::input::type::frame },
+    { .type = ice::ui::input::type::unicode, .code = U'i' },
+    { .type = ice::ui::input::type::unicode, .code = U'c' },
+    { .type = ice::ui::input::type::unicode, .code = U'e' },
+    { .type = ice::ui::input::type::frame },
+  };
+  ice::ui::player player;
+  REQUIRE(!player.open(record(events)));
+  std::vector<ice::ui::input> replayed;
+  for (ice::ui::input event; player.next(event);) {
+    replayed.push_back(event);
+  }
+  REQUIRE(replayed.size() == events.size());
+
+  nk_user_font font{};
+  font.height = 13.0f;
+  font.width = get_text_width;
+  ice::ui::arena direct_arena;
+  nk_context direct_context{};
+  REQUIRE(!direct_arena.create(&direct_context, &font));
+  const auto direct = edit(&direct_context, direct_arena, events, false);
+  nk_free(&direct_context);
+
+  ice::ui::arena replay_arena;
+  nk_context replay_context{};
+  REQUIRE(!replay_arena.create(&replay_context, &font));
+  const auto replay = edit(&replay_context, replay_arena, replayed, true);
+  nk_free(&replay_context);
+
+  REQUIRE(!direct.empty());
+  CHECK(direct == replay);
+  CHECK(direct.back() == "ice");
+}
+
+TEST_CASE("ice::ui::player rejects invalid recordings")
+{
+  auto data = record(events());
+  ice::ui::player player;
+  CHECK(player.open(std::vector<std::uint8_t>{ 'I', 'C', 'E' }) == std::errc::invalid_argument);
+
+  auto magic = data;
+  magic[0] = 'X';
+  CHECK(player.open(magic) == std::errc::invalid_argument);
+
+  auto version = data;
+  version[4] = ice::ui::input::version + 1;
+  CHECK(player.open(version) == std::errc::not_supported);
+
+  data.resize(data.size() - 3);
+  REQUIRE(!player.open(data));
+  ice::ui::input event;
+  auto count = 0;
+  while (player.next(event)) {
+    count++;
+  }
+  CHECK(count < static_cast<int>(events().size()));
+  CHECK(!player.playing());
+}
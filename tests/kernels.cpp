@@ -0,0 +1,117 @@
+#include <ice/ui/kernels.hpp>
+#include <doctest/doctest.h>
+#include <array>
+#include <vector>
+
+namespace {
+
+// Deterministic pseudo-random numbers for test pixels.
+class generator {
+public:
+  std::uint32_t operator()() noexcept
+  {
+    state_ ^= state_ << 13;
+    state_ ^= state_ >> 17;
+    state_ ^= state_ << 5;
+    return state_;
+  }
+
+private:
+  std::uint32_t state_{ 0x9E3779B9 };
+};
+
+std::vector<std::uint32_t> pixels(generator& random, std::size_t size)
+{
+  std::vector<std::uint32_t> pixels(size);
+  for (auto& pixel : pixels) {
+    pixel = random() & 0x00FFFFFF;
+  }
+  return pixels;
+}
+
+}  // namespace
+
+TEST_CASE("kernels scalar")
+{
+  const auto kernels = ice::ui::kernels::get(ice::ui::kernels::isa::scalar);
+  REQUIRE(kernels);
+
+  std::array<std::uint32_t, 3> dst{ 0x123456, 0x123456, 0x123456 };
+  kernels->fill(dst.data(), 2, 0x80FFFFFF);
+  CHECK(dst[0] == 0xFFFFFF);
+  CHECK(dst[1] == 0xFFFFFF);
+  CHECK(dst[2] == 0x123456);
+
+  dst = { 0x000000, 0xFFFFFF, 0x808080 };
+  kernels->blend(dst.data(), dst.size(), 0x00FF0000);
+  CHECK(dst[0] == 0x000000);
+  CHECK(dst[1] == 0xFFFFFF);
+  CHECK(dst[2] == 0x808080);
+  kernels->blend(dst.data(), dst.size(), 0xFF00FF00);
+  CHECK(dst[0] == 0x00FF00);
+  CHECK(dst[1] == 0x00FF00);
+  CHECK(dst[2] == 0x00FF00);
+
+  dst = { 0x000000, 0x000000, 0x000000 };
+  const std::array<std::uint8_t, 3> coverage{ 0, 128, 255 };
+  kernels->cover(dst.data(), dst.size(), 0xFFFFFFFF, coverage.data());
+  CHECK(dst[0] == 0x000000);
+  CHECK(dst[1] == 0x808080);
+  CHECK(dst[2] == 0xFFFFFF);
+
+  dst = { 0x000000, 0x000000, 0x000000 };
+  kernels->gradient(dst.data(), dst.size(), 0xFF000000, 0xFF0000FF, 0, 128 << 16);
+  CHECK(dst[0] == 0x000000);
+  CHECK(dst[1] == 0x00007F);
+  CHECK(dst[2] == 0x0000FF);
+}
+
+TEST_CASE("kernels simd")
+{
+  using isa = ice::ui::kernels::isa;
+  const auto& scalar = *ice::ui::kernels::get(isa::scalar);
+  CHECK(ice::ui::kernels::get().fill);
+  for (const auto type : { isa::sse2, isa::avx2 }) {
+    const auto kernels = ice::ui::kernels::get(type);
+    if (!kernels) {
+      continue;
+    }
+    CHECK(kernels->type == type);
+    generator random;
+    for (std::size_t size = 0; size < 70; size++) {
+      const auto source = pixels(random, size);
+      std::vector<std::uint8_t> coverage(size);
+      for (auto& value : coverage) {
+        value = static_cast<std::uint8_t>(random());
+      }
+      const auto color = random();
+      const auto left = random();
+      const auto right = random();
+      const auto step = size > 1 ? ((256u << 16) + size - 2) / (size - 1) : 0u;
+
+      auto expected = source;
+      auto result = source;
+      scalar.fill(expected.data(), size, color);
+      kernels->fill(result.data(), size, color);
+      CHECK(result == expected);
+
+      expected = source;
+      result = source;
+      scalar.blend(expected.data(), size, color);
+      kernels->blend(result.data(), size, color);
+      CHECK(result == expected);
+
+      expected = source;
+      result = source;
+      scalar.cover(expected.data(), size, color, coverage.data());
+      kernels->cover(result.data(), size, color, coverage.data());
+      CHECK(result == expected);
+
+      expected = source;
+      result = source;
+      scalar.gradient(expected.data(), size, left, right, 0, static_cast<std::uint32_t>(step));
+      kernels->gradient(result.data(), size, left, right, 0, static_cast<std::uint32_t>(step));
+      CHECK(result == expected);
+    }
+  }
+}
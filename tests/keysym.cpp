@@ -0,0 +1,59 @@
+#ifndef _WIN32
+#  include <ice/os/xcb/keysym.hpp>
+#  include <doctest/doctest.h>
+#  include <string>
+
+namespace {
+
+// Feeds keysyms to a compose state and returns the produced text.
+std::u32string type(std::initializer_list<xcb_keysym_t> keysyms) noexcept
+{
+  ice::os::xcb::compose compose;
+  std::u32string text;
+  for (const auto keysym : keysyms) {
+    if (const auto code = compose(keysym)) {
+      text.push_back(code);
+    }
+  }
+  return text;
+}
+
+}  // namespace
+
+TEST_CASE("ice::os::xcb::to_unicode")
+{
+  static_assert(ice::os::xcb::to_unicode(XK_a) == U'a');
+  static_assert(ice::os::xcb::to_unicode(XK_Cyrillic_zhe) == U'ж');
+  CHECK(ice::os::xcb::to_unicode(XK_space) == U' ');
+  CHECK(ice::os::xcb::to_unicode(XK_adiaeresis) == U'ä');
+  CHECK(ice::os::xcb::to_unicode(XK_ssharp) == U'ß');
+  CHECK(ice::os::xcb::to_unicode(XK_Greek_OMEGA) == U'Ω');
+  CHECK(ice::os::xcb::to_unicode(XK_kana_A) == U'ア');
+  CHECK(ice::os::xcb::to_unicode(XK_hebrew_aleph) == U'א');
+  CHECK(ice::os::xcb::to_unicode(XK_EuroSign) == U'€');
+  CHECK(ice::os::xcb::to_unicode(0x01000000 + U'ユ') == U'ユ');
+  CHECK(ice::os::xcb::to_unicode(0x01000000 + U'😀') == U'😀');
+  CHECK(ice::os::xcb::to_unicode(XK_KP_7) == U'7');
+  CHECK(ice::os::xcb::to_unicode(XK_KP_Decimal) == U'.');
+  CHECK(ice::os::xcb::to_unicode(XK_Shift_L) == 0);
+  CHECK(ice::os::xcb::to_unicode(XK_F1) == 0);
+  CHECK(ice::os::xcb::to_unicode(XK_Return) == 0);
+  CHECK(ice::os::xcb::to_unicode(XK_KP_Enter) == 0);
+  CHECK(ice::os::xcb::to_unicode(XK_dead_acute) == 0);
+  CHECK(ice::os::xcb::to_unicode(0x01000000 + 0x80) == 0);
+}
+
+TEST_CASE("ice::os::xcb::compose")
+{
+  CHECK(type({ XK_a, XK_b }) == U"ab");
+  CHECK(type({ XK_dead_acute, XK_e }) == U"é");
+  CHECK(type({ XK_dead_circumflex, XK_Shift_L, XK_O }) == U"Ô");
+  CHECK(type({ XK_dead_diaeresis, XK_Cyrillic_ie }) == U"ё");
+  CHECK(type({ XK_dead_acute, XK_x }) == U"x");
+  CHECK(type({ XK_dead_acute, XK_Escape, XK_e }) == U"e");
+  CHECK(type({ XK_Multi_key, XK_apostrophe, XK_a }) == U"á");
+  CHECK(type({ XK_Multi_key, XK_a, XK_quotedbl }) == U"ä");
+  CHECK(type({ XK_Multi_key, XK_comma, XK_c, XK_d }) == U"çd");
+  CHECK(type({ XK_Multi_key, XK_x, XK_y, XK_z }) == U"z");
+}
+#endif
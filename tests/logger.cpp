@@ -0,0 +1,110 @@
+#include <ice/logger.hpp>
+#include <doctest/doctest.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdio>
+
+namespace {
+
+std::string logger_read(std::FILE* file)
+{
+  std::string text;
+  std::rewind(file);
+  char buffer[4096];
+  while (const auto size = std::fread(buffer, 1, sizeof(buffer), file)) {
+    text.append(buffer, size);
+  }
+  return text;
+}
+
+}  // namespace
+
+TEST_CASE("ice::logger writes whole lines from multiple threads in order")
+{
+  const auto file = std::tmpfile();
+  REQUIRE(file);
+  ice::logger::flush();
+  ice::logger::set(file);
+  const auto dropped = ice::logger::dropped();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([i]() {
+      for (int j = 0; j < 10000; j++) {
+        if (j % 2) {
+          ice::logger::write("function", "thread {} line {}", i, j);
+        } else {
+          ice::logger::write("thread " + std::to_string(i) + " line " + std::to_string(j) + '\n');
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  ice::logger::flush();
+  ice::logger::set(stderr);
+  CHECK(ice::logger::dropped() == dropped);
+
+  const auto text = logger_read(file);
+  std::fclose(file);
+  std::vector<int> lines(4, 0);
+  std::size_t begin = 0;
+  for (auto end = text.find('\n'); end != std::string::npos; begin = end + 1, end = text.find('\n', begin)) {
+    int thread = -1;
+    int line = -1;
+    const auto position = text.find("thread ", begin);
+    REQUIRE(position < end);
+    REQUIRE(std::sscanf(text.c_str() + position, "thread %d line %d", &thread, &line) == 2);
+    REQUIRE(thread >= 0);
+    REQUIRE(thread < 4);
+    CHECK(line == lines[thread]++);
+  }
+  CHECK(begin == text.size());
+  CHECK(lines == std::vector<int>(4, 10000));
+}
+
+TEST_CASE("ice::logger truncates long lines")
+{
+  const auto file = std::tmpfile();
+  REQUIRE(file);
+  ice::logger::flush();
+  ice::logger::set(file);
+  ice::logger::write("begin\n");
+  ice::logger::write(std::string(ice::logger::buffer_size * 2, 'x'));
+  ice::logger::write("end\n");
+  ice::logger::flush();
+  ice::logger::set(stderr);
+
+  const auto text = logger_read(file);
+  std::fclose(file);
+  REQUIRE(text.size() == 6 + ice::logger::line_size + 4);
+  CHECK(text.substr(0, 6) == "begin\n");
+  CHECK(text.find('\n', 6) == 6 + ice::logger::line_size - 1);
+  CHECK(text.substr(6 + ice::logger::line_size) == "end\n");
+}
+
+TEST_CASE("ice::logger formats binary records on the background thread")
+{
+  const auto file = std::tmpfile();
+  REQUIRE(file);
+  ice::logger::flush();
+  ice::logger::set(file);
+  std::string text{ "string" };
+  ice::logger::write("function", "{} {} {:.1f} {}", 42, text, 0.5, std::string_view{ "view" });
+  text.assign("changed");
+  ice::logger::write("function", "");
+  ice::logger::write("text\n");
+  ice::logger::flush();
+  ice::logger::set(stderr);
+
+  const auto lines = logger_read(file);
+  std::fclose(file);
+  const auto first = lines.find("] function: 42 string 0.5 view\n");
+  const auto second = lines.find("] function\n");
+  REQUIRE(first != std::string::npos);
+  REQUIRE(second != std::string::npos);
+  CHECK(lines.front() == '[');
+  CHECK(first < second);
+  CHECK(lines.substr(lines.size() - 5) == "text\n");
+}
@@ -0,0 +1,157 @@
+#include <ice/context.hpp>
+#include <ice/os/nuklear.hpp>
+#include <ice/ui/arena.hpp>
+#include <ice/ui/font.hpp>
+#include <ice/ui/raster.hpp>
+#include <doctest/doctest.h>
+#include <array>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <cstring>
+
+namespace {
+
+// Fixed advance font with a synthetic glyph for every code point.
+class font final : public ice::ui::font {
+public:
+  font() noexcept
+  {
+    for (std::size_t i = 0; i < bitmap_.size(); i++) {
+      bitmap_[i] = static_cast<std::uint8_t>(i * 37);
+    }
+    font_.userdata = nk_handle_ptr(this);
+    font_.height = 13.0f;
+    font_.width = get_text_width;
+    ice::ui::font::set(&font_);
+  }
+
+  ~font() override
+  {
+    ice::ui::font::set(nullptr);
+  }
+
+  float width(std::string_view text, float) const noexcept override
+  {
+    return static_cast<float>(text.size()) * 7.0f;
+  }
+
+  float advance(char32_t) const noexcept override
+  {
+    return 7.0f;
+  }
+
+  float ascent() const noexcept override
+  {
+    return 10.0f;
+  }
+
+  bool find(char32_t code, glyph& glyph) const noexcept override
+  {
+    glyph.data = bitmap_.data() + code % 7;
+    glyph.stride = 8;
+    glyph.x = 0;
+    glyph.y = -10;
+    glyph.cx = 6;
+    glyph.cy = 12;
+    return true;
+  }
+
+private:
+  static float get_text_width(nk_handle handle, float height, const char* string, int length) noexcept
+  {
+    const auto self = static_cast<const font*>(handle.ptr);
+    return self->width({ string, static_cast<std::size_t>(length) }, height);
+  }
+
+  std::array<std::uint8_t, 8 * 16> bitmap_{};
+  nk_user_font font_{};
+};
+
+// Draws overlapping windows with widgets, text, shapes and nested scissors.
+void frame(nk_context* context) noexcept
+{
+  nk_input_begin(context);
+  nk_input_motion(context, 90, 70);
+  nk_input_end(context);
+  if (nk_begin(context, "first", nk_rect(10, 10, 260, 220), NK_WINDOW_BORDER | NK_WINDOW_TITLE)) {
+    nk_layout_row_dynamic(context, 24, 2);
+    for (int i = 0; i < 6; i++) {
+      nk_label(context, "label text", NK_TEXT_LEFT);
+      nk_button_label(context, "button");
+    }
+    static float value = 0.3f;
+    nk_layout_row_dynamic(context, 20, 1);
+    nk_slider_float(context, 0.0f, &value, 1.0f, 0.1f);
+  }
+  nk_end(context);
+  if (nk_begin(context, "second", nk_rect(150, 120, 180, 120), NK_WINDOW_BORDER)) {
+    const auto canvas = nk_window_get_canvas(context);
+    const auto clip = canvas->clip;
+    nk_push_scissor(canvas, nk_rect(160, 130, 100, 60));
+    nk_fill_circle(canvas, nk_rect(170, 140, 120, 90), nk_rgba(200, 40, 40, 180));
+    nk_stroke_line(canvas, 150, 120, 330, 240, 3.0f, nk_rgb(20, 200, 20));
+    nk_draw_text(canvas, nk_rect(150, 170, 160, 20), "scissored text", 14, context->style.font,
+      nk_rgb(0, 0, 0), nk_rgb(255, 255, 255));
+    nk_push_scissor(canvas, clip);
+    nk_fill_triangle(canvas, 200, 200, 320, 230, 170, 235, nk_rgba(40, 40, 200, 128));
+    nk_stroke_rect(canvas, nk_rect(155, 125, 170, 110), 4.0f, 2.0f, nk_rgb(250, 250, 0));
+  }
+  nk_end(context);
+}
+
+}  // namespace
+
+TEST_CASE("raster tiles")
+{
+  constexpr int cx = 333;
+  constexpr int cy = 251;
+  constexpr std::uint32_t background = 0x1E1E1E;
+  constexpr std::size_t size = static_cast<std::size_t>(cx) * cy * sizeof(std::uint32_t);
+
+  font font;
+  ice::ui::arena arena;
+  nk_context context{};
+  REQUIRE(!arena.create(&context, font.get()));
+  frame(&context);
+  arena.clear(&context);
+  frame(&context);
+
+  ice::context workers;
+  std::optional<ice::context::work> work{ workers };
+  std::thread thread{ [&]() {
+    workers.run();
+  } };
+
+  ice::ui::raster serial;
+  ice::ui::raster tiles;
+  REQUIRE(!serial.resize(cx, cy));
+  REQUIRE(!tiles.resize(cx, cy));
+
+  serial.clear(background);
+  serial.render(&context);
+  std::size_t drawn = 0;
+  for (std::size_t i = 0; i < static_cast<std::size_t>(cx) * cy; i++) {
+    drawn += serial.data()[i] != background ? 1 : 0;
+  }
+  REQUIRE(drawn > 10000);
+  for (const std::size_t concurrency : { 0, 1, 3 }) {
+    tiles.clear(0);
+    tiles.render(&context, background, workers, concurrency);
+    CHECK(std::memcmp(serial.data(), tiles.data(), size) == 0);
+  }
+
+  // Pixels outside of the region are not modified.
+  const ice::ui::raster::rect region{ 70, 50, 300, 200 };
+  serial.clear(0);
+  serial.clear(background, region);
+  serial.render(&context, region);
+  tiles.clear(0);
+  tiles.render(&context, region, background, workers, 2);
+  CHECK(std::memcmp(serial.data(), tiles.data(), size) == 0);
+
+  work.reset();
+  workers.stop();
+  thread.join();
+  nk_free(&context);
+}
@@ -78,7 +78,7 @@ static_assert(!std::is_copy_assignable_v<ice::result<no_copy_assignable_type>>);
 
 TEST_CASE("ice::result<void>")
 {
-  ice::application application;
+  ice::application::load();
 
   constexpr ice::result<void> success;
   static_assert(success.type() == ice::error_type::success);
@@ -134,7 +134,7 @@ TEST_CASE("ice::result<void>")
 
 TEST_CASE("ice::result<std::string>")
 {
-  ice::application application;
+  ice::application::load();
 
   ice::result<std::string> success{ "ok" };
   CHECK(success.type() == ice::error_type::success);
@@ -186,6 +186,229 @@ TEST_CASE("ice::result<std::string>")
   CHECK(ice::error{} != failure);
 }
 
+enum packed_enum : unsigned char {
+  packed_none,
+  packed_some,
+};
+
+enum class packed_errc {
+  failure = 1,
+};
+
+static_assert(sizeof(ice::result<int>) == 8);
+static_assert(sizeof(ice::result<float>) == 8);
+static_assert(sizeof(ice::result<packed_enum>) == 8);
+static_assert(sizeof(ice::result<int*>) == sizeof(void*) || sizeof(void*) != 8);
+static_assert(sizeof(ice::result<char*>) > sizeof(void*));
+static_assert(sizeof(ice::result<void*>) > sizeof(void*));
+static_assert(sizeof(ice::result<no_move_constructible_type>) > 8);
+
+ice::result<int*> result_co_return_pointer(int* value) noexcept
+{
+  co_return value;
+}
+
+ice::result<packed_enum> result_co_return_enum_error() noexcept
+{
+  co_await ice::result<void>{ std::errc::interrupted };
+  co_return packed_some;
+}
+
+TEST_CASE("ice::result packed layouts")
+{
+  ice::result<int> success{ -1 };
+  CHECK(success);
+  CHECK(success.value() == -1);
+  CHECK(success.error() == ice::error{});
+
+  ice::result<int> failure{ std::errc::no_such_file_or_directory };
+  CHECK(!failure);
+  CHECK(failure.type() == ice::make_error_type<std::errc>());
+  CHECK(failure.code() == static_cast<int>(std::errc::no_such_file_or_directory));
+  CHECK(failure == std::errc::no_such_file_or_directory);
+  CHECK(ice::result<int>{ ice::make_error(std::errc::file_exists) } == std::errc::file_exists);
+  CHECK(ice::result<int>{ ice::error{} } == ice::errc::invalid_result_value);
+
+  auto copy = failure;
+  CHECK(copy == std::errc::no_such_file_or_directory);
+  copy = success;
+  CHECK(*copy == -1);
+
+  int value = 3;
+  ice::result<int*> pointer{ &value };
+  CHECK(pointer);
+  CHECK(*pointer == &value);
+  CHECK(ice::result<int*>{ nullptr });
+  CHECK(ice::result<int*>{ std::errc::file_exists } == std::errc::file_exists);
+
+  // Pointers to bytes can be odd and are not packed.
+  char text[2]{};
+  ice::result<char*> odd{ text + 1 };
+  CHECK(odd);
+  CHECK(*odd == text + 1);
+  CHECK(ice::result<char*>{ std::errc::file_exists } == std::errc::file_exists);
+
+  const auto large = ice::make_error(ice::make_error_type<std::errc>(), 0x40000000);
+  CHECK(ice::result<int>{ large } == large);
+  CHECK(ice::result<int>{ packed_errc::failure } == packed_errc::failure);
+  CHECK(ice::result<int*>{ packed_errc::failure } == packed_errc::failure);
+
+  CHECK(*result_co_return_pointer(&value) == &value);
+  CHECK(result_co_return_enum_error() == std::errc::interrupted);
+}
+
+TEST_CASE("ice::result packed layouts with many errors")
+{
+  // Errors that can not be encoded in the index are stored in a table that grows on demand.
+  constexpr int count = 100000;
+  for (int i = 0; i < count; i++) {
+    const auto e = ice::make_error(ice::make_error_type<packed_errc>(), i + 2);
+    REQUIRE(ice::result<int>{ e } == e);
+  }
+  for (int i = 0; i < count; i += 997) {
+    const auto e = ice::make_error(ice::make_error_type<packed_errc>(), i + 2);
+    CHECK(ice::result<int>{ e }.error() == e);
+  }
+}
+
+ice::result<int> result_parse(int value) noexcept
+{
+  if (value < 0) {
+    return std::errc::invalid_argument;
+  }
+  return value;
+}
+
+ice::result<std::string> result_parse_string(int value) noexcept
+{
+  if (value < 0) {
+    return std::errc::invalid_argument;
+  }
+  return std::string(static_cast<std::size_t>(value), 'x');
+}
+
+ice::error result_validate(int value) noexcept
+{
+  if (value > 9) {
+    return std::errc::result_out_of_range;
+  }
+  return {};
+}
+
+ice::result<int> result_try_sum(int lhs, int rhs) noexcept
+{
+  ICE_TRY(result_validate(lhs));
+  ICE_TRY(ice::result<void>{});
+  ICE_TRY_ASSIGN(const auto value, result_parse(lhs));
+  ICE_TRY_ASSIGN(auto string, result_parse_string(rhs));
+  return value + static_cast<int>(string.size());
+}
+
+ice::error result_try_error(int value) noexcept
+{
+  ICE_TRY(result_parse(value));
+  ICE_TRY(std::errc{});
+  return result_validate(value);
+}
+
+ice::result<int> result_try_code(std::error_code ec) noexcept
+{
+  ICE_TRY(ec);
+  ICE_TRY(ice::make_error_code(std::errc{}));
+  int value = 0;
+  ICE_TRY_ASSIGN(value, result_parse(3));
+  return value;
+}
+
+TEST_CASE("ice::result propagation without coroutines")
+{
+  CHECK(*result_try_code({}) == 3);
+  CHECK(result_try_code(std::make_error_code(std::errc::interrupted)) == std::errc::interrupted);
+  CHECK(*result_try_sum(1, 2) == 3);
+  CHECK(result_try_sum(10, 2) == std::errc::result_out_of_range);
+  CHECK(result_try_sum(-1, 2) == std::errc::invalid_argument);
+  CHECK(result_try_sum(1, -2) == std::errc::invalid_argument);
+  CHECK(!result_try_error(1));
+  CHECK(result_try_error(-1) == std::errc::invalid_argument);
+  CHECK(result_try_error(10) == std::errc::result_out_of_range);
+
+  const auto twice = [](int value) noexcept -> ice::result<int> {
+    return value * 2;
+  };
+  CHECK(*result_parse(2).and_then(twice) == 4);
+  CHECK(result_parse(-2).and_then(twice) == std::errc::invalid_argument);
+  CHECK(*result_parse(2).and_then(result_parse_string) == "xx");
+  CHECK(result_parse(2).and_then(result_parse).and_then([](int) noexcept -> ice::result<void> {
+    return std::errc::interrupted;
+  }) == std::errc::interrupted);
+
+  const auto length = [](const std::string& value) noexcept {
+    return value.size();
+  };
+  const auto string = result_parse_string(3);
+  CHECK(*string.transform(length) == 3);
+  CHECK(*result_parse_string(3).transform([](std::string&& value) noexcept {
+    return std::move(value) + "y";
+  }) == "xxxy");
+  CHECK(result_parse_string(-3).transform(length) == std::errc::invalid_argument);
+
+  auto called = false;
+  CHECK(result_parse(1).transform([&](int) noexcept {
+    called = true;
+  }));
+  CHECK(called);
+  CHECK(result_parse(-1).transform([](int) noexcept {}) == std::errc::invalid_argument);
+
+  const auto recover = [](ice::error e) noexcept -> ice::result<int> {
+    if (e == std::errc::invalid_argument) {
+      return 0;
+    }
+    return e;
+  };
+  CHECK(*result_parse(5).or_else(recover) == 5);
+  CHECK(*result_parse(-5).or_else(recover) == 0);
+  CHECK(ice::result<int>{ std::errc::interrupted }.or_else(recover) == std::errc::interrupted);
+  CHECK(*result_parse_string(-1).or_else([](ice::error) noexcept {
+    return std::string("y");
+  }) == "y");
+  CHECK(result_parse_string(-1).or_else([](ice::error) noexcept {
+    return std::errc::interrupted;
+  }) == std::errc::interrupted);
+
+  const ice::result<void> success;
+  CHECK(*success.and_then([]() noexcept {
+    return result_parse(7);
+  }) == 7);
+  CHECK(*success.transform([]() noexcept {
+    return 7;
+  }) == 7);
+  CHECK(success.or_else([](ice::error e) noexcept {
+    return e;
+  }));
+  const ice::result<void> failure{ std::errc::interrupted };
+  CHECK(failure.transform([]() noexcept {
+    return 7;
+  }) == std::errc::interrupted);
+  CHECK(failure.or_else([](ice::error) noexcept {
+    return ice::result<void>{};
+  }));
+}
+
+ice::result<int> result_co_await_sum(int lhs, int rhs) noexcept
+{
+  co_await result_parse(lhs);
+  co_await result_parse_string(rhs);
+  co_return lhs + rhs;
+}
+
+TEST_CASE("ice::result propagation with coroutines")
+{
+  // Awaiting a successful result resumes the coroutine.
+  CHECK(*result_co_await_sum(1, 2) == 3);
+  CHECK(result_co_await_sum(-1, 2) == std::errc::invalid_argument);
+  CHECK(result_co_await_sum(1, -2) == std::errc::invalid_argument);
+}
+
 constexpr ice::result<void> result_return_void() noexcept
 {
   return {};
@@ -228,7 +451,7 @@ ice::result<void> result_co_return_void_error() noexcept
 
 TEST_CASE("ice::result<void> syntax")
 {
-  ice::application application;
+  ice::application::load();
 
   static_assert(result_return_void());
   static_assert(result_return_void_error_enum() == std::errc::no_such_file_or_directory);
@@ -307,7 +530,7 @@ ice::result<std::string_view> result_co_return_string_view_error() noexcept
 
 TEST_CASE("result syntax with std::string_view")
 {
-  ice::application application;
+  ice::application::load();
 
   CHECK(result_return_string_view());
   CHECK(result_return_string_view()->empty());
@@ -372,7 +595,7 @@ ice::result<restricted_type> result_co_return_restricted_type_error() noexcept
 
 TEST_CASE("result construction")
 {
-  ice::application application;
+  ice::application::load();
 
   CHECK(result_return_no_default_constructible());
   CHECK(result_return_no_default_constructible()->value == 3);
@@ -437,7 +660,7 @@ ice::result<void> outer()
 
 TEST_CASE("result awaitable")
 {
-  ice::application application;
+  ice::application::load();
 
   task::error = {};
   auto never_set = false;
@@ -448,6 +671,6 @@ TEST_CASE("result awaitable")
 
   CHECK(!never_set);
   CHECK(task::error == std::errc::interrupted);
-  CHECK(fmt::format("{}", task::error.type()) == "system");
-  CHECK(fmt::format("{}", task::error) == "interrupted");
+  CHECK(fmt::format("{}", task::error.type()) == "generic");
+  CHECK(fmt::format("{}", task::error) == std::make_error_code(std::errc::interrupted).message());
 }
@@ -0,0 +1,131 @@
+#include <ice/os/nuklear.hpp>
+#include <ice/ui/arena.hpp>
+#include <ice/ui/swapchain.hpp>
+#include <doctest/doctest.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+float get_text_width(nk_handle, float height, const char*, int length) noexcept
+{
+  return static_cast<float>(length) * height * 0.5f;
+}
+
+std::vector<nk_command_type> commands(nk_context* context) noexcept
+{
+  std::vector<nk_command_type> types;
+  const nk_command* command = nullptr;
+  nk_foreach(command, context)
+  {
+    types.push_back(command->type);
+  }
+  return types;
+}
+
+}  // namespace
+
+TEST_CASE("swapchain frame")
+{
+  nk_user_font font{};
+  font.height = 13.0f;
+  font.width = get_text_width;
+
+  ice::ui::arena arena;
+  nk_context context{};
+  REQUIRE(!arena.create(&context, &font));
+  if (nk_begin(&context, "frame", nk_rect(0, 0, 640, 480), NK_WINDOW_BORDER)) {
+    nk_layout_row_dynamic(&context, 20, 2);
+    nk_label(&context, "label", NK_TEXT_LEFT);
+    nk_button_label(&context, "button");
+  }
+  nk_end(&context);
+  if (nk_begin(&context, "popup", nk_rect(100, 100, 200, 100), NK_WINDOW_BORDER)) {
+    nk_layout_row_dynamic(&context, 20, 1);
+    nk_label(&context, "label", NK_TEXT_LEFT);
+  }
+  nk_end(&context);
+
+  // The copy contains the commands of all windows and outlives the context frame.
+  ice::ui::frame frame;
+  const auto time = ice::ui::frame::clock::now();
+  REQUIRE(!frame.assign(&context, 640, 480, time));
+  const auto expected = commands(&context);
+  arena.clear(&context);
+  CHECK(!expected.empty());
+  CHECK(commands(frame.get()) == expected);
+  CHECK(frame.cx() == 640);
+  CHECK(frame.cy() == 480);
+  CHECK(frame.input() == time);
+
+  // Empty command lists can be copied.
+  REQUIRE(!frame.assign(&context, 640, 480));
+  CHECK(commands(frame.get()).empty());
+
+  nk_free(&context);
+}
+
+TEST_CASE("swapchain handoff")
+{
+  ice::ui::swapchain swapchain;
+
+  // The consumer gets the newest frame and replaced frames are dropped.
+  REQUIRE(!swapchain.back().assign(nullptr, 1, 1));
+  swapchain.publish();
+  REQUIRE(!swapchain.back().assign(nullptr, 2, 2));
+  swapchain.publish();
+  const auto frame = swapchain.acquire();
+  REQUIRE(frame);
+  CHECK(frame->cx() == 2);
+  CHECK(swapchain.published() == 2);
+  CHECK(swapchain.dropped() == 1);
+
+  // The producer never writes the frame that is owned by the consumer.
+  for (int i = 0; i < 3; i++) {
+    CHECK(&swapchain.back() != frame);
+    swapchain.publish();
+  }
+  CHECK(swapchain.acquire() != frame);
+
+  // Waking the consumer does not hand over a frame.
+  swapchain.wake();
+  CHECK(!swapchain.acquire());
+
+  // Closed swapchains do not block.
+  swapchain.close();
+  CHECK(swapchain.closed());
+  CHECK(!swapchain.acquire());
+  swapchain.open();
+  CHECK(!swapchain.closed());
+}
+
+TEST_CASE("swapchain threads")
+{
+  ice::ui::swapchain swapchain;
+  std::vector<int> frames;
+  auto thread = std::thread([&]() {
+    while (!swapchain.closed()) {
+      if (const auto frame = swapchain.acquire()) {
+        frames.push_back(frame->cx());
+      }
+    }
+    // Take the frame that was published before the swapchain was closed.
+    if (const auto frame = swapchain.acquire()) {
+      frames.push_back(frame->cx());
+    }
+  });
+  for (int i = 1; i <= 10000; i++) {
+    REQUIRE(!swapchain.back().assign(nullptr, i, i));
+    swapchain.publish();
+  }
+  swapchain.close();
+  thread.join();
+
+  // Frames arrive in order, the last frame is always rendered and every other frame is either rendered or dropped.
+  REQUIRE(!frames.empty());
+  for (std::size_t i = 1; i < frames.size(); i++) {
+    CHECK(frames[i - 1] < frames[i]);
+  }
+  CHECK(frames.back() == 10000);
+  CHECK(frames.size() + swapchain.dropped() == 10000);
+}
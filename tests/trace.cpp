@@ -0,0 +1,82 @@
+#include <ice/format.hpp>
+#include <doctest/doctest.h>
+#include <chrono>
+#include <string>
+#include <cstdio>
+
+namespace {
+
+ice::trace_category trace_test{ "test" };
+
+std::string trace_read(std::FILE* file)
+{
+  std::string text;
+  std::rewind(file);
+  char buffer[4096];
+  while (const auto size = std::fread(buffer, 1, sizeof(buffer), file)) {
+    text.append(buffer, size);
+  }
+  return text;
+}
+
+std::size_t trace_count(const std::string& text, std::string_view line)
+{
+  std::size_t count = 0;
+  for (auto position = text.find(line); position != std::string::npos; position = text.find(line, position + 1)) {
+    count++;
+  }
+  return count;
+}
+
+}  // namespace
+
+TEST_CASE("ice::trace_category evaluates arguments only for enabled levels")
+{
+  const auto file = std::tmpfile();
+  REQUIRE(file);
+  ice::logger::flush();
+  ice::logger::set(file);
+  int evaluated = 0;
+  const auto argument = [&]() {
+    return ++evaluated;
+  };
+  trace_test.set(ice::trace_level::warning);
+  ICE_TRACE_INFO(trace_test, "info {}", argument());
+  ICE_TRACE_WARNING(trace_test, "warning {}", argument());
+  ICE_TRACE_ERROR(trace_test, "error {}", argument());
+  trace_test.set(ice::trace_level::none);
+  ICE_TRACE_ERROR(trace_test, "disabled {}", argument());
+  trace_test.set(ice::trace_level::info);
+  ice::logger::flush();
+  ice::logger::set(stderr);
+  CHECK(evaluated == 2);
+
+  const auto text = trace_read(file);
+  std::fclose(file);
+  CHECK(text.find("info") == std::string::npos);
+  CHECK(text.find(": warning 1\n") != std::string::npos);
+  CHECK(text.find(": error 2\n") != std::string::npos);
+  CHECK(text.find("disabled") == std::string::npos);
+}
+
+TEST_CASE("ice::trace_category samples and limits trace sites")
+{
+  const auto file = std::tmpfile();
+  REQUIRE(file);
+  ice::logger::flush();
+  ice::logger::set(file);
+  for (int i = 0; i < 100; i++) {
+    ICE_TRACE_SAMPLE(trace_test, ice::trace_level::info, 10, "sample {}", i);
+    ICE_TRACE_LIMIT(trace_test, ice::trace_level::info, std::chrono::hours(1), "limit {}", i);
+  }
+  ice::logger::flush();
+  ice::logger::set(stderr);
+
+  const auto text = trace_read(file);
+  std::fclose(file);
+  CHECK(trace_count(text, ": sample ") == 10);
+  CHECK(text.find(": sample 0\n") != std::string::npos);
+  CHECK(text.find(": sample 90\n") != std::string::npos);
+  CHECK(trace_count(text, ": limit ") == 1);
+  CHECK(text.find(": limit 0\n") != std::string::npos);
+}